@@ -0,0 +1,906 @@
+#include "Benchmarks.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <random>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <openvic-dataloader/v2script/Parser.hpp>
+
+#include <openvic-simulation/dataloader/DefinitionCache.hpp>
+#include <openvic-simulation/GameManager.hpp>
+#include <openvic-simulation/map/MapDefinition.hpp>
+#include <openvic-simulation/map/MapInstance.hpp>
+#include <openvic-simulation/map/Mapmode.hpp>
+#include <openvic-simulation/misc/Event.hpp>
+#include <openvic-simulation/modifier/ModifierSum.hpp>
+#include <openvic-simulation/scripts/ConditionScript.hpp>
+#include <openvic-simulation/types/fixed_point/FixedPointSIMD.hpp>
+#include <openvic-simulation/types/IndexedMap.hpp>
+#include <openvic-simulation/utility/Logger.hpp>
+#include <openvic-simulation/utility/ThreadPool.hpp>
+#include <openvic-simulation/utility/Utility.hpp>
+
+using namespace OpenVic;
+
+/* Returns the average time in nanoseconds taken by a call to func. */
+template<typename Func>
+static double time_per_iteration_ns(size_t iterations, Func&& func) {
+	using clock_t = std::chrono::steady_clock;
+
+	/* Warm up caches and branch predictors before timing. */
+	for (size_t iteration = 0; iteration < iterations / 10 + 1; ++iteration) {
+		func();
+	}
+
+	const clock_t::time_point start = clock_t::now();
+	for (size_t iteration = 0; iteration < iterations; ++iteration) {
+		func();
+	}
+	const clock_t::time_point end = clock_t::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+static void log_comparison(std::string_view name, double reference_ns, double optimised_ns) {
+	Logger::info(
+		"    ", name, ": reference ", reference_ns, " ns, optimised ", optimised_ns, " ns, speedup x",
+		optimised_ns > 0.0 ? reference_ns / optimised_ns : 0.0
+	);
+}
+
+/* Plain loops matching what IndexedMap did before FixedPointSIMD, used as a baseline and to check results. */
+namespace reference {
+	static void add(std::vector<fixed_point_t>& dst, std::vector<fixed_point_t> const& src) {
+		for (size_t index = 0; index < dst.size(); ++index) {
+			dst[index] += src[index];
+		}
+	}
+
+	static void multiply(std::vector<fixed_point_t>& values, fixed_point_t factor) {
+		for (fixed_point_t& value : values) {
+			value *= factor;
+		}
+	}
+
+	static fixed_point_t sum(std::vector<fixed_point_t> const& values) {
+		fixed_point_t total = 0;
+		for (fixed_point_t const& value : values) {
+			total += value;
+		}
+		return total;
+	}
+}
+
+/* Sums ROW_COUNT rows into one accumulator, as a province does with its pops' ideology weights, then scales and totals
+ * the accumulator, as states and countries do with their distributions. */
+template<typename Key>
+static bool benchmark_indexed_map(std::string_view name, std::vector<Key> const& keys) {
+	static constexpr size_t ROW_COUNT = 1024;
+	static constexpr size_t ITERATIONS = 2000;
+
+	const size_t key_count = keys.size();
+	if (key_count == 0) {
+		Logger::warning("Skipping IndexedMap<", name, ", fixed_point_t> benchmark - no keys loaded!");
+		return true;
+	}
+
+	std::vector<IndexedMap<Key, fixed_point_t>> rows;
+	std::vector<std::vector<fixed_point_t>> reference_rows;
+	rows.reserve(ROW_COUNT);
+	reference_rows.reserve(ROW_COUNT);
+	for (size_t row = 0; row < ROW_COUNT; ++row) {
+		IndexedMap<Key, fixed_point_t>& map = rows.emplace_back(&keys);
+		std::vector<fixed_point_t>& reference_row = reference_rows.emplace_back(key_count);
+		for (size_t index = 0; index < key_count; ++index) {
+			map[index] = reference_row[index] = fixed_point_t::parse_raw(static_cast<int64_t>((row * 7919 + index * 104729) % 65536));
+		}
+	}
+
+	IndexedMap<Key, fixed_point_t> accumulator { &keys };
+	std::vector<fixed_point_t> reference_accumulator(key_count);
+	const fixed_point_t factor = fixed_point_t::_0_50();
+	fixed_point_t total = 0, reference_total = 0;
+
+	const double reference_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+		std::fill(reference_accumulator.begin(), reference_accumulator.end(), fixed_point_t::_0());
+		for (std::vector<fixed_point_t> const& row : reference_rows) {
+			reference::add(reference_accumulator, row);
+		}
+		reference::multiply(reference_accumulator, factor);
+		reference_total += reference::sum(reference_accumulator);
+	});
+
+	const double optimised_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+		accumulator.clear();
+		for (IndexedMap<Key, fixed_point_t> const& row : rows) {
+			accumulator += row;
+		}
+		accumulator *= factor;
+		total += accumulator.get_total();
+	});
+
+	log_comparison(
+		StringUtils::append_string_views(
+			"IndexedMap<", name, ", fixed_point_t> (", std::to_string(key_count), " keys, ", std::to_string(ROW_COUNT),
+			" rows summed, scaled and totalled)"
+		),
+		reference_ns, optimised_ns
+	);
+
+	if (total != reference_total) {
+		Logger::error(
+			"IndexedMap<", name, ", fixed_point_t> benchmark result ", total, " doesn't match reference result ",
+			reference_total, "!"
+		);
+		return false;
+	}
+	return true;
+}
+
+/* Finds land paths between random pairs of land provinces, first with the path cache disabled to time the A* search
+ * itself, then repeatedly over a smaller set of pairs to time cache hits. Every path must start and end at the requested
+ * provinces, only step between adjacent provinces, and match between the cached and uncached runs. */
+static bool benchmark_pathfinding(MapInstance& map_instance) {
+	static constexpr size_t QUERY_COUNT = 4096;
+	static constexpr size_t CACHED_PAIR_COUNT = 256;
+	static constexpr size_t CACHED_ITERATIONS = 64;
+
+	using index_t = ProvinceDefinition::index_t;
+	using clock_t = std::chrono::steady_clock;
+
+	MapDefinition const& map_definition = map_instance.get_map_definition();
+	ProvincePathfinder& pathfinder = map_instance.get_pathfinder();
+
+	std::vector<ProvinceDefinition const*> land_provinces;
+	for (ProvinceDefinition const& province : map_definition.get_province_definitions()) {
+		if (!province.is_water() && province.get_on_map()) {
+			land_provinces.push_back(&province);
+		}
+	}
+	if (land_provinces.size() < 2) {
+		Logger::warning("Skipping pathfinding benchmark - not enough land provinces loaded!");
+		return true;
+	}
+
+	/* Fixed seed so every run times the same queries. */
+	std::mt19937 generator { 12345 };
+	std::uniform_int_distribution<size_t> distribution { 0, land_provinces.size() - 1 };
+	std::vector<std::pair<ProvinceDefinition const*, ProvinceDefinition const*>> queries(QUERY_COUNT);
+	for (auto& [from, to] : queries) {
+		from = land_provinces[distribution(generator)];
+		to = land_provinces[distribution(generator)];
+	}
+
+	bool ret = true;
+
+	const auto check_path = [&map_definition, &ret](
+		ProvinceDefinition const& from, ProvinceDefinition const& to, std::span<const index_t> path
+	) -> void {
+		if (path.empty()) {
+			return;
+		}
+		bool valid = path.front() == from.get_index() && path.back() == to.get_index();
+		for (size_t index = 1; valid && index < path.size(); ++index) {
+			valid = map_definition.get_adjacency_graph().is_adjacent(
+				*map_definition.get_province_definition_by_index(path[index - 1]),
+				*map_definition.get_province_definition_by_index(path[index])
+			);
+		}
+		if (!valid) {
+			Logger::error("Pathfinding benchmark found an invalid path from ", from, " to ", to, "!");
+			ret = false;
+		}
+	};
+
+	const size_t original_cache_capacity = pathfinder.get_cache_capacity();
+	pathfinder.set_cache_capacity(0);
+
+	std::vector<std::vector<index_t>> uncached_paths;
+	uncached_paths.reserve(QUERY_COUNT);
+	size_t found_count = 0, total_path_length = 0;
+
+	const clock_t::time_point uncached_start = clock_t::now();
+	for (auto const& [from, to] : queries) {
+		const std::span<const index_t> path = pathfinder.find_path(*from, *to, UnitType::branch_t::LAND);
+		uncached_paths.emplace_back(path.begin(), path.end());
+	}
+	const double uncached_seconds = std::chrono::duration<double>(clock_t::now() - uncached_start).count();
+
+	for (size_t query = 0; query < QUERY_COUNT; ++query) {
+		check_path(*queries[query].first, *queries[query].second, uncached_paths[query]);
+		if (!uncached_paths[query].empty()) {
+			found_count++;
+			total_path_length += uncached_paths[query].size();
+		}
+	}
+
+	pathfinder.set_cache_capacity(CACHED_PAIR_COUNT);
+	pathfinder.clear_cache();
+
+	const double cached_ns = time_per_iteration_ns(CACHED_ITERATIONS, [&]() -> void {
+		for (size_t query = 0; query < CACHED_PAIR_COUNT; ++query) {
+			const std::span<const index_t> path =
+				pathfinder.find_path(*queries[query].first, *queries[query].second, UnitType::branch_t::LAND);
+			if (!std::equal(path.begin(), path.end(), uncached_paths[query].begin(), uncached_paths[query].end())) {
+				Logger::error(
+					"Cached path from ", *queries[query].first, " to ", *queries[query].second, " doesn't match uncached path!"
+				);
+				ret = false;
+			}
+		}
+	}) / CACHED_PAIR_COUNT;
+
+	pathfinder.set_cache_capacity(original_cache_capacity);
+	pathfinder.clear_cache();
+
+	const double uncached_ns = uncached_seconds * 1e9 / QUERY_COUNT;
+	Logger::info(
+		"    A* land pathfinding (", land_provinces.size(), " land provinces, ", QUERY_COUNT, " random queries, ",
+		found_count, " paths found with average length ", found_count > 0 ? total_path_length / double(found_count) : 0.0,
+		"): ", uncached_seconds > 0.0 ? QUERY_COUNT / uncached_seconds : 0.0, " queries per second"
+	);
+	log_comparison("Path cache hits vs uncached searches", uncached_ns, cached_ns);
+
+	return ret;
+}
+
+/* Generates every mapmode's colours for the whole map, comparing a loop calling the per-province colour function (as
+ * mapmode generation worked before batching) against batched generation on one thread, batched generation across the
+ * thread pool, and an incremental update after nothing has changed. Every method must produce identical colours. */
+static bool benchmark_mapmodes(
+	MapmodeManager const& mapmode_manager, MapInstance const& map_instance, ThreadPool& thread_pool
+) {
+	static constexpr size_t ITERATIONS = 50;
+
+	if (!map_instance.province_instances_are_locked()) {
+		Logger::warning("Skipping mapmode benchmark - province instances not locked!");
+		return true;
+	}
+
+	bool ret = true;
+
+	const size_t stripe_count = map_instance.get_map_definition().get_province_definition_count() + 1;
+	std::vector<Mapmode::base_stripe_t> reference_stripes(stripe_count, colour_argb_t::null());
+	std::vector<Mapmode::base_stripe_t> batch_stripes = reference_stripes, parallel_stripes = reference_stripes,
+		update_stripes = reference_stripes;
+
+	const auto as_target = [](std::vector<Mapmode::base_stripe_t>& stripes) -> uint8_t* {
+		return reinterpret_cast<uint8_t*>(stripes.data());
+	};
+
+	for (Mapmode const& mapmode : mapmode_manager.get_mapmodes()) {
+		const double reference_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+			reference_stripes[ProvinceDefinition::NULL_INDEX] = colour_argb_t::null();
+			for (ProvinceInstance const& province : map_instance.get_province_instances()) {
+				reference_stripes[province.get_province_definition().get_index()] =
+					mapmode.get_base_stripe_colours(map_instance, province);
+			}
+		});
+
+		const double batch_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+			ret &= mapmode_manager.generate_mapmode_colours(map_instance, mapmode.get_index(), as_target(batch_stripes));
+		});
+
+		const double parallel_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+			ret &= mapmode_manager.generate_mapmode_colours(
+				map_instance, mapmode.get_index(), as_target(parallel_stripes), &thread_pool
+			);
+		});
+
+		/* The first update generates every province's colours, so nothing is left to regenerate while timing. */
+		MapmodeManager::target_state_t target_state;
+		const double update_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+			ret &= mapmode_manager.update_mapmode_colours(
+				map_instance, mapmode.get_index(), as_target(update_stripes), target_state, &thread_pool
+			);
+		});
+
+		Logger::info("  ", mapmode.get_identifier(), mapmode.is_province_local() ? "" : " (not province local)", ":");
+		log_comparison("Batched", reference_ns, batch_ns);
+		log_comparison(
+			StringUtils::append_string_views("Batched on ", std::to_string(thread_pool.get_thread_count()), " threads"),
+			reference_ns, parallel_ns
+		);
+		log_comparison("Unchanged update", reference_ns, update_ns);
+
+		if (
+			batch_stripes != reference_stripes || parallel_stripes != reference_stripes || update_stripes != reference_stripes
+		) {
+			Logger::error("Mapmode ", mapmode.get_identifier(), " benchmark colours don't match reference colours!");
+			ret = false;
+		}
+	}
+
+	return ret;
+}
+
+/* Advances the game by a day through the instance manager, ticking and updating the gamestate as normal play does, and
+ * checks that only provinces with a building preparing or expanding, the only thing a tick changes, had their revision
+ * changed. An incremental update of each province local mapmode must then only rewrite the colours of provinces whose
+ * revision changed. The target is filled with a marker colour no mapmode produces, so any rewrite is visible. */
+static bool check_mapmode_updates_after_tick(
+	MapmodeManager const& mapmode_manager, InstanceManager& instance_manager
+) {
+	MapInstance& map_instance = instance_manager.get_map_instance();
+	ThreadPool& thread_pool = instance_manager.get_thread_pool();
+
+	if (!map_instance.province_instances_are_locked()) {
+		Logger::warning("Skipping mapmode update check - province instances not locked!");
+		return true;
+	}
+
+	static const Mapmode::base_stripe_t MARKER { colour_argb_t::from_integer(0x01FE02FD) };
+
+	std::span<const ProvinceInstance> provinces = map_instance.get_province_instances();
+	std::vector<Mapmode::base_stripe_t> stripes(
+		map_instance.get_map_definition().get_province_definition_count() + 1, colour_argb_t::null()
+	);
+	uint8_t* target = reinterpret_cast<uint8_t*>(stripes.data());
+
+	std::vector<MapmodeManager::target_state_t> target_states(mapmode_manager.get_mapmode_count());
+	bool ret = true;
+	for (Mapmode const& mapmode : mapmode_manager.get_mapmodes()) {
+		if (mapmode.is_province_local()) {
+			ret &= mapmode_manager.update_mapmode_colours(
+				map_instance, mapmode.get_index(), target, target_states[mapmode.get_index()], &thread_pool
+			);
+		}
+	}
+
+	std::vector<uint32_t> revisions(provinces.size());
+	std::vector<uint8_t> expanding(provinces.size());
+	for (size_t province_index = 0; province_index < provinces.size(); ++province_index) {
+		ProvinceInstance const& province = provinces[province_index];
+		revisions[province_index] = province.get_revision();
+		expanding[province_index] = std::any_of(
+			province.get_buildings().begin(), province.get_buildings().end(),
+			[](BuildingInstance const& building) -> bool {
+				return building.get_expansion_state() == BuildingInstance::ExpansionState::Preparing ||
+					building.get_expansion_state() == BuildingInstance::ExpansionState::Expanding;
+			}
+		);
+	}
+
+	ret &= instance_manager.advance_days(1);
+
+	size_t changed_count = 0, untouched_changed_count = 0;
+	for (size_t province_index = 0; province_index < provinces.size(); ++province_index) {
+		if (revisions[province_index] != provinces[province_index].get_revision()) {
+			changed_count++;
+			if (!expanding[province_index]) {
+				untouched_changed_count++;
+			}
+		}
+	}
+	Logger::info("  A day changed the revision of ", changed_count, " of ", provinces.size(), " provinces");
+
+	if (untouched_changed_count > 0) {
+		Logger::error(
+			"A day changed the revision of ", untouched_changed_count, " provinces whose displayed state didn't change!"
+		);
+		ret = false;
+	}
+
+	for (Mapmode const& mapmode : mapmode_manager.get_mapmodes()) {
+		if (!mapmode.is_province_local()) {
+			continue;
+		}
+
+		std::fill(stripes.begin(), stripes.end(), MARKER);
+		ret &= mapmode_manager.update_mapmode_colours(
+			map_instance, mapmode.get_index(), target, target_states[mapmode.get_index()], &thread_pool
+		);
+
+		size_t rewritten_count = 0;
+		for (size_t province_index = 0; province_index < provinces.size(); ++province_index) {
+			if (
+				stripes[ProvinceDefinition::NULL_INDEX + 1 + province_index] != MARKER &&
+				revisions[province_index] == provinces[province_index].get_revision()
+			) {
+				rewritten_count++;
+			}
+		}
+
+		if (rewritten_count > 0) {
+			Logger::error(
+				"Mapmode ", mapmode.get_identifier(), " rewrote ", rewritten_count, " unchanged provinces after a day!"
+			);
+			ret = false;
+		}
+	}
+
+	return ret;
+}
+
+/* Sums modifiers as a country does with its own modifiers and its provinces' modifier sums, comparing a copy of the
+ * original hashed ModifierSum against ModifierSum's dense effect-indexed value sum. Modifiers are picked at random from
+ * the loaded event, static and triggered modifiers, and every effect's total must match. */
+static bool benchmark_modifier_sums(ModifierManager const& modifier_manager) {
+	static constexpr size_t PROVINCE_COUNT = 32;
+	static constexpr size_t MODIFIERS_PER_PROVINCE = 8;
+	static constexpr size_t COUNTRY_MODIFIER_COUNT = 64;
+	static constexpr size_t ITERATIONS = 2000;
+
+	/* ModifierSum as it was before DenseModifierValue, hashing every modifier and every effect as it is added. */
+	struct hashed_modifier_sum_t {
+		fixed_point_map_t<Modifier const*> modifiers;
+		ModifierValue value_sum;
+
+		void clear() {
+			modifiers.clear();
+			value_sum.clear();
+		}
+
+		void add_modifier(Modifier const& modifier) {
+			modifiers[&modifier] += fixed_point_t::_1();
+			value_sum.multiply_add(modifier, fixed_point_t::_1());
+		}
+
+		void add_modifier_sum(hashed_modifier_sum_t const& modifier_sum) {
+			modifiers += modifier_sum.modifiers;
+			value_sum += modifier_sum.value_sum;
+		}
+	};
+
+	std::vector<Modifier const*> all_modifiers;
+	for (Modifier const& modifier : modifier_manager.get_event_modifiers()) {
+		all_modifiers.push_back(&modifier);
+	}
+	for (Modifier const& modifier : modifier_manager.get_static_modifiers()) {
+		all_modifiers.push_back(&modifier);
+	}
+	for (Modifier const& modifier : modifier_manager.get_triggered_modifiers()) {
+		all_modifiers.push_back(&modifier);
+	}
+	if (all_modifiers.empty()) {
+		Logger::warning("Skipping modifier sum benchmark - no modifiers loaded!");
+		return true;
+	}
+
+	/* Fixed seed so every run sums the same modifiers. */
+	std::mt19937 generator { 12345 };
+	std::uniform_int_distribution<size_t> distribution { 0, all_modifiers.size() - 1 };
+	const auto pick_modifiers = [&all_modifiers, &generator, &distribution](size_t count) -> std::vector<Modifier const*> {
+		std::vector<Modifier const*> modifiers(count);
+		for (Modifier const*& modifier : modifiers) {
+			modifier = all_modifiers[distribution(generator)];
+		}
+		return modifiers;
+	};
+
+	std::vector<std::vector<Modifier const*>> province_modifiers(PROVINCE_COUNT);
+	for (std::vector<Modifier const*>& modifiers : province_modifiers) {
+		modifiers = pick_modifiers(MODIFIERS_PER_PROVINCE);
+	}
+	const std::vector<Modifier const*> country_modifiers = pick_modifiers(COUNTRY_MODIFIER_COUNT);
+
+	std::vector<hashed_modifier_sum_t> hashed_province_sums(PROVINCE_COUNT);
+	hashed_modifier_sum_t hashed_country_sum;
+	std::vector<ModifierSum> province_sums(PROVINCE_COUNT);
+	ModifierSum country_sum;
+
+	const double reference_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+		hashed_country_sum.clear();
+		for (Modifier const* modifier : country_modifiers) {
+			hashed_country_sum.add_modifier(*modifier);
+		}
+		for (size_t province = 0; province < PROVINCE_COUNT; ++province) {
+			hashed_modifier_sum_t& province_sum = hashed_province_sums[province];
+			province_sum.clear();
+			for (Modifier const* modifier : province_modifiers[province]) {
+				province_sum.add_modifier(*modifier);
+			}
+			hashed_country_sum.add_modifier_sum(province_sum);
+		}
+	});
+
+	const double optimised_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+		country_sum.clear();
+		for (Modifier const* modifier : country_modifiers) {
+			country_sum.add_modifier(*modifier);
+		}
+		for (size_t province = 0; province < PROVINCE_COUNT; ++province) {
+			ModifierSum& province_sum = province_sums[province];
+			province_sum.clear();
+			for (Modifier const* modifier : province_modifiers[province]) {
+				province_sum.add_modifier(*modifier);
+			}
+			country_sum.add_modifier_sum(province_sum);
+		}
+	});
+
+	log_comparison(
+		StringUtils::append_string_views(
+			"ModifierSum (", std::to_string(COUNTRY_MODIFIER_COUNT), " country modifiers, ", std::to_string(PROVINCE_COUNT),
+			" provinces with ", std::to_string(MODIFIERS_PER_PROVINCE), " modifiers each)"
+		),
+		reference_ns, optimised_ns
+	);
+
+	bool ret = true;
+	for (ModifierEffect const& effect : modifier_manager.get_modifier_effects()) {
+		bool reference_found = false, found = false;
+		const fixed_point_t reference_value = hashed_country_sum.value_sum.get_effect(effect, &reference_found);
+		const fixed_point_t value = country_sum.get_effect(effect, &found);
+		if (value != reference_value || found != reference_found) {
+			Logger::error(
+				"ModifierSum benchmark effect ", effect.get_identifier(), " = ", value, " (found: ", found,
+				") doesn't match reference ", reference_value, " (found: ", reference_found, ")!"
+			);
+			ret = false;
+		}
+	}
+	return ret;
+}
+
+/* Re-ranks synthetic countries by total score (civilised countries first, ties broken by index) over a run of days in
+ * which every score changes slightly and countries occasionally become civilised or uncivilised, comparing rebuilding
+ * and fully sorting the ranking every day (as CountryInstanceManager::update_rankings did originally) against repairing
+ * the previous day's ranking with utility::repair_sort. Both must produce the same ranking every day. */
+static bool benchmark_rankings() {
+	static constexpr size_t COUNTRY_COUNTS[] { 256, 1024, 4096, 16384 };
+	static constexpr size_t DAYS = 365;
+	static constexpr size_t DAYS_BETWEEN_STATUS_CHANGES = 30;
+
+	using clock_t = std::chrono::steady_clock;
+
+	struct ranked_country_t {
+		bool civilised;
+		fixed_point_t total_score;
+	};
+
+	const auto compare = [](ranked_country_t const* a, ranked_country_t const* b) -> bool {
+		if (a->civilised != b->civilised) {
+			return a->civilised;
+		}
+		return a->total_score != b->total_score ? a->total_score > b->total_score : a < b;
+	};
+
+	bool ret = true;
+
+	for (const size_t country_count : COUNTRY_COUNTS) {
+		/* Fixed seed so every run ranks the same scores. */
+		std::mt19937 generator { 12345 };
+		std::uniform_int_distribution<int64_t> score_distribution { 0, 1000 };
+		std::uniform_int_distribution<int64_t> change_distribution { -fixed_point_t::ONE, fixed_point_t::ONE };
+		std::uniform_int_distribution<size_t> country_distribution { 0, country_count - 1 };
+
+		std::vector<ranked_country_t> countries(country_count);
+		for (ranked_country_t& country : countries) {
+			country.civilised = country_distribution(generator) % 4 != 0;
+			country.total_score = fixed_point_t::parse(score_distribution(generator));
+		}
+
+		std::vector<ranked_country_t const*> reference_ranking, repaired_ranking;
+		for (ranked_country_t const& country : countries) {
+			repaired_ranking.push_back(&country);
+		}
+		std::sort(repaired_ranking.begin(), repaired_ranking.end(), compare);
+
+		clock_t::duration reference_time {}, repaired_time {};
+		bool matches = true;
+
+		for (size_t day = 0; day < DAYS; ++day) {
+			for (ranked_country_t& country : countries) {
+				country.total_score += fixed_point_t::parse_raw(change_distribution(generator));
+			}
+			if (day % DAYS_BETWEEN_STATUS_CHANGES == 0) {
+				ranked_country_t& country = countries[country_distribution(generator)];
+				country.civilised = !country.civilised;
+			}
+
+			const clock_t::time_point reference_start = clock_t::now();
+			reference_ranking.clear();
+			for (ranked_country_t const& country : countries) {
+				reference_ranking.push_back(&country);
+			}
+			std::sort(reference_ranking.begin(), reference_ranking.end(), compare);
+			const clock_t::time_point repaired_start = clock_t::now();
+			utility::repair_sort(repaired_ranking.begin(), repaired_ranking.end(), compare);
+			const clock_t::time_point repaired_end = clock_t::now();
+
+			reference_time += repaired_start - reference_start;
+			repaired_time += repaired_end - repaired_start;
+			matches &= reference_ranking == repaired_ranking;
+		}
+
+		log_comparison(
+			StringUtils::append_string_views("Daily re-ranking of ", std::to_string(country_count), " countries"),
+			std::chrono::duration<double, std::nano>(reference_time).count() / DAYS,
+			std::chrono::duration<double, std::nano>(repaired_time).count() / DAYS
+		);
+
+		if (!matches) {
+			Logger::error("Repaired ranking of ", country_count, " countries doesn't match fully sorted ranking!");
+			ret = false;
+		}
+	}
+
+	return ret;
+}
+
+/* Evaluates every country event's trigger against every country, once on one thread and once with the countries split
+ * across the thread pool, which must give identical results. Triggers are evaluated with the country as both the scope
+ * and THIS, as when polling for events. */
+static bool benchmark_event_triggers(
+	EventManager const& event_manager, InstanceManager const& instance_manager, ThreadPool& thread_pool
+) {
+	static constexpr size_t ITERATIONS = 10;
+
+	std::vector<ConditionScript const*> triggers;
+	size_t instruction_count = 0, unsupported_count = 0;
+	for (Event const& event : event_manager.get_events()) {
+		if (event.get_type() == Event::event_type_t::COUNTRY) {
+			ConditionScript const& trigger = event.get_trigger();
+			triggers.push_back(&trigger);
+			instruction_count += trigger.get_bytecode().get_instructions().size();
+			unsupported_count += trigger.get_bytecode().get_unsupported_count();
+		}
+	}
+
+	std::vector<CountryInstance> const& countries =
+		instance_manager.get_country_instance_manager().get_country_instances();
+	const size_t trigger_count = triggers.size();
+
+	if (trigger_count == 0 || countries.empty()) {
+		Logger::warning("Skipping event trigger benchmark - no country events or countries!");
+		return true;
+	}
+
+	/* Indexed by country index * trigger count + trigger index. */
+	std::vector<uint8_t> serial_results(countries.size() * trigger_count), parallel_results(serial_results.size());
+
+	const auto evaluate_countries = [&](std::vector<uint8_t>& results, size_t begin, size_t end) -> void {
+		for (size_t country_index = begin; country_index < end; ++country_index) {
+			CountryInstance const* country = &countries[country_index];
+			for (size_t trigger_index = 0; trigger_index < trigger_count; ++trigger_index) {
+				results[country_index * trigger_count + trigger_index] = static_cast<uint8_t>(
+					triggers[trigger_index]->get_bytecode().evaluate(country, country, {}, instance_manager)
+				);
+			}
+		}
+	};
+
+	const double serial_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+		evaluate_countries(serial_results, 0, countries.size());
+	});
+
+	const double parallel_ns = time_per_iteration_ns(ITERATIONS, [&]() -> void {
+		thread_pool.parallel_for(countries.size(), [&](size_t begin, size_t end) -> void {
+			evaluate_countries(parallel_results, begin, end);
+		});
+	});
+
+	const size_t evaluation_count = serial_results.size();
+	Logger::info(
+		"    ", trigger_count, " triggers (", instruction_count, " instructions, ", unsupported_count,
+		" unsupported) x ", countries.size(), " countries: ", serial_ns / evaluation_count, " ns per evaluation, ",
+		std::count(serial_results.begin(), serial_results.end(), static_cast<uint8_t>(ConditionBytecode::result_t::YES)),
+		" true, ", std::count(
+			serial_results.begin(), serial_results.end(), static_cast<uint8_t>(ConditionBytecode::result_t::INDETERMINATE)
+		), " indeterminate"
+	);
+	log_comparison(
+		StringUtils::append_string_views("Across ", std::to_string(thread_pool.get_thread_count()), " threads"),
+		serial_ns, parallel_ns
+	);
+
+	if (parallel_results != serial_results) {
+		Logger::error("Event trigger results evaluated across threads don't match results evaluated on one thread!");
+		return false;
+	}
+
+	return true;
+}
+
+/* Checks that groups of conditions combine unsupported conditions' indeterminate results with three-valued logic, so that
+ * e.g. NOT of an unsupported condition isn't true, while groups whose result it can't change are still decided. */
+static bool check_unsupported_condition_logic(
+	DefinitionManager const& definition_manager, InstanceManager const& instance_manager
+) {
+	using result_t = ConditionBytecode::result_t;
+
+	struct condition_case_t {
+		std::string_view script;
+		result_t expected;
+	};
+
+	/* "war" is a country condition which isn't simulated yet, so compiles to an unsupported instruction. */
+	static constexpr std::array<condition_case_t, 7> CASES {{
+		{ "war = yes", result_t::INDETERMINATE },
+		{ "NOT = { war = yes }", result_t::INDETERMINATE },
+		{ "NOT = { NOT = { war = yes } }", result_t::INDETERMINATE },
+		{ "OR = { always = yes war = yes }", result_t::YES },
+		{ "OR = { always = no war = yes }", result_t::INDETERMINATE },
+		{ "AND = { always = no war = yes }", result_t::NO },
+		{ "NOT = { always = no war = yes }", result_t::YES }
+	}};
+
+	std::vector<CountryInstance> const& countries =
+		instance_manager.get_country_instance_manager().get_country_instances();
+
+	if (countries.empty()) {
+		Logger::warning("Skipping unsupported condition check - no countries!");
+		return true;
+	}
+
+	CountryInstance const* country = &countries.front();
+
+	bool ret = true;
+
+	for (condition_case_t const& condition_case : CASES) {
+		ovdl::v2script::Parser parser;
+		parser.load_from_string(condition_case.script);
+		if (!parser.simple_parse() || parser.has_fatal_error() || parser.has_error()) {
+			Logger::error("Failed to parse condition check script \"", condition_case.script, "\"");
+			ret = false;
+			continue;
+		}
+
+		ConditionScript script { scope_t::COUNTRY, scope_t::COUNTRY, scope_t::NO_SCOPE };
+		if (!script.expect_script()(parser.get_file_node()) || !script.parse_script(false, definition_manager)) {
+			Logger::error("Failed to load condition check script \"", condition_case.script, "\"");
+			ret = false;
+			continue;
+		}
+
+		const result_t result = script.get_bytecode().evaluate(country, country, {}, instance_manager);
+		if (result != condition_case.expected) {
+			Logger::error(
+				"Condition \"", condition_case.script, "\" evaluated to ", static_cast<uint32_t>(result), ", expected ",
+				static_cast<uint32_t>(condition_case.expected)
+			);
+			ret = false;
+		}
+	}
+
+	if (ret) {
+		Logger::info("    ", CASES.size(), " conditions over unsupported conditions evaluated as expected");
+	}
+
+	return ret;
+}
+
+/* Times loading definitions into a fresh game manager with an empty definition cache directory, which generates and writes
+ * the cache, then again into another one with the now warm cache, which restores from it. The data restored from the warm
+ * cache must match the data generated with the cold cache. Uses the same roots and thread count as the game manager. */
+static bool benchmark_definition_cache(GameManager const& game_manager) {
+	using clock_t = std::chrono::steady_clock;
+
+	std::error_code ec;
+	const fs::path cache_directory = fs::temp_directory_path(ec) / StringUtils::append_string_views(
+		"openvic-benchmark-cache-", std::to_string(std::random_device {}())
+	);
+	if (ec) {
+		Logger::error("Failed to find a temporary directory for the definition cache benchmark: ", ec.message());
+		return false;
+	}
+
+	const auto load_definitions = [&game_manager, &cache_directory](
+		int64_t& elapsed_ms, DefinitionCache::Writer& map_images
+	) -> bool {
+		GameManager cache_game_manager { []() {}, nullptr };
+		cache_game_manager.set_thread_count(game_manager.get_thread_count());
+		cache_game_manager.set_definition_cache_directory(cache_directory);
+
+		const clock_t::time_point start = clock_t::now();
+		bool ret = cache_game_manager.set_roots(game_manager.get_dataloader().get_roots());
+		ret &= cache_game_manager.load_definitions(
+			[](std::string_view key, Dataloader::locale_t locale, std::string_view localisation) -> bool {
+				return true;
+			}
+		);
+		elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(clock_t::now() - start).count();
+
+		cache_game_manager.get_definition_manager().get_map_definition().write_map_images_cache(map_images);
+		return ret;
+	};
+
+	int64_t cold_ms = 0, warm_ms = 0;
+	DefinitionCache::Writer cold_map_images, warm_map_images;
+
+	bool ret = load_definitions(cold_ms, cold_map_images);
+	ret &= load_definitions(warm_ms, warm_map_images);
+
+	fs::remove_all(cache_directory, ec);
+
+	Logger::info(
+		"    Definition load with cold cache ", cold_ms, " ms, with warm cache ", warm_ms, " ms, speedup x",
+		warm_ms > 0 ? static_cast<double>(cold_ms) / warm_ms : 0.0
+	);
+
+	if (!ret) {
+		Logger::error("Failed to load definitions for the definition cache benchmark!");
+		return false;
+	}
+
+	if (cold_map_images.get_data() != warm_map_images.get_data()) {
+		Logger::error("Map images restored from the warm definition cache don't match those generated with a cold cache!");
+		return false;
+	}
+
+	return true;
+}
+
+/* Times setting up a fresh game instance for each bookmark and running its first gamestate update. This replaces the game
+ * manager's existing instance, so is run after every other benchmark, leaving the last bookmark's instance behind. */
+static bool benchmark_bookmark_setup(GameManager& game_manager) {
+	using clock_t = std::chrono::steady_clock;
+
+	BookmarkManager const& bookmark_manager =
+		game_manager.get_definition_manager().get_history_manager().get_bookmark_manager();
+
+	bool ret = true;
+
+	for (Bookmark const& bookmark : bookmark_manager.get_bookmarks()) {
+		const clock_t::time_point start = clock_t::now();
+		ret &= game_manager.setup_instance(&bookmark);
+		const clock_t::time_point setup_end = clock_t::now();
+		ret &= game_manager.start_game_session();
+		ret &= game_manager.update_clock();
+		const clock_t::time_point first_tick_end = clock_t::now();
+
+		Logger::info(
+			"    ", bookmark.get_name(), " (", bookmark.get_date(), "): instance set up in ",
+			std::chrono::duration<double, std::milli>(setup_end - start).count(), " ms, first tick after ",
+			std::chrono::duration<double, std::milli>(first_tick_end - start).count(), " ms"
+		);
+	}
+
+	return ret;
+}
+
+bool OpenVic::run_benchmarks(GameManager& game_manager) {
+	bool ret = true;
+
+	DefinitionManager const& definition_manager = game_manager.get_definition_manager();
+
+	Logger::info("Fixed point map arithmetic (", FixedPointSIMD::get_instruction_set_name(), "):");
+	ret &= benchmark_indexed_map(
+		"Ideology", definition_manager.get_politics_manager().get_ideology_manager().get_ideologies()
+	);
+	ret &= benchmark_indexed_map("PopType", definition_manager.get_pop_manager().get_pop_types());
+
+	Logger::info("Modifier sums:");
+	ret &= benchmark_modifier_sums(definition_manager.get_modifier_manager());
+
+	Logger::info("Country rankings:");
+	ret &= benchmark_rankings();
+
+	InstanceManager* instance_manager = game_manager.get_instance_manager();
+	if (instance_manager != nullptr) {
+		Logger::info("Pathfinding:");
+		ret &= benchmark_pathfinding(instance_manager->get_map_instance());
+
+		Logger::info("Mapmode colour generation:");
+		ret &= benchmark_mapmodes(
+			definition_manager.get_mapmode_manager(), instance_manager->get_map_instance(), instance_manager->get_thread_pool()
+		);
+
+		Logger::info("Mapmode updates after a day:");
+		ret &= check_mapmode_updates_after_tick(definition_manager.get_mapmode_manager(), *instance_manager);
+
+		Logger::info("Event trigger evaluation:");
+		ret &= benchmark_event_triggers(
+			definition_manager.get_event_manager(), *instance_manager, instance_manager->get_thread_pool()
+		);
+
+		Logger::info("Unsupported condition logic:");
+		ret &= check_unsupported_condition_logic(definition_manager, *instance_manager);
+	} else {
+		Logger::warning("Skipping pathfinding, mapmode and event trigger benchmarks - instance manager not available!");
+	}
+
+	Logger::info("Definition cache:");
+	ret &= benchmark_definition_cache(game_manager);
+
+	Logger::info("Time to first tick for each bookmark:");
+	ret &= benchmark_bookmark_setup(game_manager);
+
+	return ret;
+}
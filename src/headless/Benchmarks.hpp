@@ -0,0 +1,10 @@
+#pragma once
+
+namespace OpenVic {
+	struct GameManager;
+
+	/* Microbenchmarks for hot simulation kernels, run by the headless executable's -B flag once the game instance has been
+	 * set up so they can use the real definitions (e.g. the loaded ideologies and pop types as map keys). Results are
+	 * printed via Logger::info, and false is returned if a kernel's output didn't match its reference implementation. */
+	bool run_benchmarks(GameManager& game_manager);
+}
@@ -1,37 +1,124 @@
+#include <chrono>
 #include <cstring>
+#include <fstream>
+#include <optional>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
 
 #include <openvic-simulation/dataloader/Dataloader.hpp>
 #include <openvic-simulation/GameManager.hpp>
 #include <openvic-simulation/testing/Testing.hpp>
 #include <openvic-simulation/utility/Logger.hpp>
 
+#include "Benchmarks.hpp"
+
 using namespace OpenVic;
 
 static void print_help(std::ostream& stream, char const* program_name) {
 	stream
-		<< "Usage: " << program_name << " [-h] [-t] [-b <path>] [path]+\n"
+		<< "Usage: " << program_name << " [-h] [-t] [-B] [-a] [-v] [-j <threads>] [-d <days>] [-r <seed>] [-p <path>]"
+		<< " [-c <path>] [-b <path>] [path]+\n"
 		<< "    -h : Print this help message and exit the program.\n"
 		<< "    -t : Run tests after loading defines.\n"
+		<< "    -B : Run benchmarks after starting the game session.\n"
+		<< "    -a : Print log messages on a background thread, so logging doesn't wait for console output.\n"
+		<< "    -v : Check every incremental gamestate update against a full update, logging any differences (slow).\n"
+		<< "    -j : Use the following number of threads for gamestate updates (0 for all hardware threads, default 1).\n"
+		<< "    -d : Advance the game by the following number of days as fast as possible, then report the speed.\n"
+		<< "    -r : Use the following random seed, so the game can be reproduced (default is a new seed each run).\n"
+		<< "    -p : Profile ticks and gamestate updates, writing the per-phase timings as JSON to the following path.\n"
+		<< "    -c : Cache slow to generate definitions in the following directory, reused until the game files change.\n"
 		<< "    -b : Use the following path as the base directory (instead of searching for one).\n"
 		<< "    -s : Use the following path as a hint to search for a base directory.\n"
 		<< "Any following paths are read as mod directories, with priority starting at one above the base directory.\n"
 		<< "(Paths with spaces need to be enclosed in \"quotes\").\n";
 }
 
-static bool run_headless(Dataloader::path_vector_t const& roots, bool run_tests) {
+/* Returns 0 if unavailable. */
+static uint64_t get_peak_rss_bytes() {
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+	#if defined(__APPLE__)
+		return usage.ru_maxrss;
+	#else
+		return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+	#endif
+	}
+	return 0;
+#endif
+}
+
+static bool advance_days(InstanceManager& instance_manager, size_t days) {
+	using clock_t = std::chrono::steady_clock;
+
+	Logger::info("===== Advancing ", days, " days... =====");
+
+	const clock_t::time_point start = clock_t::now();
+	const bool ret = instance_manager.advance_days(days);
+	const double seconds = std::chrono::duration<double>(clock_t::now() - start).count();
+
+	Logger::info(
+		"Advanced ", days, " days to ", instance_manager.get_today(), " in ", seconds, " seconds (",
+		seconds > 0.0 ? days / seconds : 0.0, " days per second), peak RSS ",
+		get_peak_rss_bytes() / (1024.0 * 1024.0), " MiB"
+	);
+
+	return ret;
+}
+
+static bool write_profile(InstanceManager const& instance_manager, fs::path const& profile_path) {
+	std::ofstream file { profile_path };
+	if (!file) {
+		Logger::error("Failed to open profile output file ", profile_path);
+		return false;
+	}
+	file << instance_manager.get_profiler().to_json();
+	Logger::info("Wrote profile to ", profile_path);
+	return true;
+}
+
+static bool run_headless(
+	Dataloader::path_vector_t const& roots, bool run_tests, bool run_benchmarks, bool verify_updates, size_t thread_count,
+	size_t days, std::optional<uint64_t> random_seed, fs::path const& profile_path, fs::path const& cache_directory
+) {
 	bool ret = true;
 
 	GameManager game_manager { []() {
 		Logger::info("State updated");
 	}, nullptr };
 
+	game_manager.set_thread_count(thread_count);
+	game_manager.set_random_seed(random_seed);
+	game_manager.set_definition_cache_directory(cache_directory);
+
 	Logger::info("===== Loading definitions... =====");
+	const std::chrono::steady_clock::time_point load_start = std::chrono::steady_clock::now();
 	ret &= game_manager.set_roots(roots);
 	ret &= game_manager.load_definitions(
 		[](std::string_view key, Dataloader::locale_t locale, std::string_view localisation) -> bool {
 			return true;
 		}
 	);
+	Logger::info(
+		"Loaded definitions in ", std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - load_start
+		).count(), "ms", cache_directory.empty() ? "" : " (with definition cache)", ", peak memory usage ",
+		get_peak_rss_bytes() / (1024.0 * 1024.0), " MiB"
+	);
 
 	if (run_tests) {
 		Testing testing { game_manager.get_definition_manager() };
@@ -46,12 +133,29 @@ static bool run_headless(Dataloader::path_vector_t const& roots, bool run_tests)
 		game_manager.get_definition_manager().get_history_manager().get_bookmark_manager().get_bookmark_by_index(0)
 	);
 
+	if (!profile_path.empty() && game_manager.get_instance_manager()) {
+		game_manager.get_instance_manager()->get_profiler().set_enabled(true);
+	}
+
+	if (verify_updates && game_manager.get_instance_manager()) {
+		game_manager.get_instance_manager()->set_verify_incremental_updates(true);
+	}
+
 	Logger::info("===== Starting game session... =====");
 	ret &= game_manager.start_game_session();
 
 	// This triggers a gamestate update
 	ret &= game_manager.update_clock();
 
+	if (days > 0) {
+		if (game_manager.get_instance_manager()) {
+			ret &= advance_days(*game_manager.get_instance_manager(), days);
+		} else {
+			Logger::error("Cannot advance ", days, " days - instance manager not available!");
+			ret = false;
+		}
+	}
+
 	// TODO - REMOVE TEST CODE
 	Logger::info("===== Ranking system test... =====");
 	if (game_manager.get_instance_manager()) {
@@ -80,11 +184,20 @@ static bool run_headless(Dataloader::path_vector_t const& roots, bool run_tests)
 		ret = false;
 	}
 
+	if (!profile_path.empty() && game_manager.get_instance_manager()) {
+		ret &= write_profile(*game_manager.get_instance_manager(), profile_path);
+	}
+
+	if (run_benchmarks) {
+		Logger::info("===== Running benchmarks... =====");
+		ret &= OpenVic::run_benchmarks(game_manager);
+	}
+
 	return ret;
 }
 
 /*
-	$ program [-h] [-t] [-b] [path]+
+	$ program [-h] [-t] [-B] [-a] [-v] [-j <threads>] [-d <days>] [-r <seed>] [-p <path>] [-c <path>] [-b] [path]+
 */
 
 int main(int argc, char const* argv[]) {
@@ -92,7 +205,14 @@ int main(int argc, char const* argv[]) {
 
 	char const* program_name = StringUtils::get_filename(argc > 0 ? argv[0] : nullptr, "<program>");
 	fs::path root;
+	fs::path profile_path;
+	fs::path cache_directory;
 	bool run_tests = false;
+	bool run_benchmarks = false;
+	bool verify_updates = false;
+	size_t thread_count = 1;
+	size_t days = 0;
+	std::optional<uint64_t> random_seed;
 	int argn = 0;
 
 	/* Reads the next argument and converts it to a path via path_transform. If reading or converting fails, an error
@@ -127,6 +247,58 @@ int main(int argc, char const* argv[]) {
 			return 0;
 		} else if (strcmp(arg, "-t") == 0) {
 			run_tests = true;
+		} else if (strcmp(arg, "-B") == 0) {
+			run_benchmarks = true;
+		} else if (strcmp(arg, "-a") == 0) {
+			Logger::set_async(true);
+		} else if (strcmp(arg, "-v") == 0) {
+			verify_updates = true;
+		} else if (strcmp(arg, "-j") == 0) {
+			bool successful = false;
+			if (++argn < argc) {
+				thread_count = StringUtils::string_to_uint64(argv[argn], &successful);
+			}
+			if (!successful) {
+				std::cerr << "Missing or invalid thread count after command line argument \"-j\"." << std::endl;
+				print_help(std::cerr, program_name);
+				return -1;
+			}
+		} else if (strcmp(arg, "-d") == 0) {
+			bool successful = false;
+			if (++argn < argc) {
+				days = StringUtils::string_to_uint64(argv[argn], &successful);
+			}
+			if (!successful) {
+				std::cerr << "Missing or invalid day count after command line argument \"-d\"." << std::endl;
+				print_help(std::cerr, program_name);
+				return -1;
+			}
+		} else if (strcmp(arg, "-r") == 0) {
+			bool successful = false;
+			if (++argn < argc) {
+				random_seed = StringUtils::string_to_uint64(argv[argn], &successful);
+			}
+			if (!successful) {
+				std::cerr << "Missing or invalid random seed after command line argument \"-r\"." << std::endl;
+				print_help(std::cerr, program_name);
+				return -1;
+			}
+		} else if (strcmp(arg, "-p") == 0) {
+			if (++argn < argc && argv[argn][0] != '\0') {
+				profile_path = argv[argn];
+			} else {
+				std::cerr << "Missing path after command line argument \"-p\"." << std::endl;
+				print_help(std::cerr, program_name);
+				return -1;
+			}
+		} else if (strcmp(arg, "-c") == 0) {
+			if (++argn < argc && argv[argn][0] != '\0') {
+				cache_directory = argv[argn];
+			} else {
+				std::cerr << "Missing path after command line argument \"-c\"." << std::endl;
+				print_help(std::cerr, program_name);
+				return -1;
+			}
 		} else if (strcmp(arg, "-b") == 0) {
 			if (!_read("-b", "base directory", std::identity {})) {
 				return -1;
@@ -155,7 +327,11 @@ int main(int argc, char const* argv[]) {
 
 	std::cout << "!!! HEADLESS SIMULATION START !!!" << std::endl;
 
-	const bool ret = run_headless(roots, run_tests);
+	const bool ret = run_headless(
+		roots, run_tests, run_benchmarks, verify_updates, thread_count, days, random_seed, profile_path, cache_directory
+	);
+
+	Logger::set_async(false);
 
 	std::cout << "!!! HEADLESS SIMULATION END !!!" << std::endl;
 
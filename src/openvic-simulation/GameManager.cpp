@@ -1,5 +1,7 @@
 #include "GameManager.hpp"
 
+#include <random>
+
 using namespace OpenVic;
 
 GameManager::GameManager(
@@ -9,7 +11,19 @@ GameManager::GameManager(
 		new_gamestate_updated_callback ? std::move(new_gamestate_updated_callback) : []() {}
 	}, clock_state_changed_callback {
 		new_clock_state_changed_callback ? std::move(new_clock_state_changed_callback) : []() {}
-	}, definitions_loaded { false } {}
+	}, definitions_loaded { false }, thread_count { 1 }, random_seed { std::nullopt } {}
+
+void GameManager::set_thread_count(size_t new_thread_count) {
+	thread_count = new_thread_count;
+
+	if (instance_manager) {
+		instance_manager->set_thread_count(thread_count);
+	}
+}
+
+void GameManager::set_random_seed(std::optional<uint64_t> new_random_seed) {
+	random_seed = new_random_seed;
+}
 
 bool GameManager::set_roots(Dataloader::path_vector_t const& roots) {
 	if (!dataloader.set_roots(roots)) {
@@ -19,6 +33,10 @@ bool GameManager::set_roots(Dataloader::path_vector_t const& roots) {
 	return true;
 }
 
+void GameManager::set_definition_cache_directory(fs::path const& directory) {
+	dataloader.set_cache_directory(directory);
+}
+
 bool GameManager::load_definitions(Dataloader::localisation_callback_t localisation_callback) {
 	if (definitions_loaded) {
 		Logger::error("Cannot load definitions - already loaded!");
@@ -49,7 +67,18 @@ bool GameManager::setup_instance(Bookmark const* bookmark) {
 		Logger::info("Setting up first game instance.");
 	}
 
-	instance_manager.emplace(definition_manager, gamestate_updated_callback, clock_state_changed_callback);
+	uint64_t instance_random_seed;
+	if (random_seed) {
+		instance_random_seed = *random_seed;
+	} else {
+		std::random_device random_device;
+		instance_random_seed = (static_cast<uint64_t>(random_device()) << 32) | random_device();
+	}
+	Logger::info("Using random seed ", instance_random_seed);
+
+	instance_manager.emplace(
+		definition_manager, gamestate_updated_callback, clock_state_changed_callback, thread_count, instance_random_seed
+	);
 
 	bool ret = instance_manager->setup();
 	ret &= instance_manager->load_bookmark(bookmark);
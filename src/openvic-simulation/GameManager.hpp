@@ -16,6 +16,10 @@ namespace OpenVic {
 		InstanceManager::gamestate_updated_func_t gamestate_updated_callback;
 		SimulationClock::state_changed_function_t clock_state_changed_callback;
 		bool PROPERTY_CUSTOM_PREFIX(definitions_loaded, are);
+		/* Number of threads used by game instances for gamestate updates, 0 meaning all available hardware threads. */
+		size_t PROPERTY(thread_count);
+		/* Random seed used by game instances, with a new one generated for each instance if unset. */
+		std::optional<uint64_t> PROPERTY(random_seed);
 
 	public:
 		GameManager(
@@ -31,7 +35,15 @@ namespace OpenVic {
 			return instance_manager ? &*instance_manager : nullptr;
 		}
 
+		/* Applies to the current game instance (if there is one) and any instances set up afterwards. */
+		void set_thread_count(size_t new_thread_count);
+		/* Applies to game instances set up afterwards, std::nullopt generating a new seed for each one. */
+		void set_random_seed(std::optional<uint64_t> new_random_seed);
+
 		bool set_roots(Dataloader::path_vector_t const& roots);
+		/* Caches slow to generate definitions in the directory, see DefinitionCache. Must be set before loading definitions
+		 * to have any effect, and an empty path disables caching. */
+		void set_definition_cache_directory(fs::path const& directory);
 
 		bool load_definitions(Dataloader::localisation_callback_t localisation_callback);
 
@@ -2,27 +2,39 @@
 
 #include "openvic-simulation/DefinitionManager.hpp"
 #include "openvic-simulation/utility/Logger.hpp"
+#include "openvic-simulation/utility/StringUtils.hpp"
 
 using namespace OpenVic;
 
 InstanceManager::InstanceManager(
 	DefinitionManager const& new_definition_manager, gamestate_updated_func_t gamestate_updated_callback,
-	SimulationClock::state_changed_function_t clock_state_changed_callback
+	SimulationClock::state_changed_function_t clock_state_changed_callback, size_t thread_count,
+	uint64_t new_random_seed
 ) : definition_manager { new_definition_manager },
 	map_instance { new_definition_manager.get_map_definition() },
 	simulation_clock {
 		std::bind(&InstanceManager::tick, this), std::bind(&InstanceManager::update_gamestate, this),
 		clock_state_changed_callback ? std::move(clock_state_changed_callback)  : []() {}
 	},
+	thread_pool { thread_count },
+	profiler {},
+	random_seed { new_random_seed },
 	game_instance_setup { false },
 	game_session_started { false },
+	verify_incremental_updates { false },
 	session_start { 0 },
 	bookmark { nullptr },
 	today {},
 	gamestate_updated { gamestate_updated_callback ? std::move(gamestate_updated_callback) : []() {} },
 	gamestate_needs_update { false },
+	gamestate_needs_full_update { false },
 	currently_updating_gamestate { false } {}
 
+void InstanceManager::set_thread_count(size_t thread_count) {
+	thread_pool.set_thread_count(thread_count);
+	Logger::info("Instance manager using ", thread_pool.get_thread_count(), " thread(s) for gamestate updates.");
+}
+
 void InstanceManager::set_gamestate_needs_update() {
 	if (!currently_updating_gamestate) {
 		gamestate_needs_update = true;
@@ -31,6 +43,126 @@ void InstanceManager::set_gamestate_needs_update() {
 	}
 }
 
+void InstanceManager::set_gamestate_needs_full_update() {
+	if (!currently_updating_gamestate) {
+		map_instance.mark_all_gamestate_dirty();
+		country_instance_manager.mark_all_gamestate_dirty();
+		gamestate_needs_full_update = true;
+	}
+	set_gamestate_needs_update();
+}
+
+void InstanceManager::_update_dirty_gamestate(Profiler& update_profiler) {
+	map_instance.update_gamestate(today, definition_manager.get_define_manager(), thread_pool, update_profiler);
+	country_instance_manager.update_gamestate(
+		today, definition_manager.get_define_manager(), definition_manager.get_military_manager().get_unit_type_manager(),
+		thread_pool, update_profiler
+	);
+}
+
+/* Each entry is an entity's identifier followed by the aggregate values its gamestate update calculates. */
+using gamestate_snapshot_t = std::vector<std::pair<std::string, std::vector<fixed_point_t>>>;
+
+static gamestate_snapshot_t take_gamestate_snapshot(
+	MapInstance const& map_instance, CountryInstanceManager const& country_instance_manager
+) {
+	gamestate_snapshot_t snapshot;
+
+	const auto add_distribution = [](std::vector<fixed_point_t>& values, auto const& distribution) -> void {
+		values.insert(values.end(), distribution.begin(), distribution.end());
+	};
+	/* Every key's value, so an entry missing from one update but zero in the other still compares equal. */
+	const auto add_sparse_distribution = [](std::vector<fixed_point_t>& values, auto const& distribution) -> void {
+		if (distribution.has_keys()) {
+			for (size_t index = 0; index < distribution.get_keys()->size(); ++index) {
+				values.push_back(distribution.get_value(index));
+			}
+		}
+	};
+
+	for (ProvinceInstance const& province : map_instance.get_province_instances()) {
+		std::vector<fixed_point_t>& values =
+			snapshot.emplace_back(province.get_identifier(), std::vector<fixed_point_t> {}).second;
+		values.push_back(fixed_point_t::parse(province.get_total_population()));
+		values.push_back(province.get_average_literacy());
+		values.push_back(province.get_average_consciousness());
+		values.push_back(province.get_average_militancy());
+		values.push_back(fixed_point_t::parse(static_cast<int64_t>(province.get_max_supported_regiments())));
+		add_distribution(values, province.get_pop_type_distribution());
+		add_distribution(values, province.get_ideology_distribution());
+		add_sparse_distribution(values, province.get_culture_distribution());
+		add_sparse_distribution(values, province.get_religion_distribution());
+	}
+
+	for (StateSet const& state_set : map_instance.get_state_manager().get_state_sets()) {
+		for (State const& state : state_set.get_states()) {
+			std::vector<fixed_point_t>& values =
+				snapshot.emplace_back(state.get_identifier(), std::vector<fixed_point_t> {}).second;
+			values.push_back(fixed_point_t::parse(state.get_total_population()));
+			values.push_back(state.get_average_literacy());
+			values.push_back(state.get_average_consciousness());
+			values.push_back(state.get_average_militancy());
+			values.push_back(fixed_point_t::parse(static_cast<int64_t>(state.get_max_supported_regiments())));
+			values.push_back(state.get_industrial_power());
+			add_distribution(values, state.get_pop_type_distribution());
+			add_sparse_distribution(values, state.get_culture_distribution());
+			add_sparse_distribution(values, state.get_religion_distribution());
+		}
+	}
+
+	for (CountryInstance const& country : country_instance_manager.get_country_instances()) {
+		std::vector<fixed_point_t>& values =
+			snapshot.emplace_back(country.get_identifier(), std::vector<fixed_point_t> {}).second;
+		values.push_back(fixed_point_t::parse(country.get_total_population()));
+		values.push_back(country.get_national_literacy());
+		values.push_back(country.get_national_consciousness());
+		values.push_back(country.get_national_militancy());
+		values.push_back(country.get_industrial_power());
+		values.push_back(country.get_military_power());
+		values.push_back(country.get_total_score());
+		values.push_back(fixed_point_t::parse(static_cast<int64_t>(country.get_total_rank())));
+		add_distribution(values, country.get_pop_type_distribution());
+		add_sparse_distribution(values, country.get_culture_distribution());
+		add_sparse_distribution(values, country.get_religion_distribution());
+	}
+
+	return snapshot;
+}
+
+bool InstanceManager::_verify_incremental_update() {
+	const gamestate_snapshot_t incremental_snapshot = take_gamestate_snapshot(map_instance, country_instance_manager);
+
+	map_instance.mark_all_gamestate_dirty();
+	country_instance_manager.mark_all_gamestate_dirty();
+	/* A disabled profiler, so the full update isn't counted in the gamestate update timings. */
+	Profiler untimed_profiler {};
+	_update_dirty_gamestate(untimed_profiler);
+
+	const gamestate_snapshot_t full_snapshot = take_gamestate_snapshot(map_instance, country_instance_manager);
+
+	if (incremental_snapshot.size() != full_snapshot.size()) {
+		Logger::error(
+			"Incremental gamestate update verification failed: entity count changed from ", incremental_snapshot.size(),
+			" to ", full_snapshot.size(), "!"
+		);
+		return false;
+	}
+
+	bool ret = true;
+
+	for (size_t index = 0; index < full_snapshot.size(); ++index) {
+		if (incremental_snapshot[index] != full_snapshot[index]) {
+			Logger::error(
+				"Incremental gamestate update verification failed: ", full_snapshot[index].first,
+				" differs from a full update!"
+			);
+			ret = false;
+		}
+	}
+
+	return ret;
+}
+
 void InstanceManager::update_gamestate() {
 	if (!gamestate_needs_update) {
 		return;
@@ -39,14 +171,21 @@ void InstanceManager::update_gamestate() {
 
 	Logger::info("Update: ", today);
 
-	// Update gamestate...
-	map_instance.update_gamestate(today, definition_manager.get_define_manager());
-	country_instance_manager.update_gamestate(
-		today, definition_manager.get_define_manager(), definition_manager.get_military_manager().get_unit_type_manager()
-	);
+	{
+		const Profiler::ScopedTimer timer { profiler, Profiler::phase_t::GAMESTATE_UPDATE };
+
+		// Update gamestate...
+		_update_dirty_gamestate(profiler);
+	}
+	profiler.end_sample();
+
+	if (verify_incremental_updates && !gamestate_needs_full_update && !_verify_incremental_update()) {
+		Logger::error("Incremental gamestate update on ", today, " doesn't match a full update!");
+	}
 
 	gamestate_updated();
 	gamestate_needs_update = false;
+	gamestate_needs_full_update = false;
 
 	currently_updating_gamestate = false;
 }
@@ -55,14 +194,23 @@ void InstanceManager::update_gamestate() {
  * SS-98, SS-101
  */
 void InstanceManager::tick() {
-	today++;
+	{
+		const Profiler::ScopedTimer timer { profiler, Profiler::phase_t::TICK };
 
-	Logger::info("Tick: ", today);
+		today++;
 
-	// Tick...
-	map_instance.tick(today);
+		Logger::info("Tick: ", today);
 
-	set_gamestate_needs_update();
+		// Tick...
+		{
+			const Profiler::ScopedTimer map_timer { profiler, Profiler::phase_t::MAP_TICK };
+			map_instance.tick(today, thread_pool);
+		}
+
+		/* The tick marks what it changed as dirty, so only those provinces, states and countries are updated. */
+		set_gamestate_needs_update();
+	}
+	profiler.end_sample();
 }
 
 bool InstanceManager::setup() {
@@ -75,7 +223,11 @@ bool InstanceManager::setup() {
 	ret &= map_instance.setup(
 		definition_manager.get_economy_manager().get_building_type_manager(),
 		definition_manager.get_pop_manager().get_pop_types(),
-		definition_manager.get_politics_manager().get_ideology_manager().get_ideologies()
+		definition_manager.get_politics_manager().get_ideology_manager().get_ideologies(),
+		definition_manager.get_pop_manager().get_culture_manager().get_cultures(),
+		definition_manager.get_pop_manager().get_religion_manager().get_religions(),
+		definition_manager.get_politics_manager().get_issue_manager(),
+		definition_manager.get_modifier_manager()
 	);
 	ret &= country_instance_manager.generate_country_instances(
 		definition_manager.get_country_definition_manager(),
@@ -87,9 +239,12 @@ bool InstanceManager::setup() {
 		definition_manager.get_politics_manager().get_government_type_manager().get_government_types(),
 		definition_manager.get_crime_manager().get_crime_modifiers(),
 		definition_manager.get_pop_manager().get_pop_types(),
+		definition_manager.get_pop_manager().get_culture_manager().get_cultures(),
+		definition_manager.get_pop_manager().get_religion_manager().get_religions(),
 		definition_manager.get_military_manager().get_unit_type_manager().get_regiment_types(),
 		definition_manager.get_military_manager().get_unit_type_manager().get_ship_types()
 	);
+	ret &= country_relation_manager.setup(country_instance_manager);
 
 	game_instance_setup = true;
 
@@ -126,7 +281,7 @@ bool InstanceManager::load_bookmark(Bookmark const* new_bookmark) {
 		definition_manager.get_history_manager().get_province_manager(), today,
 		country_instance_manager,
 		// TODO - the following argument is for generating test pop attributes
-		definition_manager.get_politics_manager().get_issue_manager()
+		definition_manager.get_politics_manager().get_issue_manager(), random_seed
 	);
 
 	ret &= country_instance_manager.apply_history_to_countries(
@@ -134,7 +289,9 @@ bool InstanceManager::load_bookmark(Bookmark const* new_bookmark) {
 	);
 
 	ret &= map_instance.get_state_manager().generate_states(
-		map_instance, definition_manager.get_pop_manager().get_pop_types()
+		map_instance, definition_manager.get_pop_manager().get_pop_types(),
+		definition_manager.get_pop_manager().get_culture_manager().get_cultures(),
+		definition_manager.get_pop_manager().get_religion_manager().get_religions()
 	);
 
 	return ret;
@@ -148,7 +305,7 @@ bool InstanceManager::start_game_session() {
 
 	session_start = time(nullptr);
 	simulation_clock.reset();
-	set_gamestate_needs_update();
+	set_gamestate_needs_full_update();
 
 	game_session_started = true;
 
@@ -165,6 +322,18 @@ bool InstanceManager::update_clock() {
 	return true;
 }
 
+bool InstanceManager::advance_days(size_t days) {
+	if (!is_game_session_started()) {
+		Logger::error("Cannot advance ", days, " days - game session not started!");
+		return false;
+	}
+
+	for (size_t day = 0; day < days; ++day) {
+		simulation_clock.force_advance_game();
+	}
+	return true;
+}
+
 bool InstanceManager::expand_selected_province_building(size_t building_index) {
 	set_gamestate_needs_update();
 	ProvinceInstance* province = map_instance.get_selected_province();
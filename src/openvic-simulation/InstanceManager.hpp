@@ -10,6 +10,9 @@
 #include "openvic-simulation/military/UnitInstanceGroup.hpp"
 #include "openvic-simulation/misc/SimulationClock.hpp"
 #include "openvic-simulation/types/Date.hpp"
+#include "openvic-simulation/utility/Profiler.hpp"
+#include "openvic-simulation/utility/RandomStream.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
 
 namespace OpenVic {
 	struct DefinitionManager;
@@ -29,10 +32,20 @@ namespace OpenVic {
 		 * e.g. if we want to remove military units from the province they're in when they're destructed. */
 		MapInstance PROPERTY_REF(map_instance);
 		SimulationClock PROPERTY_REF(simulation_clock);
+		/* Used to split independent per-entity gamestate updates and ticks across multiple threads. */
+		ThreadPool PROPERTY_REF(thread_pool);
+		/* Per-phase timings of ticks and gamestate updates, disabled by default. */
+		Profiler PROPERTY_REF(profiler);
+		/* Keys every random stream drawn from during this game, so a game can be reproduced from its seed. */
+		const uint64_t PROPERTY(random_seed);
 
 		bool PROPERTY_CUSTOM_PREFIX(game_instance_setup, is);
 		bool PROPERTY_CUSTOM_PREFIX(game_session_started, is);
 
+		/* Debug mode: after each gamestate update which only updated dirty entities, redo the update for every entity
+		 * outside of the profiled update and log an error for any province, state or country whose aggregates differ. */
+		bool PROPERTY_RW(verify_incremental_updates);
+
 	public:
 		inline constexpr bool is_bookmark_loaded() const {
 			return bookmark != nullptr;
@@ -43,22 +56,38 @@ namespace OpenVic {
 		Bookmark const* PROPERTY(bookmark);
 		Date PROPERTY(today);
 		gamestate_updated_func_t gamestate_updated;
-		bool gamestate_needs_update, currently_updating_gamestate;
+		bool gamestate_needs_update, gamestate_needs_full_update, currently_updating_gamestate;
 
+		/* Queues an update of only the provinces, states and countries marked as dirty. */
 		void set_gamestate_needs_update();
+		/* Marks everything as dirty and queues an update. */
+		void set_gamestate_needs_full_update();
+		void _update_dirty_gamestate(Profiler& update_profiler);
+		bool _verify_incremental_update();
 		void update_gamestate();
 		void tick();
 
 	public:
 		InstanceManager(
 			DefinitionManager const& new_definition_manager, gamestate_updated_func_t gamestate_updated_callback,
-			SimulationClock::state_changed_function_t clock_state_changed_callback
+			SimulationClock::state_changed_function_t clock_state_changed_callback, size_t thread_count = 1,
+			uint64_t new_random_seed = 0
 		);
 
+		/* Returns a random stream for an entity which is only used today, independent of every other entity's streams. */
+		inline constexpr RandomStream get_random_stream(RandomStream::domain_t domain, uint64_t entity_index) const {
+			return { random_seed, today, domain, entity_index };
+		}
+
+		/* A thread count of 0 uses all available hardware threads, while 1 runs everything on the calling thread. */
+		void set_thread_count(size_t thread_count);
+
 		bool setup();
 		bool load_bookmark(Bookmark const* new_bookmark);
 		bool start_game_session();
 		bool update_clock();
+		/* Advances the game by the given number of days as fast as possible, without waiting on the simulation clock. */
+		bool advance_days(size_t days);
 
 		bool expand_selected_province_building(size_t building_index);
 	};
@@ -8,6 +8,9 @@
 #include "openvic-simulation/politics/Ideology.hpp"
 #include "openvic-simulation/research/Invention.hpp"
 #include "openvic-simulation/research/Technology.hpp"
+#include "openvic-simulation/utility/Profiler.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
+#include "openvic-simulation/utility/Utility.hpp"
 
 using namespace OpenVic;
 
@@ -25,6 +28,8 @@ CountryInstance::CountryInstance(
 	decltype(government_flag_overrides)::keys_t const& government_type_keys,
 	decltype(unlocked_crimes)::keys_t const& crime_keys,
 	decltype(pop_type_distribution)::keys_t const& pop_type_keys,
+	decltype(culture_distribution)::keys_t const& culture_keys,
+	decltype(religion_distribution)::keys_t const& religion_keys,
 	decltype(unlocked_regiment_types)::keys_t const& unlocked_regiment_types_keys,
 	decltype(unlocked_ship_types)::keys_t const& unlocked_ship_types_keys
 ) : /* Main attributes */
@@ -41,6 +46,7 @@ CountryInstance::CountryInstance(
 	controlled_provinces {},
 	core_provinces {},
 	states {},
+	gamestate_dirty { true },
 
 	/* Production */
 	industrial_power { 0 },
@@ -48,6 +54,7 @@ CountryInstance::CountryInstance(
 	industrial_power_from_investments {},
 	industrial_rank { 0 },
 	foreign_investments {},
+	foreign_investors {},
 	unlocked_building_types { &building_type_keys },
 
 	/* Budget */
@@ -89,6 +96,8 @@ CountryInstance::CountryInstance(
 	national_consciousness { 0 },
 	national_militancy { 0 },
 	pop_type_distribution { &pop_type_keys },
+	culture_distribution { &culture_keys },
+	religion_distribution { &religion_keys },
 	national_focus_capacity { 0 },
 
 	/* Trade */
@@ -177,6 +186,10 @@ bool CountryInstance::is_secondary_power() const {
 	return country_status == COUNTRY_STATUS_SECONDARY_POWER;
 }
 
+void CountryInstance::mark_gamestate_dirty() {
+	gamestate_dirty = true;
+}
+
 bool CountryInstance::set_country_flag(std::string_view flag, bool warn) {
 	if (flag.empty()) {
 		Logger::error("Attempted to set empty country flag for country ", get_identifier());
@@ -203,6 +216,44 @@ bool CountryInstance::clear_country_flag(std::string_view flag, bool warn) {
 	return true;
 }
 
+void CountryInstance::_mark_foreign_investors_dirty() {
+	for (CountryInstance* investor : foreign_investors) {
+		investor->mark_gamestate_dirty();
+	}
+}
+
+/* Owned provinces decide whether this country exists, which its foreign investors' updates depend on. */
+bool CountryInstance::add_owned_province(ProvinceInstance& new_province) {
+	const bool existed = exists();
+	if (!owned_provinces.emplace(&new_province).second) {
+		Logger::error(
+			"Attempted to add owned province \"", new_province.get_identifier(), "\" to country ", get_identifier(),
+			": already present!"
+		);
+		return false;
+	}
+	gamestate_dirty = true;
+	if (!existed) {
+		_mark_foreign_investors_dirty();
+	}
+	return true;
+}
+
+bool CountryInstance::remove_owned_province(ProvinceInstance& province_to_remove) {
+	if (owned_provinces.erase(&province_to_remove) == 0) {
+		Logger::error(
+			"Attempted to remove owned province \"", province_to_remove.get_identifier(), "\" from country ",
+			get_identifier(), ": not present!"
+		);
+		return false;
+	}
+	gamestate_dirty = true;
+	if (!exists()) {
+		_mark_foreign_investors_dirty();
+	}
+	return true;
+}
+
 #define ADD_AND_REMOVE(item) \
 	bool CountryInstance::add_##item(std::remove_pointer_t<decltype(item##s)::value_type>& new_item) { \
 		if (!item##s.emplace(&new_item).second) { \
@@ -212,6 +263,7 @@ bool CountryInstance::clear_country_flag(std::string_view flag, bool warn) {
 			); \
 			return false; \
 		} \
+		gamestate_dirty = true; \
 		return true; \
 	} \
 	bool CountryInstance::remove_##item(std::remove_pointer_t<decltype(item##s)::value_type>& item_to_remove) { \
@@ -222,10 +274,10 @@ bool CountryInstance::clear_country_flag(std::string_view flag, bool warn) {
 			); \
 			return false; \
 		} \
+		gamestate_dirty = true; \
 		return true; \
 	}
 
-ADD_AND_REMOVE(owned_province)
 ADD_AND_REMOVE(controlled_province)
 ADD_AND_REMOVE(core_province)
 ADD_AND_REMOVE(state)
@@ -279,6 +331,7 @@ bool CountryInstance::add_reform(Reform const& new_reform) {
 template<UnitType::branch_t Branch>
 bool CountryInstance::add_unit_instance_group(UnitInstanceGroup<Branch>& group) {
 	if (get_unit_instance_groups<Branch>().emplace(static_cast<UnitInstanceGroupBranched<Branch>*>(&group)).second) {
+		gamestate_dirty = true;
 		return true;
 	} else {
 		Logger::error(
@@ -292,6 +345,7 @@ bool CountryInstance::add_unit_instance_group(UnitInstanceGroup<Branch>& group)
 template<UnitType::branch_t Branch>
 bool CountryInstance::remove_unit_instance_group(UnitInstanceGroup<Branch>& group) {
 	if (get_unit_instance_groups<Branch>().erase(static_cast<UnitInstanceGroupBranched<Branch>*>(&group)) > 0) {
+		gamestate_dirty = true;
 		return true;
 	} else {
 		Logger::error(
@@ -310,6 +364,7 @@ template bool CountryInstance::remove_unit_instance_group(UnitInstanceGroup<Unit
 template<UnitType::branch_t Branch>
 void CountryInstance::add_leader(LeaderBranched<Branch>&& leader) {
 	get_leaders<Branch>().emplace(std::move(leader));
+	gamestate_dirty = true;
 }
 
 template<UnitType::branch_t Branch>
@@ -318,6 +373,7 @@ bool CountryInstance::remove_leader(LeaderBranched<Branch> const* leader) {
 	const auto it = leaders.get_iterator(leader);
 	if (it != leaders.end()) {
 		leaders.erase(it);
+		gamestate_dirty = true;
 		return true;
 	}
 
@@ -653,15 +709,20 @@ bool CountryInstance::is_primary_or_accepted_culture(Culture const& culture) con
 }
 
 void CountryInstance::apply_foreign_investments(
-	fixed_point_map_t<CountryDefinition const*> const& investments, CountryInstanceManager const& country_instance_manager
+	fixed_point_map_t<CountryDefinition const*> const& investments, CountryInstanceManager& country_instance_manager
 ) {
 	for (auto const& [country, money_invested] : investments) {
-		foreign_investments[&country_instance_manager.get_country_instance_from_definition(*country)] = money_invested;
+		CountryInstance& country_instance = country_instance_manager.get_country_instance_from_definition(*country);
+		foreign_investments[&country_instance] = money_invested;
+		country_instance.foreign_investors.emplace(this);
+	}
+	if (!investments.empty()) {
+		gamestate_dirty = true;
 	}
 }
 
 bool CountryInstance::apply_history_to_country(
-	CountryHistoryEntry const& entry, MapInstance& map_instance, CountryInstanceManager const& country_instance_manager
+	CountryHistoryEntry const& entry, MapInstance& map_instance, CountryInstanceManager& country_instance_manager
 ) {
 	constexpr auto set_optional = []<typename T>(T& target, std::optional<T> const& source) {
 		if (source) {
@@ -671,6 +732,9 @@ bool CountryInstance::apply_history_to_country(
 
 	bool ret = true;
 
+	/* History can change almost anything this country's gamestate update reads. */
+	gamestate_dirty = true;
+
 	set_optional(primary_culture, entry.get_primary_culture());	
 	for (auto const& [culture, add] : entry.get_accepted_cultures()) {
 		if (add) {
@@ -789,6 +853,8 @@ void CountryInstance::_update_population() {
 	national_consciousness = 0;
 	national_militancy = 0;
 	pop_type_distribution.clear();
+	culture_distribution.clear();
+	religion_distribution.clear();
 
 	for (State const* state : states) {
 		total_population += state->get_total_population();
@@ -800,6 +866,8 @@ void CountryInstance::_update_population() {
 		national_militancy += state->get_average_militancy() * state_population;
 
 		pop_type_distribution += state->get_pop_type_distribution();
+		culture_distribution += state->get_culture_distribution();
+		religion_distribution += state->get_religion_distribution();
 	}
 
 	if (total_population > 0) {
@@ -927,19 +995,49 @@ bool CountryInstance::update_rule_set() {
 	return rule_set.trim_and_resolve_conflicts(true);
 }
 
-void CountryInstance::update_gamestate(DefineManager const& define_manager, UnitTypeManager const& unit_type_manager) {
+void CountryInstance::update_gamestate(
+	DefineManager const& define_manager, UnitTypeManager const& unit_type_manager, Profiler& profiler
+) {
+	using enum Profiler::phase_t;
+
 	// Order of updates might need to be changed/functions split up to account for dependencies
-	_update_production(define_manager);
-	_update_budget();
-	_update_technology();
-	_update_politics();
-	_update_population();
-	_update_trade();
-	_update_diplomacy();
-	_update_military(define_manager, unit_type_manager);
+	{
+		const Profiler::ScopedTimer timer { profiler, COUNTRY_UPDATE_PRODUCTION };
+		_update_production(define_manager);
+	}
+	{
+		const Profiler::ScopedTimer timer { profiler, COUNTRY_UPDATE_BUDGET };
+		_update_budget();
+	}
+	{
+		const Profiler::ScopedTimer timer { profiler, COUNTRY_UPDATE_TECHNOLOGY };
+		_update_technology();
+	}
+	{
+		const Profiler::ScopedTimer timer { profiler, COUNTRY_UPDATE_POLITICS };
+		_update_politics();
+	}
+	{
+		const Profiler::ScopedTimer timer { profiler, COUNTRY_UPDATE_POPULATION };
+		_update_population();
+	}
+	{
+		const Profiler::ScopedTimer timer { profiler, COUNTRY_UPDATE_TRADE };
+		_update_trade();
+	}
+	{
+		const Profiler::ScopedTimer timer { profiler, COUNTRY_UPDATE_DIPLOMACY };
+		_update_diplomacy();
+	}
+	{
+		const Profiler::ScopedTimer timer { profiler, COUNTRY_UPDATE_MILITARY };
+		_update_military(define_manager, unit_type_manager);
+	}
 
 	total_score = prestige + industrial_power + military_power;
 
+	const colour_t old_colour = colour;
+
 	if (country_definition != nullptr) {
 		const CountryDefinition::government_colour_map_t::const_iterator it =
 			country_definition->get_alternative_colours().find(government_type);
@@ -953,6 +1051,13 @@ void CountryInstance::update_gamestate(DefineManager const& define_manager, Unit
 		colour = ERROR_COLOUR;
 	}
 
+	/* Owned provinces are drawn in this country's colour, so their mapmode colours need regenerating. */
+	if (colour != old_colour) {
+		for (ProvinceInstance* province : owned_provinces) {
+			province->increment_revision();
+		}
+	}
+
 	if (government_type != nullptr) {
 		flag_government_type = government_flag_overrides[*government_type];
 
@@ -962,6 +1067,8 @@ void CountryInstance::update_gamestate(DefineManager const& define_manager, Unit
 	} else {
 		flag_government_type = nullptr;
 	}
+
+	gamestate_dirty = false;
 }
 
 void CountryInstance::tick() {
@@ -969,42 +1076,68 @@ void CountryInstance::tick() {
 }
 
 void CountryInstanceManager::update_rankings(Date today, DefineManager const& define_manager) {
-	total_ranking.clear();
+	const auto does_not_exist = [](CountryInstance const* country) -> bool {
+		return !country->exists();
+	};
+	std::erase_if(total_ranking, does_not_exist);
+	std::erase_if(prestige_ranking, does_not_exist);
+	std::erase_if(industrial_power_ranking, does_not_exist);
+	std::erase_if(military_power_ranking, does_not_exist);
 
-	for (CountryInstance& country : country_instances.get_items()) {
+	size_t existing_country_count = 0;
+	for (CountryInstance const& country : country_instances.get_items()) {
 		if (country.exists()) {
-			total_ranking.push_back(&country);
+			existing_country_count++;
 		}
 	}
 
-	prestige_ranking = total_ranking;
-	industrial_power_ranking = total_ranking;
-	military_power_ranking = total_ranking;
+	// The rankings are kept between updates, so as scores usually only change slightly they are already almost sorted.
+	// They only need rebuilding if a country has come into existence since the last update.
+	if (total_ranking.size() != existing_country_count) {
+		total_ranking.clear();
 
-	std::sort(
+		for (CountryInstance& country : country_instances.get_items()) {
+			if (country.exists()) {
+				total_ranking.push_back(&country);
+			}
+		}
+
+		prestige_ranking = total_ranking;
+		industrial_power_ranking = total_ranking;
+		military_power_ranking = total_ranking;
+	}
+
+	// Ties are broken by country index (country instances are stored contiguously in index order), so each ranking has
+	// exactly one correct order and is the same however it was sorted.
+	utility::repair_sort(
 		total_ranking.begin(), total_ranking.end(),
 		[](CountryInstance const* a, CountryInstance const* b) -> bool {
 			const bool a_civilised = a->is_civilised();
 			const bool b_civilised = b->is_civilised();
-			return a_civilised != b_civilised ? a_civilised : a->get_total_score() > b->get_total_score();
+			if (a_civilised != b_civilised) {
+				return a_civilised;
+			}
+			return a->get_total_score() != b->get_total_score() ? a->get_total_score() > b->get_total_score() : a < b;
 		}
 	);
-	std::sort(
+	utility::repair_sort(
 		prestige_ranking.begin(), prestige_ranking.end(),
 		[](CountryInstance const* a, CountryInstance const* b) -> bool {
-			return a->get_prestige() > b->get_prestige();
+			return a->get_prestige() != b->get_prestige() ? a->get_prestige() > b->get_prestige() : a < b;
 		}
 	);
-	std::sort(
+	utility::repair_sort(
 		industrial_power_ranking.begin(), industrial_power_ranking.end(),
 		[](CountryInstance const* a, CountryInstance const* b) -> bool {
-			return a->get_industrial_power() > b->get_industrial_power();
+			return a->get_industrial_power() != b->get_industrial_power()
+				? a->get_industrial_power() > b->get_industrial_power() : a < b;
 		}
 	);
-	std::sort(
+	utility::repair_sort(
 		military_power_ranking.begin(), military_power_ranking.end(),
 		[](CountryInstance const* a, CountryInstance const* b) -> bool {
-			return a->get_military_power() > b->get_military_power();
+			return a->get_military_power() != b->get_military_power()
+				? a->get_military_power() > b->get_military_power() : a < b;
 		}
 	);
 
@@ -1085,6 +1218,8 @@ void CountryInstanceManager::update_rankings(Date today, DefineManager const& de
 	}
 }
 
+CountryInstanceManager::CountryInstanceManager() : force_serial_update { false } {}
+
 CountryInstance& CountryInstanceManager::get_country_instance_from_definition(CountryDefinition const& country) {
 	return country_instances.get_items()[country.get_index()];
 }
@@ -1103,6 +1238,8 @@ bool CountryInstanceManager::generate_country_instances(
 	decltype(CountryInstance::government_flag_overrides)::keys_t const& government_type_keys,
 	decltype(CountryInstance::unlocked_crimes)::keys_t const& crime_keys,
 	decltype(CountryInstance::pop_type_distribution)::keys_t const& pop_type_keys,
+	decltype(CountryInstance::culture_distribution)::keys_t const& culture_keys,
+	decltype(CountryInstance::religion_distribution)::keys_t const& religion_keys,
 	decltype(CountryInstance::unlocked_regiment_types)::keys_t const& unlocked_regiment_types_keys,
 	decltype(CountryInstance::unlocked_ship_types)::keys_t const& unlocked_ship_types_keys
 ) {
@@ -1121,6 +1258,8 @@ bool CountryInstanceManager::generate_country_instances(
 			government_type_keys,
 			crime_keys,
 			pop_type_keys,
+			culture_keys,
+			religion_keys,
 			unlocked_regiment_types_keys,
 			unlocked_ship_types_keys
 		});
@@ -1143,19 +1282,29 @@ bool CountryInstanceManager::apply_history_to_countries(
 			if (history_map != nullptr) {
 				CountryHistoryEntry const* oob_history_entry = nullptr;
 
-				for (auto const& [entry_date, entry] : history_map->get_entries()) {
-					if (entry_date <= date) {
-						ret &= country_instance.apply_history_to_country(*entry, map_instance, *this);
+				/* Bookmark dates have all of their history folded into a single snapshot entry, other dates are replayed. */
+				CountryHistoryEntry const* snapshot = history_map->get_snapshot(date);
+				if (snapshot != nullptr) {
+					ret &= country_instance.apply_history_to_country(*snapshot, map_instance, *this);
+
+					if (snapshot->get_inital_oob()) {
+						oob_history_entry = snapshot;
+					}
+				} else {
+					for (CountryHistoryEntry const& entry : history_map->get_entries_up_to(date)) {
+						ret &= country_instance.apply_history_to_country(entry, map_instance, *this);
 
-						if (entry->get_inital_oob()) {
-							oob_history_entry = entry.get();
+						if (entry.get_inital_oob()) {
+							oob_history_entry = &entry;
 						}
-					} else {
-						// All foreign investments are applied regardless of the bookmark's date
-						country_instance.apply_foreign_investments(entry->get_foreign_investment(), *this);
 					}
 				}
 
+				// All foreign investments are applied regardless of the bookmark's date
+				for (CountryHistoryEntry const& entry : history_map->get_entries_after(date)) {
+					country_instance.apply_foreign_investments(entry.get_foreign_investment(), *this);
+				}
+
 				if (oob_history_entry != nullptr) {
 					ret &= unit_instance_manager.generate_deployment(
 						map_instance, country_instance, *oob_history_entry->get_inital_oob()
@@ -1172,15 +1321,34 @@ bool CountryInstanceManager::apply_history_to_countries(
 }
 
 void CountryInstanceManager::update_gamestate(
-	Date today, DefineManager const& define_manager, UnitTypeManager const& unit_type_manager
+	Date today, DefineManager const& define_manager, UnitTypeManager const& unit_type_manager, ThreadPool& thread_pool,
+	Profiler& profiler
 ) {
-	for (CountryInstance& country : country_instances.get_items()) {
-		country.update_gamestate(define_manager, unit_type_manager);
+	const auto update_country = [&define_manager, &unit_type_manager, &profiler](CountryInstance& country) -> void {
+		if (country.is_gamestate_dirty()) {
+			country.update_gamestate(define_manager, unit_type_manager, profiler);
+		}
+	};
+
+	if (force_serial_update) {
+		for (CountryInstance& country : country_instances.get_items()) {
+			update_country(country);
+		}
+	} else {
+		thread_pool.parallel_for_each(country_instances.get_items(), update_country);
 	}
 
+	// Rankings compare countries against each other, so they're only updated once every country has finished updating.
+	const Profiler::ScopedTimer timer { profiler, Profiler::phase_t::COUNTRY_UPDATE_RANKINGS };
 	update_rankings(today, define_manager);
 }
 
+void CountryInstanceManager::mark_all_gamestate_dirty() {
+	for (CountryInstance& country : country_instances.get_items()) {
+		country.mark_gamestate_dirty();
+	}
+}
+
 void CountryInstanceManager::tick() {
 	for (CountryInstance& country : country_instances.get_items()) {
 		country.tick();
@@ -11,6 +11,7 @@
 #include "openvic-simulation/types/Date.hpp"
 #include "openvic-simulation/types/IdentifierRegistry.hpp"
 #include "openvic-simulation/types/IndexedMap.hpp"
+#include "openvic-simulation/types/SparseIndexedMap.hpp"
 #include "openvic-simulation/utility/Getters.hpp"
 
 namespace OpenVic {
@@ -34,6 +35,7 @@ namespace OpenVic {
 	struct CountryHistoryEntry;
 	struct MapInstance;
 	struct DefineManager;
+	struct Profiler;
 
 	/* Representation of a country's mutable attributes, with a CountryDefinition that is unique at any single time
 	 * but can be swapped with other CountryInstance's CountryDefinition when switching tags. */
@@ -80,12 +82,20 @@ namespace OpenVic {
 		ordered_set<ProvinceInstance*> PROPERTY(core_provinces);
 		ordered_set<State*> PROPERTY(states);
 
+		/* Set when something this country's aggregates depend on has changed since its last gamestate update. Ticks only
+		 * mark the provinces (and so the states and owners) they change, so anything else changing must set this for the
+		 * next update to pick it up, including changes to other countries which this country's update reads. */
+		bool PROPERTY_CUSTOM_PREFIX(gamestate_dirty, is);
+
 		/* Production */
 		fixed_point_t PROPERTY(industrial_power);
 		std::vector<std::pair<State const*, fixed_point_t>> PROPERTY(industrial_power_from_states);
 		std::vector<std::pair<CountryInstance const*, fixed_point_t>> PROPERTY(industrial_power_from_investments);
 		size_t PROPERTY(industrial_rank);
 		fixed_point_map_t<CountryInstance const*> PROPERTY(foreign_investments);
+		/* Countries with foreign investments in this one, whose industrial power depends on whether this country exists,
+		 * so they're marked as dirty when that changes. */
+		ordered_set<CountryInstance*> PROPERTY(foreign_investors);
 		IndexedMap<BuildingType, unlock_level_t> PROPERTY(unlocked_building_types);
 		// TODO - total amount of each good produced
 
@@ -133,6 +143,8 @@ namespace OpenVic {
 		fixed_point_t PROPERTY(national_consciousness);
 		fixed_point_t PROPERTY(national_militancy);
 		IndexedMap<PopType, fixed_point_t> PROPERTY(pop_type_distribution);
+		SparseIndexedMap<Culture, fixed_point_t> PROPERTY(culture_distribution);
+		SparseIndexedMap<Religion, fixed_point_t> PROPERTY(religion_distribution);
 		size_t PROPERTY(national_focus_capacity)
 		// TODO - national foci
 
@@ -189,6 +201,8 @@ namespace OpenVic {
 			decltype(government_flag_overrides)::keys_t const& government_type_keys,
 			decltype(unlocked_crimes)::keys_t const& crime_keys,
 			decltype(pop_type_distribution)::keys_t const& pop_type_keys,
+			decltype(culture_distribution)::keys_t const& culture_keys,
+			decltype(religion_distribution)::keys_t const& religion_keys,
 			decltype(unlocked_regiment_types)::keys_t const& unlocked_regiment_types_keys,
 			decltype(unlocked_ship_types)::keys_t const& unlocked_ship_types_keys
 		);
@@ -202,6 +216,8 @@ namespace OpenVic {
 		bool is_great_power() const;
 		bool is_secondary_power() const;
 
+		void mark_gamestate_dirty();
+
 		bool set_country_flag(std::string_view flag, bool warn);
 		bool clear_country_flag(std::string_view flag, bool warn);
 		bool add_owned_province(ProvinceInstance& new_province);
@@ -274,15 +290,16 @@ namespace OpenVic {
 
 		// Sets the investment of each country in the map (rather than adding to them), leaving the rest unchanged.
 		void apply_foreign_investments(
-			fixed_point_map_t<CountryDefinition const*> const& investments,
-			CountryInstanceManager const& country_instance_manager
+			fixed_point_map_t<CountryDefinition const*> const& investments, CountryInstanceManager& country_instance_manager
 		);
 
 		bool apply_history_to_country(
-			CountryHistoryEntry const& entry, MapInstance& map_instance, CountryInstanceManager const& country_instance_manager
+			CountryHistoryEntry const& entry, MapInstance& map_instance, CountryInstanceManager& country_instance_manager
 		);
 
 	private:
+		void _mark_foreign_investors_dirty();
+
 		void _update_production(DefineManager const& define_manager);
 		void _update_budget();
 		void _update_technology();
@@ -296,18 +313,25 @@ namespace OpenVic {
 
 	public:
 
-		void update_gamestate(DefineManager const& define_manager, UnitTypeManager const& unit_type_manager);
+		void update_gamestate(
+			DefineManager const& define_manager, UnitTypeManager const& unit_type_manager, Profiler& profiler
+		);
 		void tick();
 	};
 
 	struct CountryDefinitionManager;
 	struct CountryHistoryManager;
 	struct UnitInstanceManager;
+	struct ThreadPool;
 
 	struct CountryInstanceManager {
 	private:
 		IdentifierRegistry<CountryInstance> IDENTIFIER_REGISTRY(country_instance);
 
+		/* When set, CountryInstance updates run one after another on the calling thread even if the thread pool has
+		 * multiple threads, e.g. to compare results against parallel runs. */
+		bool PROPERTY_RW(force_serial_update);
+
 		std::vector<CountryInstance*> PROPERTY(great_powers);
 		std::vector<CountryInstance*> PROPERTY(secondary_powers);
 
@@ -319,6 +343,8 @@ namespace OpenVic {
 		void update_rankings(Date today, DefineManager const& define_manager);
 
 	public:
+		CountryInstanceManager();
+
 		CountryInstance& get_country_instance_from_definition(CountryDefinition const& country);
 		CountryInstance const& get_country_instance_from_definition(CountryDefinition const& country) const;
 
@@ -332,6 +358,8 @@ namespace OpenVic {
 			decltype(CountryInstance::government_flag_overrides)::keys_t const& government_type_keys,
 			decltype(CountryInstance::unlocked_crimes)::keys_t const& crime_keys,
 			decltype(CountryInstance::pop_type_distribution)::keys_t const& pop_type_keys,
+			decltype(CountryInstance::culture_distribution)::keys_t const& culture_keys,
+			decltype(CountryInstance::religion_distribution)::keys_t const& religion_keys,
 			decltype(CountryInstance::unlocked_regiment_types)::keys_t const& unlocked_regiment_types_keys,
 			decltype(CountryInstance::unlocked_ship_types)::keys_t const& unlocked_ship_types_keys
 		);
@@ -341,7 +369,14 @@ namespace OpenVic {
 			MapInstance& map_instance
 		);
 
-		void update_gamestate(Date today, DefineManager const& define_manager, UnitTypeManager const& unit_type_manager);
+		/* Each CountryInstance only writes to its own attributes while updating, so the per-country updates are split
+		 * across the thread pool's threads, all of which finish before the rankings are updated. Only countries marked as
+		 * dirty are updated, but rankings are always recalculated. */
+		void update_gamestate(
+			Date today, DefineManager const& define_manager, UnitTypeManager const& unit_type_manager,
+			ThreadPool& thread_pool, Profiler& profiler
+		);
+		void mark_all_gamestate_dirty();
 		void tick();
 	};
 }
@@ -1,5 +1,8 @@
 #include "Dataloader.hpp"
 
+#include <chrono>
+#include <optional>
+
 #include <openvic-dataloader/csv/Parser.hpp>
 #include <openvic-dataloader/detail/CallbackOStream.hpp>
 #include <openvic-dataloader/v2script/Parser.hpp>
@@ -8,8 +11,11 @@
 #include <lexy-vdf/Parser.hpp>
 
 #include "openvic-simulation/DefinitionManager.hpp"
+#include "openvic-simulation/dataloader/DefinitionCache.hpp"
 #include "openvic-simulation/utility/Logger.hpp"
+#include "openvic-simulation/utility/MemoryMappedFile.hpp"
 #include "openvic-simulation/utility/StringUtils.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
 
 using namespace OpenVic;
 using namespace OpenVic::NodeTools;
@@ -17,10 +23,6 @@ using namespace ovdl;
 
 using StringUtils::append_string_views;
 
-#if defined(_WIN32) || (defined(__APPLE__) && defined(__MACH__))
-#define FILESYSTEM_CASE_INSENSITIVE
-#endif
-
 #if !defined(_WIN32)
 #define FILESYSTEM_NEEDS_FORWARD_SLASHES
 #endif
@@ -34,6 +36,23 @@ static fs::path ensure_forward_slash_path(std::string_view path) {
 #endif
 }
 
+/* Relative path with forward slashes and without leading, trailing or repeated slashes, as used for file index keys. */
+static std::string _normalise_relative_path(std::string_view path) {
+	std::string ret = fs::path {
+		StringUtils::make_forward_slash_path(StringUtils::remove_leading_slashes(path))
+	}.lexically_normal().generic_string();
+	while (!ret.empty() && ret.back() == '/') {
+		ret.pop_back();
+	}
+	return ret;
+}
+
+Dataloader::Dataloader() : parse_thread_count { 0 } {}
+
+void Dataloader::set_cache_directory(fs::path const& new_cache_directory) {
+	cache_directory = new_cache_directory;
+}
+
 bool Dataloader::set_roots(path_vector_t const& new_roots) {
 	if (!roots.empty()) {
 		Logger::warning("Overriding existing dataloader roots!");
@@ -58,39 +77,37 @@ bool Dataloader::set_roots(path_vector_t const& new_roots) {
 		Logger::error("Dataloader has no roots after attempting to add ", new_roots.size());
 		ret = false;
 	}
+	_index_root_files();
 	return ret;
 }
 
-fs::path Dataloader::lookup_file(std::string_view path, bool print_error) const {
-	const fs::path filepath { ensure_forward_slash_path(path) };
+void Dataloader::_index_root_files() {
+	root_files.clear();
+	file_index.clear();
 
-#if defined(FILESYSTEM_CASE_INSENSITIVE)
-	/* Case-insensitive filesystem */
+	size_t file_count = 0;
 	for (fs::path const& root : roots) {
-		const fs::path composed = root / filepath;
-		if (fs::is_regular_file(composed)) {
-			return composed;
-		}
-	}
-#else
-	/* Case-sensitive filesystem */
-	const std::string_view filename = StringUtils::get_filename(path);
-	for (fs::path const& root : roots) {
-		const fs::path composed = root / filepath;
-		if (fs::is_regular_file(composed)) {
-			return composed;
-		}
+		std::vector<indexed_file_t>& files = root_files.emplace_back();
 		std::error_code ec;
-		for (fs::directory_entry const& entry : fs::directory_iterator { composed.parent_path(), ec }) {
+		for (fs::directory_entry const& entry : fs::recursive_directory_iterator { root, ec }) {
 			if (entry.is_regular_file()) {
-				const fs::path file = entry;
-				if (StringUtils::strings_equal_case_insensitive(file.filename().string(), filename)) {
-					return file;
-				}
+				std::string relative_path = entry.path().lexically_relative(root).generic_string();
+				/* Earlier roots take precedence, so existing entries are never replaced. */
+				file_index.emplace(relative_path, entry.path());
+				files.push_back({ entry.path(), std::move(relative_path) });
 			}
 		}
+		file_count += files.size();
+	}
+
+	Logger::info("Indexed ", file_count, " files (", file_index.size(), " unique paths) under ", roots.size(), " root(s)");
+}
+
+fs::path Dataloader::lookup_file(std::string_view path, bool print_error) const {
+	const decltype(file_index)::const_iterator it = file_index.find(_normalise_relative_path(path));
+	if (it != file_index.end()) {
+		return it->second;
 	}
-#endif
 
 	if (print_error) {
 		Logger::error("Lookup for \"", path, "\" failed!");
@@ -109,41 +126,48 @@ fs::path Dataloader::lookup_image_file(std::string_view path) const {
 	return lookup_file(path);
 }
 
-template<typename _DirIterator, UniqueFileKey _UniqueKey>
+template<UniqueFileKey _UniqueKey>
 Dataloader::path_vector_t Dataloader::_lookup_files_in_dir(
-	std::string_view path, fs::path const& extension, _UniqueKey const& unique_key
+	std::string_view path, bool recursive, fs::path const& extension, _UniqueKey const& unique_key
 ) const {
-	const fs::path dirpath { ensure_forward_slash_path(path) };
+	std::string dirpath = _normalise_relative_path(path);
+	if (!dirpath.empty()) {
+		dirpath.push_back('/');
+	}
 	path_vector_t ret;
 	struct file_entry_t {
 		fs::path file;
 		fs::path const* root;
 	};
 	string_map_t<file_entry_t> found_files;
-	for (fs::path const& root : roots) {
-		const size_t root_len = root.string().size();
-		std::error_code ec;
-		for (fs::directory_entry const& entry : _DirIterator { root / dirpath, ec }) {
-			if (entry.is_regular_file()) {
-				fs::path file = entry;
-				if (extension.empty() || file.extension() == extension) {
-					const std::string full_path = file.string();
-					std::string_view relative_path = full_path;
-					relative_path.remove_prefix(root_len);
-					relative_path = StringUtils::remove_leading_slashes(relative_path);
-					const std::string_view key = unique_key(relative_path);
-					if (!key.empty()) {
-						const typename decltype(found_files)::const_iterator it = found_files.find(key);
-						if (it == found_files.end()) {
-							found_files.emplace(key, file_entry_t { file, &root });
-							ret.emplace_back(std::move(file));
-						} else if (it->second.root == &root) {
-							Logger::warning(
-								"Files under the same root with conflicting keys: ", it->first, " - ", it->second.file,
-								" (accepted) and ", key, " - ", file, " (rejected)"
-							);
-						}
-					}
+	std::string relative_path;
+	for (size_t root_index = 0; root_index < roots.size(); ++root_index) {
+		fs::path const& root = roots[root_index];
+		for (indexed_file_t const& indexed_file : root_files[root_index]) {
+			const std::string_view file_path = indexed_file.relative_path;
+			if (
+				file_path.size() <= dirpath.size() ||
+				!StringUtils::strings_equal_case_insensitive(file_path.substr(0, dirpath.size()), dirpath) ||
+				(!recursive && file_path.find('/', dirpath.size()) != std::string_view::npos) ||
+				(!extension.empty() && indexed_file.path.extension() != extension)
+			) {
+				continue;
+			}
+			/* The directory is written as it was requested, so files in differently cased copies of it under different
+			 * roots still get the same keys. */
+			relative_path = dirpath;
+			relative_path += file_path.substr(dirpath.size());
+			const std::string_view key = unique_key(relative_path);
+			if (!key.empty()) {
+				const typename decltype(found_files)::const_iterator it = found_files.find(key);
+				if (it == found_files.end()) {
+					found_files.emplace(key, file_entry_t { indexed_file.path, &root });
+					ret.push_back(indexed_file.path);
+				} else if (it->second.root == &root) {
+					Logger::warning(
+						"Files under the same root with conflicting keys: ", it->first, " - ", it->second.file,
+						" (accepted) and ", key, " - ", indexed_file.path, " (rejected)"
+					);
 				}
 			}
 		}
@@ -152,11 +176,11 @@ Dataloader::path_vector_t Dataloader::_lookup_files_in_dir(
 }
 
 Dataloader::path_vector_t Dataloader::lookup_files_in_dir(std::string_view path, fs::path const& extension) const {
-	return _lookup_files_in_dir<fs::directory_iterator>(path, extension, std::identity {});
+	return _lookup_files_in_dir(path, false, extension, std::identity {});
 }
 
 Dataloader::path_vector_t Dataloader::lookup_files_in_dir_recursive(std::string_view path, fs::path const& extension) const {
-	return _lookup_files_in_dir<fs::recursive_directory_iterator>(path, extension, std::identity {});
+	return _lookup_files_in_dir(path, true, extension, std::identity {});
 }
 
 static std::string_view _extract_basic_identifier_prefix_from_path(std::string_view path) {
@@ -166,13 +190,13 @@ static std::string_view _extract_basic_identifier_prefix_from_path(std::string_v
 Dataloader::path_vector_t Dataloader::lookup_basic_indentifier_prefixed_files_in_dir(
 	std::string_view path, fs::path const& extension
 ) const {
-	return _lookup_files_in_dir<fs::directory_iterator>(path, extension, _extract_basic_identifier_prefix_from_path);
+	return _lookup_files_in_dir(path, false, extension, _extract_basic_identifier_prefix_from_path);
 }
 
 Dataloader::path_vector_t Dataloader::lookup_basic_indentifier_prefixed_files_in_dir_recursive(
 	std::string_view path, fs::path const& extension
 ) const {
-	return _lookup_files_in_dir<fs::recursive_directory_iterator>(path, extension, _extract_basic_identifier_prefix_from_path);
+	return _lookup_files_in_dir(path, true, extension, _extract_basic_identifier_prefix_from_path);
 }
 
 bool Dataloader::apply_to_files(path_vector_t const& files, callback_t<fs::path const&> callback) const {
@@ -186,6 +210,36 @@ bool Dataloader::apply_to_files(path_vector_t const& files, callback_t<fs::path
 	return ret;
 }
 
+bool Dataloader::apply_to_parsed_files(
+	ThreadPool& thread_pool, path_vector_t const& files, callback_t<fs::path const&, v2script::Parser&> callback
+) const {
+	static constexpr size_t BATCH_FILES_PER_THREAD = 32;
+
+	const size_t batch_size = std::min(files.size(), thread_pool.get_thread_count() * BATCH_FILES_PER_THREAD);
+	std::vector<std::optional<v2script::Parser>> parsers(batch_size);
+
+	bool ret = true;
+	for (size_t batch_begin = 0; batch_begin < files.size(); batch_begin += batch_size) {
+		const size_t batch_count = std::min(batch_size, files.size() - batch_begin);
+
+		thread_pool.parallel_for(batch_count, [&files, &parsers, batch_begin](size_t begin, size_t end) -> void {
+			for (size_t index = begin; index < end; ++index) {
+				parsers[index].emplace(parse_defines(files[batch_begin + index]));
+			}
+		});
+
+		for (size_t index = 0; index < batch_count; ++index) {
+			fs::path const& file = files[batch_begin + index];
+			if (!callback(file, *parsers[index])) {
+				Logger::error("Callback failed for file: ", file);
+				ret = false;
+			}
+			parsers[index].reset();
+		}
+	}
+	return ret;
+}
+
 string_set_t Dataloader::lookup_dirs_in_dir(std::string_view path) const {
 	const fs::path dirpath { ensure_forward_slash_path(path) };
 	string_set_t ret;
@@ -264,7 +318,11 @@ csv::Parser Dataloader::parse_csv(fs::path const& path) {
 }
 
 v2script::Parser& Dataloader::parse_defines_cached(fs::path const& path) {
-	return cached_parsers.emplace_back(parse_defines(path));
+	return cache_parser(parse_defines(path));
+}
+
+v2script::Parser& Dataloader::cache_parser(v2script::Parser&& parser) {
+	return cached_parsers.emplace_back(std::move(parser));
 }
 
 void Dataloader::free_cache() {
@@ -489,15 +547,15 @@ bool Dataloader::_load_inventions(DefinitionManager& definition_manager) {
 	return ret;
 }
 
-bool Dataloader::_load_decisions(DefinitionManager& definition_manager) {
+bool Dataloader::_load_decisions(DefinitionManager& definition_manager, ThreadPool& thread_pool) {
 	static constexpr std::string_view decisions_directory = "decisions";
 
 	DecisionManager& decision_manager = definition_manager.get_decision_manager();
 
-	bool ret = apply_to_files(
-		lookup_files_in_dir(decisions_directory, ".txt"),
-		[this, &decision_manager](fs::path const& file) -> bool {
-			return decision_manager.load_decision_file(parse_defines_cached(file).get_file_node());
+	bool ret = apply_to_parsed_files(
+		thread_pool, lookup_files_in_dir(decisions_directory, ".txt"),
+		[this, &decision_manager](fs::path const& file, v2script::Parser& parser) -> bool {
+			return decision_manager.load_decision_file(cache_parser(std::move(parser)).get_file_node());
 		}
 	);
 
@@ -506,7 +564,9 @@ bool Dataloader::_load_decisions(DefinitionManager& definition_manager) {
 	return ret;
 }
 
-bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unused_history_file_warnings) const {
+bool Dataloader::_load_history(
+	DefinitionManager& definition_manager, ThreadPool& thread_pool, bool unused_history_file_warnings
+) const {
 
 	bool ret = true;
 
@@ -514,39 +574,54 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 		/* Country History */
 		CountryHistoryManager& country_history_manager = definition_manager.get_history_manager().get_country_manager();
 		DeploymentManager& deployment_manager = definition_manager.get_military_manager().get_deployment_manager();
+		CountryDefinitionManager const& country_definition_manager = definition_manager.get_country_definition_manager();
+
+		const auto get_file_country = [&country_definition_manager](fs::path const& file) -> CountryDefinition const* {
+			const std::string filename = file.stem().string();
+			return country_definition_manager.get_country_definition_by_identifier(
+				extract_basic_identifier_prefix(filename)
+			);
+		};
 
 		static constexpr std::string_view country_history_directory = "history/countries";
-		const path_vector_t country_history_files =
+		path_vector_t country_history_files =
 			lookup_basic_indentifier_prefixed_files_in_dir(country_history_directory, ".txt");
 
+		/* Files for non-existent countries are removed before parsing so that they're never parsed. */
+		std::erase_if(country_history_files, [&get_file_country, unused_history_file_warnings](fs::path const& file) -> bool {
+			if (get_file_country(file) == nullptr) {
+				if (unused_history_file_warnings) {
+					const std::string filename = file.stem().string();
+					Logger::warning(
+						"Found history file for non-existent country: ", extract_basic_identifier_prefix(filename)
+					);
+				}
+				return true;
+			}
+			return false;
+		});
+
 		country_history_manager.reserve_more_country_histories(country_history_files.size());
 		deployment_manager.reserve_more_deployments(country_history_files.size());
 
-		ret &= apply_to_files(
-			country_history_files,
-			[this, &definition_manager, &country_history_manager, unused_history_file_warnings](fs::path const& file) -> bool {
-				const std::string filename = file.stem().string();
-				const std::string_view country_id = extract_basic_identifier_prefix(filename);
-
-				CountryDefinition const* country =
-					definition_manager.get_country_definition_manager().get_country_definition_by_identifier(country_id);
-				if (country == nullptr) {
-					if (unused_history_file_warnings) {
-						Logger::warning("Found history file for non-existent country: ", country_id);
-					}
-					return true;
-				}
-
+		ret &= apply_to_parsed_files(
+			thread_pool, country_history_files,
+			[this, &definition_manager, &country_history_manager, &get_file_country](
+				fs::path const& file, v2script::Parser& parser
+			) -> bool {
 				return country_history_manager.load_country_history_file(
-					definition_manager, *this, *country,
+					definition_manager, *this, *get_file_country(file),
 					definition_manager.get_politics_manager().get_ideology_manager().get_ideologies(),
 					definition_manager.get_politics_manager().get_government_type_manager().get_government_types(),
-					parse_defines(file).get_file_node()
+					parser.get_file_node()
 				);
 			}
 		);
 
 		country_history_manager.lock_country_histories();
+		ret &= country_history_manager.build_bookmark_snapshots(
+			definition_manager.get_history_manager().get_bookmark_manager(), thread_pool
+		);
 		deployment_manager.lock_deployments();
 
 		if (deployment_manager.get_missing_oob_file_count() > 0) {
@@ -559,30 +634,37 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 		ProvinceHistoryManager& province_history_manager = definition_manager.get_history_manager().get_province_manager();
 		MapDefinition const& map_definition = definition_manager.get_map_definition();
 
+		const auto get_file_province = [&map_definition](fs::path const& file) -> ProvinceDefinition const* {
+			const std::string filename = file.stem().string();
+			return map_definition.get_province_definition_by_identifier(extract_basic_identifier_prefix(filename));
+		};
+
 		static constexpr std::string_view province_history_directory = "history/provinces";
-		const path_vector_t province_history_files =
+		path_vector_t province_history_files =
 			lookup_basic_indentifier_prefixed_files_in_dir_recursive(province_history_directory, ".txt");
 
+		std::erase_if(province_history_files, [&get_file_province, unused_history_file_warnings](fs::path const& file) -> bool {
+			if (get_file_province(file) == nullptr) {
+				if (unused_history_file_warnings) {
+					const std::string filename = file.stem().string();
+					Logger::warning(
+						"Found history file for non-existent province: ", extract_basic_identifier_prefix(filename)
+					);
+				}
+				return true;
+			}
+			return false;
+		});
+
 		province_history_manager.reserve_more_province_histories(province_history_files.size());
 
-		ret &= apply_to_files(
-			province_history_files,
-			[this, &definition_manager, &province_history_manager, &map_definition, unused_history_file_warnings](
-				fs::path const& file
+		ret &= apply_to_parsed_files(
+			thread_pool, province_history_files,
+			[&definition_manager, &province_history_manager, &get_file_province](
+				fs::path const& file, v2script::Parser& parser
 			) -> bool {
-				const std::string filename = file.stem().string();
-				const std::string_view province_id = extract_basic_identifier_prefix(filename);
-
-				ProvinceDefinition const* province = map_definition.get_province_definition_by_identifier(province_id);
-				if (province == nullptr) {
-					if (unused_history_file_warnings) {
-						Logger::warning("Found history file for non-existent province: ", province_id);
-					}
-					return true;
-				}
-
 				return province_history_manager.load_province_history_file(
-					definition_manager, *province, parse_defines(file).get_file_node()
+					definition_manager, *get_file_province(file), parser.get_file_node()
 				);
 			}
 		);
@@ -601,13 +683,13 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 			if (successful && date <= last_bookmark_date) {
 				bool non_integer_size = false;
 
-				ret &= apply_to_files(
-					lookup_files_in_dir(StringUtils::append_string_views(pop_history_directory, dir), ".txt"),
-					[this, &definition_manager, &province_history_manager, date, &non_integer_size](
-						fs::path const& file
+				ret &= apply_to_parsed_files(
+					thread_pool, lookup_files_in_dir(StringUtils::append_string_views(pop_history_directory, dir), ".txt"),
+					[&definition_manager, &province_history_manager, date, &non_integer_size](
+						fs::path const& file, v2script::Parser& parser
 					) -> bool {
 						return province_history_manager.load_pop_history_file(
-							definition_manager, date, parse_defines(file).get_file_node(), &non_integer_size
+							definition_manager, date, parser.get_file_node(), &non_integer_size
 						);
 					}
 				);
@@ -619,6 +701,9 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 		}
 
 		province_history_manager.lock_province_histories(map_definition, false);
+		ret &= province_history_manager.build_bookmark_snapshots(
+			definition_manager.get_history_manager().get_bookmark_manager(), thread_pool
+		);
 	}
 
 	{
@@ -628,11 +713,11 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 
 		static constexpr std::string_view diplomacy_history_directory = "history/diplomacy";
 
-		ret &= apply_to_files(
-			lookup_files_in_dir(diplomacy_history_directory, ".txt"),
-			[this, &definition_manager, &diplomatic_history_manager](fs::path const& file) -> bool {
+		ret &= apply_to_parsed_files(
+			thread_pool, lookup_files_in_dir(diplomacy_history_directory, ".txt"),
+			[&definition_manager, &diplomatic_history_manager](fs::path const& file, v2script::Parser& parser) -> bool {
 				return diplomatic_history_manager.load_diplomacy_history_file(
-					definition_manager.get_country_definition_manager(), parse_defines(file).get_file_node()
+					definition_manager.get_country_definition_manager(), parser.get_file_node()
 				);
 			}
 		);
@@ -643,12 +728,10 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 
 		diplomatic_history_manager.reserve_more_wars(war_history_files.size());
 
-		ret &= apply_to_files(
-			war_history_files,
-			[this, &definition_manager, &diplomatic_history_manager](fs::path const& file) -> bool {
-				return diplomatic_history_manager.load_war_history_file(
-					definition_manager, parse_defines(file).get_file_node()
-				);
+		ret &= apply_to_parsed_files(
+			thread_pool, war_history_files,
+			[&definition_manager, &diplomatic_history_manager](fs::path const& file, v2script::Parser& parser) -> bool {
+				return diplomatic_history_manager.load_war_history_file(definition_manager, parser.get_file_node());
 			}
 		);
 
@@ -658,14 +741,15 @@ bool Dataloader::_load_history(DefinitionManager& definition_manager, bool unuse
 	return ret;
 }
 
-bool Dataloader::_load_events(DefinitionManager& definition_manager) {
+bool Dataloader::_load_events(DefinitionManager& definition_manager, ThreadPool& thread_pool) {
 	static constexpr std::string_view events_directory = "events";
 
-	const bool ret = apply_to_files(
-		lookup_files_in_dir(events_directory, ".txt"),
-		[this, &definition_manager](fs::path const& file) -> bool {
+	const bool ret = apply_to_parsed_files(
+		thread_pool, lookup_files_in_dir(events_directory, ".txt"),
+		[this, &definition_manager](fs::path const& file, v2script::Parser& parser) -> bool {
 			return definition_manager.get_event_manager().load_event_file(
-				definition_manager.get_politics_manager().get_issue_manager(), parse_defines_cached(file).get_file_node()
+				definition_manager.get_politics_manager().get_issue_manager(),
+				cache_parser(std::move(parser)).get_file_node()
 			);
 		}
 	);
@@ -674,7 +758,7 @@ bool Dataloader::_load_events(DefinitionManager& definition_manager) {
 	return ret;
 }
 
-bool Dataloader::_load_map_dir(DefinitionManager& definition_manager) const {
+bool Dataloader::_load_map_dir(DefinitionManager& definition_manager, ThreadPool& thread_pool) const {
 	static constexpr std::string_view map_directory = "map/";
 	MapDefinition& map_definition = definition_manager.get_map_definition();
 
@@ -779,10 +863,16 @@ bool Dataloader::_load_map_dir(DefinitionManager& definition_manager) const {
 		ret = false;
 	}
 
-	if (!map_definition.load_map_images(
+	if (!_load_map_images(
+		map_definition,
 		lookup_file(append_string_views(map_directory, provinces)),
 		lookup_file(append_string_views(map_directory, terrain)),
-		lookup_file(append_string_views(map_directory, rivers)), false
+		lookup_file(append_string_views(map_directory, rivers)),
+		{
+			lookup_file(append_string_views(map_directory, definitions)),
+			lookup_file(append_string_views(map_directory, terrain_definition))
+		},
+		thread_pool
 	)) {
 		Logger::error("Failed to load map images!");
 		ret = false;
@@ -825,6 +915,55 @@ bool Dataloader::_load_map_dir(DefinitionManager& definition_manager) const {
 	return ret;
 }
 
+bool Dataloader::_load_map_images(
+	MapDefinition& map_definition, fs::path const& province_path, fs::path const& terrain_path, fs::path const& rivers_path,
+	path_vector_t const& other_source_files, ThreadPool& thread_pool
+) const {
+	static constexpr std::string_view map_images_cache_filename = "map_images.bin";
+
+	using clock_t = std::chrono::steady_clock;
+	const clock_t::time_point start = clock_t::now();
+	const auto get_elapsed_ms = [start]() -> int64_t {
+		return std::chrono::duration_cast<std::chrono::milliseconds>(clock_t::now() - start).count();
+	};
+
+	path_vector_t source_files { province_path, terrain_path, rivers_path };
+	source_files.insert(source_files.end(), other_source_files.begin(), other_source_files.end());
+
+	DefinitionCache::hash_t source_hash = 0;
+	const bool use_cache = !cache_directory.empty() && DefinitionCache::hash_files(source_files, source_hash);
+	const fs::path cache_path = cache_directory / map_images_cache_filename;
+
+	if (use_cache) {
+		MemoryMappedFile cache_file;
+		std::span<const uint8_t> payload;
+		if (DefinitionCache::read_cache_file(cache_path, source_hash, cache_file, payload)) {
+			DefinitionCache::Reader reader { payload };
+			if (map_definition.read_map_images_cache(reader, false)) {
+				Logger::info("Restored map images from cache in ", get_elapsed_ms(), "ms");
+				return true;
+			}
+			Logger::warning("Failed to restore map images from cache, regenerating them!");
+		}
+	}
+
+	if (!map_definition.load_map_images(province_path, terrain_path, rivers_path, thread_pool, false)) {
+		return false;
+	}
+	Logger::info("Generated map images in ", get_elapsed_ms(), "ms");
+
+	if (use_cache) {
+		DefinitionCache::Writer writer;
+		map_definition.write_map_images_cache(writer);
+		if (!DefinitionCache::write_cache_file(cache_path, source_hash, writer.get_data())) {
+			/* The map images were still loaded successfully, so this isn't a loading failure. */
+			Logger::warning("Failed to cache map images!");
+		}
+	}
+
+	return true;
+}
+
 bool Dataloader::_load_song_chances(DefinitionManager& definition_manager) {
 	static constexpr std::string_view song_chance_file = "music/songs.txt";
 	const fs::path path = lookup_file(song_chance_file, false);
@@ -890,6 +1029,10 @@ bool Dataloader::load_defines(DefinitionManager& definition_manager) {
 
 	bool ret = true;
 
+	/* Used for parsing the large directories of history, event and decision files, and for the map image pixel pass. */
+	ThreadPool thread_pool { parse_thread_count };
+	Logger::info("Dataloader using ", thread_pool.get_thread_count(), " thread(s) for parsing and map images.");
+
 	if (!definition_manager.get_mapmode_manager().setup_mapmodes()) {
 		Logger::error("Failed to set up mapmodes!");
 		ret = false;
@@ -952,7 +1095,7 @@ bool Dataloader::load_defines(DefinitionManager& definition_manager) {
 		Logger::error("Failed to load buildings!");
 		ret = false;
 	}
-	if (!_load_map_dir(definition_manager)) {
+	if (!_load_map_dir(definition_manager, thread_pool)) {
 		Logger::error("Failed to load map!");
 		ret = false;
 	}
@@ -1067,15 +1210,15 @@ bool Dataloader::load_defines(DefinitionManager& definition_manager) {
 		Logger::error("Failed to load cultures!");
 		ret = false;
 	}
-	if (!_load_decisions(definition_manager)) {
+	if (!_load_decisions(definition_manager, thread_pool)) {
 		Logger::error("Failde to load decisions!");
 		ret = false;
 	}
-	if (!_load_history(definition_manager, false)) {
+	if (!_load_history(definition_manager, thread_pool, false)) {
 		Logger::error("Failed to load history!");
 		ret = false;
 	}
-	if (!_load_events(definition_manager)) {
+	if (!_load_events(definition_manager, thread_pool)) {
 		Logger::error("Failed to load events!");
 		ret = false;
 	}
@@ -9,6 +9,8 @@ namespace OpenVic {
 	namespace fs = std::filesystem;
 
 	struct DefinitionManager;
+	struct MapDefinition;
+	struct ThreadPool;
 	class UIManager;
 
 	template<typename _UniqueFileKey>
@@ -22,7 +24,25 @@ namespace OpenVic {
 
 	private:
 		path_vector_t PROPERTY(roots);
+
+		struct indexed_file_t {
+			fs::path path;
+			/* Relative to the file's root, in its original case, with forward slashes. */
+			std::string relative_path;
+		};
+		/* Every file under each root, in the same order as roots and in directory iteration order within each root. */
+		std::vector<std::vector<indexed_file_t>> root_files;
+		/* Case-insensitive relative path to the file with that path under the earliest root with one. */
+		case_insensitive_string_map_t<fs::path> file_index;
+
+		/* Builds root_files and file_index, so that file lookups never need to touch the filesystem. */
+		void _index_root_files();
 		std::vector<ovdl::v2script::Parser> cached_parsers;
+		/* Number of threads used to parse files and generate map images while loading defines, 0 meaning all available
+		 * hardware threads. */
+		size_t PROPERTY_RW(parse_thread_count);
+		/* Directory in which DefinitionCache files are read and written, with caching disabled if this is empty. */
+		fs::path PROPERTY(cache_directory);
 
 		bool _load_interface_files(UIManager& ui_manager) const;
 		bool _load_pop_types(DefinitionManager& definition_manager);
@@ -31,19 +51,27 @@ namespace OpenVic {
 		bool _load_rebel_types(DefinitionManager& definition_manager);
 		bool _load_technologies(DefinitionManager& definition_manager);
 		bool _load_inventions(DefinitionManager& definition_manager);
-		bool _load_events(DefinitionManager& definition_manager);
-		bool _load_map_dir(DefinitionManager& definition_manager) const;
+		bool _load_events(DefinitionManager& definition_manager, ThreadPool& thread_pool);
+		bool _load_map_dir(DefinitionManager& definition_manager, ThreadPool& thread_pool) const;
+		/* Restores the map images from the cache if it was generated from the same source files, otherwise generates them
+		 * with MapDefinition::load_map_images and updates the cache. */
+		bool _load_map_images(
+			MapDefinition& map_definition, fs::path const& province_path, fs::path const& terrain_path,
+			fs::path const& rivers_path, path_vector_t const& other_source_files, ThreadPool& thread_pool
+		) const;
 		bool _load_song_chances(DefinitionManager& definition_manager);
 		bool _load_sound_effect_defines(DefinitionManager& definition_manager) const;
-		bool _load_decisions(DefinitionManager& definition_manager);
-		bool _load_history(DefinitionManager& definition_manager, bool unused_history_file_warnings) const;
+		bool _load_decisions(DefinitionManager& definition_manager, ThreadPool& thread_pool);
+		bool _load_history(
+			DefinitionManager& definition_manager, ThreadPool& thread_pool, bool unused_history_file_warnings
+		) const;
 
-		/* _DirIterator is fs::directory_iterator or fs::recursive_directory_iterator. _UniqueKey is the type of a callable
-		 * which converts a string_view filepath with root removed into a string_view unique key. Any path whose key is empty
-		 * or matches an earlier found path's key is discarded, ensuring each looked up path's key is non-empty and unique. */
-		template<typename _DirIterator, UniqueFileKey _UniqueKey>
+		/* If recursive is false only files directly in the directory are found. _UniqueKey is the type of a callable which
+		 * converts a string_view filepath with root removed into a string_view unique key. Any path whose key is empty or
+		 * matches an earlier found path's key is discarded, ensuring each looked up path's key is non-empty and unique. */
+		template<UniqueFileKey _UniqueKey>
 		path_vector_t _lookup_files_in_dir(
-			std::string_view path, fs::path const& extension, _UniqueKey const& unique_key
+			std::string_view path, bool recursive, fs::path const& extension, _UniqueKey const& unique_key
 		) const;
 
 	public:
@@ -55,6 +83,8 @@ namespace OpenVic {
 		 * script Nodes until all defines are loaded and the scripts can be parsed. The reference returned by this function
 		 * is only guaranteed to be valid until the function is next called. */
 		ovdl::v2script::Parser& parse_defines_cached(fs::path const& path);
+		/* Cache an already parsed Parser, as with parse_defines_cached. */
+		ovdl::v2script::Parser& cache_parser(ovdl::v2script::Parser&& parser);
 
 	private:
 		/* Clear the cache vector, freeing all cached Parsers and their Node trees. Pointers to cached Parsers' Nodes should
@@ -62,7 +92,7 @@ namespace OpenVic {
 		void free_cache();
 
 	public:
-		Dataloader() = default;
+		Dataloader();
 
 		/// @brief Searches for the Victoria 2 install directory
 		///
@@ -86,12 +116,15 @@ namespace OpenVic {
 		///
 		static fs::path search_for_game_path(fs::path hint_path = {});
 
-		/* In reverse-load order, so base defines first and final loaded mod last */
+		void set_cache_directory(fs::path const& new_cache_directory);
+
+		/* In reverse-load order, so base defines first and final loaded mod last. Every file under the roots is indexed,
+		 * so files added to them afterwards won't be found by lookups. */
 		bool set_roots(path_vector_t const& new_roots);
 
 		/* REQUIREMENTS:
 		 * DAT-24
-		 */
+		 * Paths are matched case-insensitively, regardless of the filesystem's case sensitivity. */
 		fs::path lookup_file(std::string_view path, bool print_error = true) const;
 		/* If the path ends with the extension ".tga", then this function will first try to load the file with the extension
 		 * replaced with ".dds", and if that fails it will try the original ".tga" version. Paths not ending with ".tga" will
@@ -104,6 +137,14 @@ namespace OpenVic {
 			std::string_view path, fs::path const& extension
 		) const;
 		bool apply_to_files(path_vector_t const& files, NodeTools::callback_t<fs::path const&> callback) const;
+		/* Parses the files with parse_defines on every thread of thread_pool, then calls callback with each file and its
+		 * Parser on the calling thread, in the same order as the files. Callbacks can therefore modify registries exactly
+		 * as with apply_to_files, while the tokenising and AST building is spread across threads. Files are handled in
+		 * batches so only a limited number of Node trees are held in memory at once. */
+		bool apply_to_parsed_files(
+			ThreadPool& thread_pool, path_vector_t const& files,
+			NodeTools::callback_t<fs::path const&, ovdl::v2script::Parser&> callback
+		) const;
 
 		string_set_t lookup_dirs_in_dir(std::string_view path) const;
 
@@ -0,0 +1,136 @@
+#include "DefinitionCache.hpp"
+
+#include <bit>
+#include <cstring>
+#include <fstream>
+
+#include "openvic-simulation/utility/Logger.hpp"
+#include "openvic-simulation/utility/MemoryMappedFile.hpp"
+
+using namespace OpenVic;
+
+DefinitionCache::hash_t DefinitionCache::hash_bytes(std::span<const uint8_t> bytes, hash_t hash) {
+	const auto mix = [&hash](uint64_t word) -> void {
+		hash = std::rotl(hash ^ (word * HASH_PRIME_1), 31) * HASH_PRIME_2;
+	};
+
+	size_t offset = 0;
+	for (; bytes.size() - offset >= sizeof(uint64_t); offset += sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, bytes.data() + offset, sizeof(word));
+		mix(word);
+	}
+	/* The last few bytes are zero padded into one final word. */
+	if (offset < bytes.size()) {
+		uint64_t word = 0;
+		std::memcpy(&word, bytes.data() + offset, bytes.size() - offset);
+		mix(word);
+	}
+	/* Including the size means inputs differing only by trailing zero bytes have different hashes. */
+	mix(bytes.size());
+
+	return hash;
+}
+
+bool DefinitionCache::hash_files(std::span<const fs::path> files, hash_t& hash) {
+	hash = HASH_SEED;
+	hash = hash_bytes({ reinterpret_cast<uint8_t const*>(&FORMAT_VERSION), sizeof(FORMAT_VERSION) }, hash);
+
+	for (fs::path const& file : files) {
+		MemoryMappedFile mapped_file;
+		if (!mapped_file.open(file)) {
+			Logger::error("Failed to open file for definition cache hashing: ", file);
+			return false;
+		}
+
+		/* The path is included so that swapping the contents of two source files still changes the hash. */
+		const std::string path = file.generic_string();
+		hash = hash_bytes({ reinterpret_cast<uint8_t const*>(path.data()), path.size() }, hash);
+		hash = hash_bytes(mapped_file.get_data(), hash);
+	}
+	return true;
+}
+
+void DefinitionCache::Writer::write_string(std::string_view string) {
+	write<uint64_t>(string.size());
+	data.insert(data.end(), string.begin(), string.end());
+}
+
+bool DefinitionCache::Reader::read_string(std::string& string) {
+	uint64_t size = 0;
+	if (!read(size) || data.size() - position < size) {
+		return false;
+	}
+	string.assign(reinterpret_cast<char const*>(data.data() + position), size);
+	position += size;
+	return true;
+}
+
+bool DefinitionCache::read_cache_file(
+	fs::path const& path, hash_t source_hash, MemoryMappedFile& file, std::span<const uint8_t>& payload
+) {
+	std::error_code ec;
+	if (!fs::is_regular_file(path, ec) || !file.open(path)) {
+		return false;
+	}
+
+	header_t header;
+	if (file.get_size() < sizeof(header)) {
+		Logger::error("Invalid definition cache file header: ", path);
+		return false;
+	}
+	std::memcpy(&header, file.get_data().data(), sizeof(header));
+	if (header.magic != MAGIC) {
+		Logger::error("Invalid definition cache file header: ", path);
+		return false;
+	}
+	if (header.format_version != FORMAT_VERSION || header.source_hash != source_hash) {
+		Logger::info("Definition cache file is out of date: ", path);
+		return false;
+	}
+
+	if (file.get_size() - sizeof(header) != header.payload_size) {
+		Logger::error("Definition cache file has the wrong size: ", path);
+		return false;
+	}
+	const std::span<const uint8_t> file_payload = file.get_data().subspan(sizeof(header));
+	if (hash_bytes(file_payload) != header.payload_hash) {
+		Logger::error("Definition cache file checksum mismatch: ", path);
+		return false;
+	}
+
+	payload = file_payload;
+	return true;
+}
+
+bool DefinitionCache::write_cache_file(fs::path const& path, hash_t source_hash, std::span<const uint8_t> payload) {
+	std::error_code ec;
+	fs::create_directories(path.parent_path(), ec);
+
+	/* Written to a temporary file first, so a partially written cache is never read. */
+	fs::path temporary_path = path;
+	temporary_path += ".tmp";
+
+	{
+		std::ofstream stream { temporary_path, std::ios::binary | std::ios::trunc };
+		if (!stream.is_open()) {
+			Logger::error("Failed to open definition cache file for writing: ", temporary_path);
+			return false;
+		}
+
+		const header_t header { MAGIC, FORMAT_VERSION, source_hash, payload.size(), hash_bytes(payload) };
+		stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		stream.write(reinterpret_cast<char const*>(payload.data()), payload.size());
+		if (!stream) {
+			Logger::error("Failed to write definition cache file: ", temporary_path);
+			return false;
+		}
+	}
+
+	fs::rename(temporary_path, path, ec);
+	if (ec) {
+		Logger::error("Failed to move definition cache file into place: ", path, " (", ec.message(), ")");
+		return false;
+	}
+	return true;
+}
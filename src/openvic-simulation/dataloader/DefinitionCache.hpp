@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace OpenVic {
+	namespace fs = std::filesystem;
+
+	struct MemoryMappedFile;
+
+	/* Versioned, checksummed binary files storing the results of slow definition loading steps, so that later launches
+	 * can restore them directly instead of recomputing them from the source files. Each cache file is keyed by a hash of
+	 * the path and contents of every source file its data was generated from, along with FORMAT_VERSION, so any change to
+	 * those files or to the cache layout makes the cache file stale and it is regenerated. File sizes and write times
+	 * aren't trusted instead, as copies and archive extraction can replace a file while preserving both. Data is stored
+	 * in native byte order, as cache files are local to the machine which wrote them. */
+	struct DefinitionCache {
+		using hash_t = uint64_t;
+
+		/* Increment whenever the layout of any cached data changes. */
+		static constexpr uint32_t FORMAT_VERSION = 2;
+
+		/* Mixes in a 64-bit word at a time, for checksumming payloads of hundreds of megabytes. */
+		static hash_t hash_bytes(std::span<const uint8_t> bytes, hash_t hash = HASH_SEED);
+		/* Combines the path and contents of every file into a single hash, returning false if any of them can't be read. */
+		static bool hash_files(std::span<const fs::path> files, hash_t& hash);
+
+		struct Writer {
+		private:
+			std::vector<uint8_t> data;
+
+		public:
+			constexpr std::vector<uint8_t> const& get_data() const {
+				return data;
+			}
+
+			template<typename T>
+			requires(std::is_trivially_copyable_v<T>)
+			void write(T const& value) {
+				const size_t offset = data.size();
+				data.resize(offset + sizeof(T));
+				std::memcpy(data.data() + offset, &value, sizeof(T));
+			}
+
+			template<typename T>
+			requires(std::is_trivially_copyable_v<T>)
+			void write_vector(std::vector<T> const& values) {
+				write<uint64_t>(values.size());
+				const size_t offset = data.size();
+				data.resize(offset + values.size() * sizeof(T));
+				std::memcpy(data.data() + offset, values.data(), values.size() * sizeof(T));
+			}
+
+			void write_string(std::string_view string);
+		};
+
+		/* Every read returns false, leaving the output unchanged, if there isn't enough data left. */
+		struct Reader {
+		private:
+			std::span<const uint8_t> data;
+			size_t position;
+
+		public:
+			constexpr Reader(std::span<const uint8_t> new_data) : data { new_data }, position { 0 } {}
+
+			constexpr bool is_at_end() const {
+				return position == data.size();
+			}
+
+			template<typename T>
+			requires(std::is_trivially_copyable_v<T>)
+			bool read(T& value) {
+				if (data.size() - position < sizeof(T)) {
+					return false;
+				}
+				std::memcpy(&value, data.data() + position, sizeof(T));
+				position += sizeof(T);
+				return true;
+			}
+
+			template<typename T>
+			requires(std::is_trivially_copyable_v<T>)
+			bool read_vector(std::vector<T>& values) {
+				uint64_t count = 0;
+				if (!read(count) || (data.size() - position) / sizeof(T) < count) {
+					return false;
+				}
+				values.resize(count);
+				std::memcpy(values.data(), data.data() + position, count * sizeof(T));
+				position += count * sizeof(T);
+				return true;
+			}
+
+			bool read_string(std::string& string);
+		};
+
+		/* Maps the file into memory and sets payload to point into it, so payload is only valid while file stays open.
+		 * Returns false, without logging an error, if the file doesn't exist or was written for a different source_hash,
+		 * and logs an error if it exists but is corrupt. */
+		static bool read_cache_file(
+			fs::path const& path, hash_t source_hash, MemoryMappedFile& file, std::span<const uint8_t>& payload
+		);
+		static bool write_cache_file(fs::path const& path, hash_t source_hash, std::span<const uint8_t> payload);
+
+	private:
+		static constexpr hash_t HASH_SEED = 0xCBF29CE484222325;
+		static constexpr hash_t HASH_PRIME_1 = 0x9E3779B185EBCA87;
+		static constexpr hash_t HASH_PRIME_2 = 0xC2B2AE3D27D4EB4F;
+		/* "OVDC" */
+		static constexpr uint32_t MAGIC = 0x4344564F;
+
+		struct header_t {
+			uint32_t magic;
+			uint32_t format_version;
+			hash_t source_hash;
+			uint64_t payload_size;
+			hash_t payload_hash;
+		};
+	};
+}
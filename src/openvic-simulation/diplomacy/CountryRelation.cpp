@@ -1,54 +1,104 @@
 #include "CountryRelation.hpp"
 
-#include <cassert>
+#include <algorithm>
 
 #include "openvic-simulation/country/CountryDefinition.hpp"
 #include "openvic-simulation/country/CountryInstance.hpp"
 #include "openvic-simulation/utility/ErrorMacros.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
 
 using namespace OpenVic;
 
-CountryRelationInstanceProxy::CountryRelationInstanceProxy(std::string_view id) : country_id { id } {}
+CountryRelationInstanceProxy::CountryRelationInstanceProxy(size_t index) : country_index { index } {}
+
+CountryRelationInstanceProxy::CountryRelationInstanceProxy(CountryInstance const& country)
+	: country_index { country.get_country_definition()->get_index() } {}
 
 CountryRelationInstanceProxy::CountryRelationInstanceProxy(CountryInstance const* country)
-	: country_id { country->get_country_definition()->get_identifier() } {}
+	: CountryRelationInstanceProxy { *country } {}
+
+CountryRelationInstanceProxy::operator size_t() const {
+	return country_index;
+}
+
+CountryRelationManager::CountryRelationManager() {}
+
+bool CountryRelationManager::setup(CountryInstanceManager const& country_instance_manager) {
+	const size_t country_count = country_instance_manager.get_country_instance_count();
+
+	country_relations.assign(_get_relation_count(country_count), 0);
+	countries_present.assign(country_count, true);
+
+	return true;
+}
 
-CountryRelationInstanceProxy::operator std::string_view() const {
-	return country_id;
+bool CountryRelationManager::is_country_present(CountryRelationInstanceProxy country) const {
+	return country.country_index < countries_present.size() && countries_present[country.country_index];
 }
 
-CountryRelationManager::CountryRelationManager(/* TODO: Country Instance Manager Reference */) {}
+bool CountryRelationManager::_is_valid_pair(size_t country, size_t recepient) const {
+	OV_ERR_FAIL_COND_V(country == recepient, false);
+	OV_ERR_FAIL_COND_V(!is_country_present(country), false);
+	OV_ERR_FAIL_COND_V(!is_country_present(recepient), false);
+	return true;
+}
 
 bool CountryRelationManager::add_country(CountryRelationInstanceProxy country) {
-	// TODO: iterate through Country Instances adding country to every previously existing country_relations
+	const size_t index = country.country_index;
+
+	if (index >= countries_present.size()) {
+		countries_present.resize(index + 1, false);
+		country_relations.resize(_get_relation_count(countries_present.size()), 0);
+	} else if (countries_present[index]) {
+		Logger::error("Cannot add country with index ", index, " to relations - already present!");
+		return false;
+	}
+
+	countries_present[index] = true;
 	return true;
 }
 
 bool CountryRelationManager::remove_country(CountryRelationInstanceProxy country) {
-	// TODO: iterate through country_relations removing every pair that references the country's id
+	const size_t index = country.country_index;
+
+	if (!is_country_present(index)) {
+		Logger::error("Cannot remove country with index ", index, " from relations - not present!");
+		return false;
+	}
+
+	country_relation_value_t* row = country_relations.data() + _get_relation_index(index, 0);
+	std::fill_n(row, index, 0);
+	for (size_t recepient = index + 1; recepient < countries_present.size(); ++recepient) {
+		country_relations[_get_relation_index(recepient, index)] = 0;
+	}
+
+	countries_present[index] = false;
 	return true;
 }
 
 country_relation_value_t CountryRelationManager::get_country_relation(
 	CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient
 ) const {
-	auto it = country_relations.find({ country.country_id, recepient.country_id });
-	OV_ERR_FAIL_COND_V(it == country_relations.end(), 0);
-	return it->second;
+	if (!_is_valid_pair(country, recepient)) {
+		return 0;
+	}
+	return country_relations[_get_relation_index(country, recepient)];
 }
 
 country_relation_value_t*
 CountryRelationManager::get_country_relation_ptr(CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient) {
-	auto it = country_relations.find({ country.country_id, recepient.country_id });
-	OV_ERR_FAIL_COND_V(it == country_relations.end(), nullptr);
-	return &it.value();
+	if (!_is_valid_pair(country, recepient)) {
+		return nullptr;
+	}
+	return &country_relations[_get_relation_index(country, recepient)];
 }
 
 bool CountryRelationManager::set_country_relation(
 	CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient, country_relation_value_t value
 ) {
-	auto it = country_relations.find({ country.country_id, recepient.country_id });
-	OV_ERR_FAIL_COND_V(it == country_relations.end(), false);
-	it.value() = value;
+	if (!_is_valid_pair(country, recepient)) {
+		return false;
+	}
+	country_relations[_get_relation_index(country, recepient)] = value;
 	return true;
 }
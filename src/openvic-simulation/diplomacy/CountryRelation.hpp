@@ -1,87 +1,63 @@
 #pragma once
 
-#include <compare>
-#include <tuple>
-
-#include "openvic-simulation/types/OrderedContainers.hpp"
-#include "openvic-simulation/utility/Utility.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace OpenVic {
 	struct CountryInstance;
+	struct CountryInstanceManager;
 
 	struct CountryRelationInstanceProxy {
-		std::string_view country_id;
+		size_t country_index;
 
-		CountryRelationInstanceProxy(std::string_view id);
+		CountryRelationInstanceProxy(size_t index);
+		CountryRelationInstanceProxy(CountryInstance const& country);
 		CountryRelationInstanceProxy(CountryInstance const* country);
 
-		operator std::string_view() const;
+		operator size_t() const;
 	};
 
-	struct CountryRelationPair : std::pair<std::string_view, std::string_view> {
-		using base_type = std::pair<std::string_view, std::string_view>;
-		using base_type::base_type;
-
-		inline constexpr auto operator<=>(CountryRelationPair const& rhs) const {
-			using ordering = decltype(OpenVic::utility::three_way(std::tie(first, second), std::tie(rhs.first, rhs.second)));
-
-			auto tied = std::tie(first, second);
-			if (tied == std::tie(rhs.first, rhs.second)) {
-				return ordering::equivalent;
-			} else if (tied == std::tie(rhs.second, rhs.first)) {
-				return ordering::equivalent;
-			}
-
-			auto& [lhs_left, lhs_right] = *this;
-			auto& [rhs_left, rhs_right] = rhs;
-
-			auto& lhs_comp_first = lhs_left > lhs_right ? lhs_left : lhs_right;
-			auto& lhs_comp_second = lhs_left < lhs_right ? lhs_left : lhs_right;
+	using country_relation_value_t = int16_t;
 
-			auto& rhs_comp_first = rhs_left > rhs_right ? rhs_left : rhs_right;
-			auto& rhs_comp_second = rhs_left < rhs_right ? rhs_left : rhs_right;
+	/* Relations between every pair of countries, stored as the lower triangle (excluding the diagonal) of a symmetric
+	 * matrix indexed by country index. The relation between countries a > b is at a * (a - 1) / 2 + b, so each country's
+	 * relations with lower indexed countries are contiguous, and adding a country with a higher index than any before it
+	 * only appends to the storage. */
+	struct CountryRelationManager {
+	private:
+		std::vector<country_relation_value_t> country_relations;
+		/* Whether each country index has been added and not since removed. */
+		std::vector<bool> countries_present;
 
-			return OpenVic::utility::three_way(
-				std::tie(lhs_comp_first, lhs_comp_second), std::tie(rhs_comp_first, rhs_comp_second)
-			);
+		static constexpr size_t _get_relation_count(size_t country_count) {
+			return country_count * (country_count - (country_count > 0)) / 2;
 		}
 
-		inline constexpr bool operator==(CountryRelationPair const& rhs) const {
-			auto tied = std::tie(first, second);
-			return tied == std::tie(rhs.first, rhs.second) || tied == std::tie(rhs.second, rhs.first);
+		static constexpr size_t _get_relation_index(size_t country, size_t recepient) {
+			const size_t high = country > recepient ? country : recepient;
+			const size_t low = country > recepient ? recepient : country;
+			return high * (high - 1) / 2 + low;
 		}
-	};
-}
 
-namespace std {
-	template<>
-	struct hash<OpenVic::CountryRelationPair> {
-		size_t operator()(OpenVic::CountryRelationPair const& pair) const {
-			std::size_t seed1(0);
-			OpenVic::utility::hash_combine(seed1, pair.first);
-			OpenVic::utility::hash_combine(seed1, pair.second);
+		bool _is_valid_pair(size_t country, size_t recepient) const;
 
-			std::size_t seed2(0);
-			OpenVic::utility::hash_combine(seed2, pair.second);
-			OpenVic::utility::hash_combine(seed2, pair.first);
-
-			return std::min(seed1, seed2);
-		}
-	};
-}
+	public:
+		CountryRelationManager();
 
-namespace OpenVic {
-	using country_relation_value_t = int16_t;
+		/* Sizes the matrix for every country instance, adding them all with neutral relations. */
+		bool setup(CountryInstanceManager const& country_instance_manager);
 
-	struct CountryRelationManager {
-	private:
-		// TODO: reference of manager responsible for storing CountryInstances
-		ordered_map<CountryRelationPair, country_relation_value_t> country_relations;
+		constexpr size_t get_country_count() const {
+			return countries_present.size();
+		}
 
-	public:
-		CountryRelationManager(/* TODO: Country Instance Manager Reference */);
+		bool is_country_present(CountryRelationInstanceProxy country) const;
 
+		/* Adds a country with neutral relations towards every other country, e.g. a released or dynamically created country.
+		 * Indices beyond the current matrix size grow it to fit. */
 		bool add_country(CountryRelationInstanceProxy country);
+		/* Removes a country, resetting its relations so they start out neutral if it is later added again. */
 		bool remove_country(CountryRelationInstanceProxy country);
 
 		country_relation_value_t
@@ -91,5 +67,27 @@ namespace OpenVic {
 		bool set_country_relation(
 			CountryRelationInstanceProxy country, CountryRelationInstanceProxy recepient, country_relation_value_t value
 		);
+
+		/* Calls func(recepient_index, relation) for every other present country, in order of index. Relations with lower
+		 * indexed countries are read from one contiguous row, higher indexed ones from one entry per later row. */
+		template<typename Func>
+		void for_each_country_relation(CountryRelationInstanceProxy country, Func&& func) const {
+			const size_t index = country.country_index;
+			if (!is_country_present(index)) {
+				return;
+			}
+
+			country_relation_value_t const* row = country_relations.data() + _get_relation_index(index, 0);
+			for (size_t recepient = 0; recepient < index; ++recepient) {
+				if (countries_present[recepient]) {
+					func(recepient, row[recepient]);
+				}
+			}
+			for (size_t recepient = index + 1; recepient < countries_present.size(); ++recepient) {
+				if (countries_present[recepient]) {
+					func(recepient, country_relations[_get_relation_index(recepient, index)]);
+				}
+			}
+		}
 	};
 }
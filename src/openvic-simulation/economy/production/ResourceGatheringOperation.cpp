@@ -8,7 +8,7 @@ ResourceGatheringOperation::ResourceGatheringOperation(
 	fixed_point_t new_revenue_yesterday,
 	fixed_point_t new_output_quantity_yesterday,
 	fixed_point_t new_unsold_quantity_yesterday,
-	ordered_map<Pop*, Pop::pop_size_t>&& new_employees
+	ordered_map<Pop::pop_id_t, Pop::pop_size_t>&& new_employees
 ) : production_type { new_production_type },
 	revenue_yesterday { new_revenue_yesterday },
 	output_quantity_yesterday { new_output_quantity_yesterday },
@@ -12,13 +12,13 @@ namespace OpenVic {
 		fixed_point_t PROPERTY(output_quantity_yesterday);
 		fixed_point_t PROPERTY(unsold_quantity_yesterday);
 		fixed_point_t PROPERTY(size_multiplier);
-		ordered_map<Pop*, Pop::pop_size_t> PROPERTY(employees);
+		ordered_map<Pop::pop_id_t, Pop::pop_size_t> PROPERTY(employees);
 
 	public:
 		ResourceGatheringOperation(
 			ProductionType const& new_production_type, fixed_point_t new_size_multiplier, fixed_point_t new_revenue_yesterday,
 			fixed_point_t new_output_quantity_yesterday, fixed_point_t new_unsold_quantity_yesterday,
-			ordered_map<Pop*, Pop::pop_size_t>&& new_employees
+			ordered_map<Pop::pop_id_t, Pop::pop_size_t>&& new_employees
 		);
 		ResourceGatheringOperation(ProductionType const& new_production_type, fixed_point_t new_size_multiplier);
 	};
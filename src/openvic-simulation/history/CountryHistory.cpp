@@ -2,6 +2,7 @@
 
 #include "openvic-simulation/country/CountryDefinition.hpp"
 #include "openvic-simulation/DefinitionManager.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
 
 using namespace OpenVic;
 using namespace OpenVic::NodeTools;
@@ -17,10 +18,8 @@ CountryHistoryMap::CountryHistoryMap(
 	decltype(government_type_keys) new_government_type_keys
 ) : country { new_country }, ideology_keys { new_ideology_keys }, government_type_keys { new_government_type_keys } {}
 
-std::unique_ptr<CountryHistoryEntry> CountryHistoryMap::_make_entry(Date date) const {
-	return std::unique_ptr<CountryHistoryEntry> {
-		new CountryHistoryEntry { country, date, ideology_keys, government_type_keys }
-	};
+CountryHistoryEntry CountryHistoryMap::_make_entry(Date date) const {
+	return CountryHistoryEntry { country, date, ideology_keys, government_type_keys };
 }
 
 bool CountryHistoryMap::_load_history_entry(
@@ -220,6 +219,61 @@ bool CountryHistoryMap::_load_history_entry(
 	)(root);
 }
 
+void CountryHistoryMap::_fold_entry_into_snapshot(CountryHistoryEntry& snapshot, CountryHistoryEntry const& entry) const {
+	constexpr auto fold_optional = []<typename T>(std::optional<T>& target, std::optional<T> const& source) {
+		if (source) {
+			target = source;
+		}
+	};
+	constexpr auto fold_map = []<typename Map>(Map& target, Map const& source) {
+		for (auto const& [key, value] : source) {
+			target[key] = value;
+		}
+	};
+
+	fold_optional(snapshot.primary_culture, entry.primary_culture);
+	/* Only the accepted cultures remaining after every instruction are kept, all as additions. */
+	for (auto const& [culture, add] : entry.accepted_cultures) {
+		if (add) {
+			snapshot.accepted_cultures[culture] = true;
+		} else {
+			snapshot.accepted_cultures.erase(culture);
+		}
+	}
+	fold_optional(snapshot.religion, entry.religion);
+	fold_optional(snapshot.ruling_party, entry.ruling_party);
+	fold_optional(snapshot.last_election, entry.last_election);
+	/* Every entry overwrites the whole upper house, even if it doesn't set it. */
+	snapshot.upper_house.copy(entry.upper_house);
+	fold_optional(snapshot.capital, entry.capital);
+	fold_optional(snapshot.government_type, entry.government_type);
+	fold_optional(snapshot.plurality, entry.plurality);
+	fold_optional(snapshot.national_value, entry.national_value);
+	fold_optional(snapshot.civilised, entry.civilised);
+	fold_optional(snapshot.prestige, entry.prestige);
+	/* Each reform replaces the previous one in its group, so re-added reforms are moved to the end to still be applied
+	 * after any others in their group. */
+	for (Reform const* reform : entry.reforms) {
+		snapshot.reforms.erase(reform);
+		snapshot.reforms.insert(reform);
+	}
+	fold_optional(snapshot.inital_oob, entry.inital_oob);
+	fold_optional(snapshot.tech_school, entry.tech_school);
+	fold_map(snapshot.technologies, entry.technologies);
+	fold_map(snapshot.inventions, entry.inventions);
+	fold_map(snapshot.foreign_investment, entry.foreign_investment);
+	fold_optional(snapshot.consciousness, entry.consciousness);
+	fold_optional(snapshot.nonstate_consciousness, entry.nonstate_consciousness);
+	fold_optional(snapshot.literacy, entry.literacy);
+	fold_optional(snapshot.nonstate_culture_literacy, entry.nonstate_culture_literacy);
+	fold_optional(snapshot.releasable_vassal, entry.releasable_vassal);
+	fold_optional(snapshot.colonial_points, entry.colonial_points);
+	snapshot.country_flags.insert(entry.country_flags.begin(), entry.country_flags.end());
+	snapshot.global_flags.insert(entry.global_flags.begin(), entry.global_flags.end());
+	snapshot.government_flag_overrides.write_non_empty_values(entry.government_flag_overrides);
+	snapshot.decisions.insert(entry.decisions.begin(), entry.decisions.end());
+}
+
 void CountryHistoryManager::reserve_more_country_histories(size_t size) {
 	if (locked) {
 		Logger::error("Failed to reserve space for ", size, " countries in CountryHistoryManager - already locked!");
@@ -230,7 +284,7 @@ void CountryHistoryManager::reserve_more_country_histories(size_t size) {
 
 void CountryHistoryManager::lock_country_histories() {
 	for (auto [country, history_map] : mutable_iterator(country_histories)) {
-		history_map.sort_entries();
+		history_map.lock_entries();
 	}
 
 	Logger::info("Locked country history registry after registering ", country_histories.size(), " items");
@@ -241,6 +295,30 @@ bool CountryHistoryManager::is_locked() const {
 	return locked;
 }
 
+bool CountryHistoryManager::build_bookmark_snapshots(BookmarkManager const& bookmark_manager, ThreadPool& thread_pool) {
+	if (!locked) {
+		Logger::error("Cannot build country history bookmark snapshots - country history registry not yet locked!");
+		return false;
+	}
+
+	thread_pool.parallel_for(
+		country_histories.size(), [this, &bookmark_manager](size_t begin, size_t end) -> void {
+			for (size_t index = begin; index < end; ++index) {
+				CountryHistoryMap& history_map = (country_histories.begin() + index).value();
+				for (Bookmark const& bookmark : bookmark_manager.get_bookmarks()) {
+					history_map._build_snapshot(bookmark.get_date());
+				}
+			}
+		}
+	);
+
+	Logger::info(
+		"Built country history snapshots for ", bookmark_manager.get_bookmark_count(), " bookmarks and ",
+		country_histories.size(), " countries"
+	);
+	return true;
+}
+
 CountryHistoryMap const* CountryHistoryManager::get_country_history(CountryDefinition const* country) const {
 	if (country == nullptr) {
 		Logger::error("Attempted to access history of null country");
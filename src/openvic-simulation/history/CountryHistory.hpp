@@ -68,6 +68,8 @@ namespace OpenVic {
 	};
 
 	class Dataloader;
+	struct ThreadPool;
+	struct BookmarkManager;
 	struct DeploymentManager;
 	struct CountryHistoryManager;
 
@@ -85,11 +87,12 @@ namespace OpenVic {
 			decltype(government_type_keys) new_government_type_keys
 		);
 
-		std::unique_ptr<CountryHistoryEntry> _make_entry(Date date) const override;
+		CountryHistoryEntry _make_entry(Date date) const override;
 		bool _load_history_entry(
 			DefinitionManager const& definition_manager, Dataloader const& dataloader, DeploymentManager& deployment_manager,
 			CountryHistoryEntry& entry, ast::NodeCPtr root
 		) override;
+		void _fold_entry_into_snapshot(CountryHistoryEntry& snapshot, CountryHistoryEntry const& entry) const override;
 	};
 
 	struct CountryHistoryManager {
@@ -103,6 +106,8 @@ namespace OpenVic {
 		void reserve_more_country_histories(size_t size);
 		void lock_country_histories();
 		bool is_locked() const;
+		/* Builds a snapshot of every country's history at each bookmark's date. Must be called after locking. */
+		bool build_bookmark_snapshots(BookmarkManager const& bookmark_manager, ThreadPool& thread_pool);
 
 		CountryHistoryMap const* get_country_history(CountryDefinition const* country) const;
 
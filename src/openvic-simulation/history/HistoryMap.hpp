@@ -1,10 +1,12 @@
 #pragma once
 
-#include <memory>
+#include <algorithm>
+#include <span>
+#include <vector>
 
 #include "openvic-simulation/dataloader/NodeTools.hpp"
 #include "openvic-simulation/types/Date.hpp"
-#include "openvic-simulation/types/OrderedContainers.hpp"
+#include "openvic-simulation/utility/ChunkedArena.hpp"
 
 namespace OpenVic {
 
@@ -29,7 +31,23 @@ namespace OpenVic {
 		using entry_type = _Entry;
 
 	private:
-		ordered_map<Date, std::unique_ptr<entry_type>> PROPERTY(entries);
+		/* Sorted by date, with at most one entry per date. Filled once loading is complete by lock_entries. */
+		std::vector<entry_type> PROPERTY(entries);
+		/* Entries are created in an arena while loading so they keep their addresses as entries for later dates nested
+		 * inside them are created, with pointers to them kept sorted by date for lookups. */
+		ChunkedArena<entry_type> loading_entries;
+		std::vector<entry_type*> loading_entries_by_date;
+		/* Entries combining every entry up to and including their date, so applying one has the same effect as applying
+		 * each of the entries it was built from in order. Built for bookmark dates once loading is complete. */
+		std::vector<entry_type> snapshots;
+
+		static bool _entry_date_less(entry_type const& entry, Date date) {
+			return entry.get_date() < date;
+		}
+
+		static bool _date_less_entry(Date date, entry_type const& entry) {
+			return date < entry.get_date();
+		}
 
 		bool _try_load_history_entry(
 			DefinitionManager const& definition_manager, Args... args, Date date, ast::NodeCPtr root
@@ -45,12 +63,26 @@ namespace OpenVic {
 	protected:
 		HistoryMap() = default;
 
-		virtual std::unique_ptr<entry_type> _make_entry(Date date) const = 0;
+		virtual entry_type _make_entry(Date date) const = 0;
 
 		virtual bool _load_history_entry(
 			DefinitionManager const& definition_manager, Args... args, entry_type& entry, ast::NodeCPtr root
 		) = 0;
 
+		/* Updates snapshot so that applying it has the same effect as applying it followed by entry. */
+		virtual void _fold_entry_into_snapshot(entry_type& snapshot, entry_type const& entry) const = 0;
+
+		/* Entries must already be locked. Does nothing if a snapshot has already been built for the date. */
+		void _build_snapshot(Date date) {
+			if (get_snapshot(date) != nullptr) {
+				return;
+			}
+			entry_type& snapshot = snapshots.emplace_back(_make_entry(date));
+			for (entry_type const& entry : get_entries_up_to(date)) {
+				_fold_entry_into_snapshot(snapshot, entry);
+			}
+		}
+
 		bool _load_history_file(DefinitionManager const& definition_manager, Args... args, ast::NodeCPtr root) {
 			return _try_load_history_entry(
 				definition_manager, args..., _HistoryMapHelperFuncs::_get_start_date(definition_manager), root
@@ -90,39 +122,64 @@ namespace OpenVic {
 				Logger::error("History entry ", date, " defined after end date ", end_date);
 				return nullptr;
 			}
-			typename decltype(entries)::iterator it = entries.find(date);
-			if (it == entries.end()) {
-				const std::pair<typename decltype(entries)::iterator, bool> result = entries.emplace(date, _make_entry(date));
-				if (result.second) {
-					it = result.first;
-				} else {
-					Logger::error("Failed to create history entry at date ", date);
-					return nullptr;
+			const typename decltype(loading_entries_by_date)::iterator it = std::lower_bound(
+				loading_entries_by_date.begin(), loading_entries_by_date.end(), date,
+				[](entry_type const* entry, Date date) -> bool {
+					return _entry_date_less(*entry, date);
 				}
+			);
+			if (it != loading_entries_by_date.end() && (*it)->get_date() == date) {
+				return *it;
 			}
-			return it->second.get();
+			entry_type& entry = loading_entries.emplace_back(_make_entry(date));
+			loading_entries_by_date.insert(it, &entry);
+			return &entry;
 		}
 
 	public:
-		void sort_entries() {
-			std::vector<Date> keys;
-			keys.reserve(entries.size());
-			for (typename decltype(entries)::value_type const& entry : entries) {
-				keys.push_back(entry.first);
+		/* Moves the loaded entries into contiguous storage in date order, freeing the arena they were loaded into.
+		 * No more entries can be loaded afterwards. */
+		void lock_entries() {
+			entries.reserve(entries.size() + loading_entries_by_date.size());
+			for (entry_type* entry : loading_entries_by_date) {
+				entries.push_back(std::move(*entry));
 			}
-			std::sort(keys.begin(), keys.end());
-			ordered_map<Date, std::unique_ptr<entry_type>> new_entries;
-			for (Date const& key : keys) {
-				new_entries.emplace(key, std::move(entries[key]));
-			}
-			entries = std::move(new_entries);
+			loading_entries_by_date = {};
+			loading_entries.clear();
 		}
 
 		/* Returns history entry at specific date, if date doesn't have an entry returns nullptr. */
 		entry_type const* get_entry(Date date) const {
-			typename decltype(entries)::const_iterator it = entries.find(date);
-			if (it != entries.end()) {
-				return it->second.get();
+			const typename decltype(entries)::const_iterator it =
+				std::lower_bound(entries.begin(), entries.end(), date, _entry_date_less);
+			if (it != entries.end() && it->get_date() == date) {
+				return &*it;
+			}
+			return nullptr;
+		}
+
+		/* Returns the entries up to and including a specific date, which together make up the history as of that date. */
+		std::span<const entry_type> get_entries_up_to(Date date) const {
+			const typename decltype(entries)::const_iterator it =
+				std::upper_bound(entries.begin(), entries.end(), date, _date_less_entry);
+			return { entries.begin(), it };
+		}
+
+		/* Returns the entries after a specific date. */
+		std::span<const entry_type> get_entries_after(Date date) const {
+			const typename decltype(entries)::const_iterator it =
+				std::upper_bound(entries.begin(), entries.end(), date, _date_less_entry);
+			return { it, entries.end() };
+		}
+
+		/* Returns the snapshot of all history up to and including a specific date, if one was built for that date,
+		 * otherwise returns nullptr. */
+		entry_type const* get_snapshot(Date date) const {
+			/* Only built for bookmark dates, so there are too few to be worth sorting. */
+			for (entry_type const& snapshot : snapshots) {
+				if (snapshot.get_date() == date) {
+					return &snapshot;
+				}
 			}
 			return nullptr;
 		}
@@ -2,6 +2,7 @@
 
 #include "openvic-simulation/DefinitionManager.hpp"
 #include "openvic-simulation/map/ProvinceDefinition.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
 
 using namespace OpenVic;
 using namespace OpenVic::NodeTools;
@@ -11,8 +12,8 @@ ProvinceHistoryEntry::ProvinceHistoryEntry(ProvinceDefinition const& new_provinc
 
 ProvinceHistoryMap::ProvinceHistoryMap(ProvinceDefinition const& new_province) : province { new_province } {}
 
-std::unique_ptr<ProvinceHistoryEntry> ProvinceHistoryMap::_make_entry(Date date) const {
-	return std::unique_ptr<ProvinceHistoryEntry> { new ProvinceHistoryEntry { province, date } };
+ProvinceHistoryEntry ProvinceHistoryMap::_make_entry(Date date) const {
+	return ProvinceHistoryEntry { province, date };
 }
 
 bool ProvinceHistoryMap::_load_history_entry(
@@ -145,6 +146,44 @@ bool ProvinceHistoryMap::_load_history_entry(
 	)(root);
 }
 
+void ProvinceHistoryMap::_fold_entry_into_snapshot(
+	ProvinceHistoryEntry& snapshot, ProvinceHistoryEntry const& entry
+) const {
+	constexpr auto fold_optional = []<typename T>(std::optional<T>& target, std::optional<T> const& source) {
+		if (source) {
+			target = source;
+		}
+	};
+	constexpr auto fold_map = []<typename Map>(Map& target, Map const& source) {
+		for (auto const& [key, value] : source) {
+			target[key] = value;
+		}
+	};
+
+	fold_optional(snapshot.owner, entry.owner);
+	fold_optional(snapshot.controller, entry.controller);
+	fold_optional(snapshot.colonial, entry.colonial);
+	fold_optional(snapshot.slave, entry.slave);
+	/* Only the cores remaining after every instruction are kept, all as additions. */
+	for (auto const& [country, add] : entry.cores) {
+		if (add) {
+			snapshot.cores[country] = true;
+		} else {
+			snapshot.cores.erase(country);
+		}
+	}
+	fold_optional(snapshot.rgo, entry.rgo);
+	fold_optional(snapshot.life_rating, entry.life_rating);
+	fold_optional(snapshot.terrain_type, entry.terrain_type);
+	fold_map(snapshot.province_buildings, entry.province_buildings);
+	fold_map(snapshot.state_buildings, entry.state_buildings);
+	fold_map(snapshot.party_loyalties, entry.party_loyalties);
+	/* Only the most recent pop history is used. */
+	if (!entry.pops.empty()) {
+		snapshot.pops = entry.pops;
+	}
+}
+
 void ProvinceHistoryManager::reserve_more_province_histories(size_t size) {
 	if (locked) {
 		Logger::error("Failed to reserve space for ", size, " provinces in ProvinceHistoryManager - already locked!");
@@ -160,7 +199,7 @@ void ProvinceHistoryManager::lock_province_histories(MapDefinition const& map_de
 	for (auto [province, history_map] : mutable_iterator(province_histories)) {
 		province_checklist[province->get_index() - 1] = true;
 
-		history_map.sort_entries();
+		history_map.lock_entries();
 	}
 
 	size_t missing = 0;
@@ -187,6 +226,30 @@ bool ProvinceHistoryManager::is_locked() const {
 	return locked;
 }
 
+bool ProvinceHistoryManager::build_bookmark_snapshots(BookmarkManager const& bookmark_manager, ThreadPool& thread_pool) {
+	if (!locked) {
+		Logger::error("Cannot build province history bookmark snapshots - province history registry not yet locked!");
+		return false;
+	}
+
+	thread_pool.parallel_for(
+		province_histories.size(), [this, &bookmark_manager](size_t begin, size_t end) -> void {
+			for (size_t index = begin; index < end; ++index) {
+				ProvinceHistoryMap& history_map = (province_histories.begin() + index).value();
+				for (Bookmark const& bookmark : bookmark_manager.get_bookmarks()) {
+					history_map._build_snapshot(bookmark.get_date());
+				}
+			}
+		}
+	);
+
+	Logger::info(
+		"Built province history snapshots for ", bookmark_manager.get_bookmark_count(), " bookmarks and ",
+		province_histories.size(), " provinces"
+	);
+	return true;
+}
+
 ProvinceHistoryMap const* ProvinceHistoryManager::get_province_history(ProvinceDefinition const* province) const {
 	if (province == nullptr) {
 		Logger::error("Attempted to access history of null province");
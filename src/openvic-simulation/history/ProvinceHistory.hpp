@@ -58,10 +58,11 @@ namespace OpenVic {
 	protected:
 		ProvinceHistoryMap(ProvinceDefinition const& new_province);
 
-		std::unique_ptr<ProvinceHistoryEntry> _make_entry(Date date) const override;
+		ProvinceHistoryEntry _make_entry(Date date) const override;
 		bool _load_history_entry(
 			DefinitionManager const& definition_manager, ProvinceHistoryEntry& entry, ast::NodeCPtr root
 		) override;
+		void _fold_entry_into_snapshot(ProvinceHistoryEntry& snapshot, ProvinceHistoryEntry const& entry) const override;
 
 	private:
 		bool _load_province_pop_history(
@@ -70,6 +71,8 @@ namespace OpenVic {
 	};
 
 	struct MapDefinition;
+	struct BookmarkManager;
+	struct ThreadPool;
 
 	struct ProvinceHistoryManager {
 	private:
@@ -84,6 +87,9 @@ namespace OpenVic {
 		void reserve_more_province_histories(size_t size);
 		void lock_province_histories(MapDefinition const& map_definition, bool detailed_errors);
 		bool is_locked() const;
+		/* Builds a snapshot of every province's history at each bookmark's date, so loading a bookmark applies one entry
+		 * per province rather than replaying all of its history. Must be called after locking. */
+		bool build_bookmark_snapshots(BookmarkManager const& bookmark_manager, ThreadPool& thread_pool);
 
 		ProvinceHistoryMap const* get_province_history(ProvinceDefinition const* province) const;
 
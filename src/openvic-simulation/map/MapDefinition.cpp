@@ -1,6 +1,9 @@
 #include "MapDefinition.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <limits>
 #include <vector>
 
 #include "openvic-simulation/types/Colour.hpp"
@@ -8,6 +11,7 @@
 #include "openvic-simulation/types/Vector.hpp"
 #include "openvic-simulation/utility/BMP.hpp"
 #include "openvic-simulation/utility/Logger.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
 
 using namespace OpenVic;
 using namespace OpenVic::NodeTools;
@@ -495,7 +499,10 @@ static constexpr colour_t colour_at(uint8_t const* colour_data, int32_t idx) {
 	return { colour_data[idx + 2], colour_data[idx + 1], colour_data[idx] };
 }
 
-bool MapDefinition::load_map_images(fs::path const& province_path, fs::path const& terrain_path, fs::path const& rivers_path, bool detailed_errors) {
+bool MapDefinition::load_map_images(
+	fs::path const& province_path, fs::path const& terrain_path, fs::path const& rivers_path, ThreadPool& thread_pool,
+	bool detailed_errors
+) {
 	if (!province_definitions_are_locked()) {
 		Logger::error("Province index image cannot be generated until after provinces are locked!");
 		return false;
@@ -564,100 +571,188 @@ bool MapDefinition::load_map_images(fs::path const& province_path, fs::path cons
 	uint8_t const* province_data = province_bmp.get_pixel_data().data();
 	uint8_t const* terrain_data = terrain_bmp.get_pixel_data().data();
 
-	std::vector<fixed_point_map_t<TerrainType const*>> terrain_type_pixels_list(province_definitions.size());
+	/* Resolve every possible terrain image value up front, so the pixel pass doesn't need any map lookups. Terrain
+	 * types are given dense local IDs in the order their mappings' values appear, for use as accumulator indices. */
+	static constexpr size_t TERRAIN_VALUE_COUNT = 1 << (8 * sizeof(TerrainTypeMapping::index_t));
+	static constexpr uint16_t NO_TERRAIN_TYPE = std::numeric_limits<uint16_t>::max();
 
-	bool ret = true;
-	ordered_set<colour_t> unrecognised_province_colours;
+	struct terrain_value_t {
+		uint8_t shape_terrain = 0;
+		uint16_t terrain_type_id = NO_TERRAIN_TYPE;
+	};
 
-	std::vector<fixed_point_t> pixels_per_province(province_definitions.size());
-	std::vector<fvec2_t> pixel_position_sum_per_province(province_definitions.size());
+	std::array<terrain_value_t, TERRAIN_VALUE_COUNT> terrain_values;
+	std::vector<TerrainType const*> terrain_types;
 
-	for (ivec2_t pos {}; pos.y < get_height(); ++pos.y) {
-		for (pos.x = 0; pos.x < get_width(); ++pos.x) {
-			const size_t pixel_index = get_pixel_index_from_pos(pos);
-			const colour_t province_colour = colour_at(province_data, pixel_index);
-			ProvinceDefinition::index_t province_index = ProvinceDefinition::NULL_INDEX;
-
-			if (pos.x > 0) {
-				const size_t jdx = pixel_index - 1;
-				if (colour_at(province_data, jdx) == province_colour) {
-					province_index = province_shape_image[jdx].index;
-					goto index_found;
-				}
-			}
+	for (size_t value = 0; value < TERRAIN_VALUE_COUNT; ++value) {
+		const TerrainTypeMapping::index_t terrain = static_cast<TerrainTypeMapping::index_t>(value);
+		TerrainTypeMapping const* mapping = terrain_type_manager.get_terrain_type_mapping_for(terrain);
+		if (mapping == nullptr) {
+			continue;
+		}
 
-			if (pos.y > 0) {
-				const size_t jdx = pixel_index - get_width();
-				if (colour_at(province_data, jdx) == province_colour) {
-					province_index = province_shape_image[jdx].index;
-					goto index_found;
-				}
-			}
+		terrain_value_t& terrain_value = terrain_values[value];
+		if (mapping->get_has_texture() && terrain < terrain_type_manager.get_terrain_texture_limit()) {
+			terrain_value.shape_terrain = terrain + 1;
+		}
 
-			province_index = get_index_from_colour(province_colour);
+		const std::vector<TerrainType const*>::const_iterator it =
+			std::find(terrain_types.begin(), terrain_types.end(), &mapping->get_type());
+		terrain_value.terrain_type_id = it - terrain_types.begin();
+		if (it == terrain_types.end()) {
+			terrain_types.push_back(&mapping->get_type());
+		}
+	}
 
-			if (province_index == ProvinceDefinition::NULL_INDEX && !unrecognised_province_colours.contains(province_colour)) {
-				unrecognised_province_colours.insert(province_colour);
-				if (detailed_errors) {
-					Logger::warning(
-						"Unrecognised province colour ", province_colour, " at ", pos
-					);
+	const size_t province_count = province_definitions.size();
+	const size_t terrain_type_count = terrain_types.size();
+
+	/* Each band of rows is processed by a single thread with its own accumulators, which are merged in band order
+	 * afterwards so the results don't depend on the thread count. Pixel counts and position sums are integers, so merging
+	 * them is exact, and the first pixel of each terrain type in each province is tracked so ties between terrain types
+	 * are broken the same way regardless of how the image was split. */
+	struct band_t {
+		std::vector<uint32_t> pixel_counts;
+		std::vector<int64_t> position_x_sums;
+		std::vector<int64_t> position_y_sums;
+		/* Indexed by province array index * terrain_type_count + terrain type ID. */
+		std::vector<uint32_t> terrain_pixel_counts;
+		std::vector<uint32_t> terrain_first_pixels;
+		/* Each unrecognised colour and where it first appears, in order of appearance. */
+		ordered_map<colour_t, ivec2_t> unrecognised_colours;
+	};
+
+	const size_t band_count = std::clamp<size_t>(thread_pool.get_thread_count(), 1, std::max(get_height(), 1));
+	std::vector<band_t> bands(band_count);
+
+	thread_pool.parallel_for(band_count, [&](size_t band_begin, size_t band_end) -> void {
+		for (size_t band_index = band_begin; band_index < band_end; ++band_index) {
+			band_t& band = bands[band_index];
+			band.pixel_counts.resize(province_count);
+			band.position_x_sums.resize(province_count);
+			band.position_y_sums.resize(province_count);
+			band.terrain_pixel_counts.resize(province_count * terrain_type_count);
+			band.terrain_first_pixels.resize(province_count * terrain_type_count);
+
+			const int32_t row_begin = get_height() * band_index / band_count;
+			const int32_t row_end = get_height() * (band_index + 1) / band_count;
+
+			/* Consecutive pixels are usually in the same province, so most lookups are answered by this cache. */
+			bool has_last = false;
+			colour_t last_colour {};
+			ProvinceDefinition::index_t last_index = ProvinceDefinition::NULL_INDEX;
+
+			for (ivec2_t pos { 0, row_begin }; pos.y < row_end; ++pos.y) {
+				for (pos.x = 0; pos.x < get_width(); ++pos.x) {
+					const size_t pixel_index = get_pixel_index_from_pos(pos);
+					const colour_t province_colour = colour_at(province_data, pixel_index);
+
+					if (!has_last || province_colour != last_colour) {
+						has_last = true;
+						last_colour = province_colour;
+
+						/* Only reuse the pixel above if it's in this band, as other bands are being written concurrently. */
+						const size_t jdx = pixel_index - get_width();
+						if (pos.y > row_begin && colour_at(province_data, jdx) == province_colour) {
+							last_index = province_shape_image[jdx].index;
+						} else {
+							last_index = get_index_from_colour(province_colour);
+
+							if (last_index == ProvinceDefinition::NULL_INDEX) {
+								band.unrecognised_colours.emplace(province_colour, pos);
+							}
+						}
+					}
+
+					const ProvinceDefinition::index_t province_index = last_index;
+					const terrain_value_t terrain_value = terrain_values[terrain_data[pixel_index]];
+
+					province_shape_image[pixel_index].index = province_index;
+					province_shape_image[pixel_index].terrain = terrain_value.shape_terrain;
+
+					if (province_index != ProvinceDefinition::NULL_INDEX) {
+						const size_t array_index = province_index - 1;
+						band.pixel_counts[array_index]++;
+						band.position_x_sums[array_index] += pos.x;
+						band.position_y_sums[array_index] += pos.y;
+
+						if (terrain_value.terrain_type_id != NO_TERRAIN_TYPE) {
+							const size_t terrain_index = array_index * terrain_type_count + terrain_value.terrain_type_id;
+							if (band.terrain_pixel_counts[terrain_index]++ == 0) {
+								band.terrain_first_pixels[terrain_index] = static_cast<uint32_t>(pixel_index);
+							}
+						}
+					}
 				}
 			}
+		}
+	});
 
-		index_found:
-			province_shape_image[pixel_index].index = province_index;
+	bool ret = true;
+	unrecognised_province_colours.clear();
 
-			if (province_index != ProvinceDefinition::NULL_INDEX) {
-				const ProvinceDefinition::index_t array_index = province_index - 1;
-				pixels_per_province[array_index]++;
-				pixel_position_sum_per_province[array_index] += static_cast<fvec2_t>(pos);
-			}
+	std::vector<uint32_t> pixels_per_province(province_count);
+	std::vector<int64_t> position_x_sum_per_province(province_count);
+	std::vector<int64_t> position_y_sum_per_province(province_count);
+	std::vector<uint32_t> terrain_pixels_per_province(province_count * terrain_type_count);
+	std::vector<uint32_t> terrain_first_pixel_per_province(province_count * terrain_type_count);
 
-			const TerrainTypeMapping::index_t terrain = terrain_data[pixel_index];
-			TerrainTypeMapping const* mapping = terrain_type_manager.get_terrain_type_mapping_for(terrain);
-			if (mapping != nullptr) {
-				if (province_index != ProvinceDefinition::NULL_INDEX) {
-					terrain_type_pixels_list[province_index - 1][&mapping->get_type()]++;
-				}
-				if (mapping->get_has_texture() && terrain < terrain_type_manager.get_terrain_texture_limit()) {
-					province_shape_image[pixel_index].terrain = terrain + 1;
-				} else {
-					province_shape_image[pixel_index].terrain = 0;
+	for (band_t const& band : bands) {
+		for (auto const& [colour, pos] : band.unrecognised_colours) {
+			unrecognised_province_colours.emplace(colour, pos);
+		}
+
+		for (size_t array_index = 0; array_index < province_count; ++array_index) {
+			pixels_per_province[array_index] += band.pixel_counts[array_index];
+			position_x_sum_per_province[array_index] += band.position_x_sums[array_index];
+			position_y_sum_per_province[array_index] += band.position_y_sums[array_index];
+		}
+
+		for (size_t terrain_index = 0; terrain_index < terrain_pixels_per_province.size(); ++terrain_index) {
+			const uint32_t band_terrain_pixels = band.terrain_pixel_counts[terrain_index];
+			if (band_terrain_pixels > 0) {
+				/* Earlier bands contain earlier pixels, so the first band to see a terrain type has its first pixel. */
+				if (terrain_pixels_per_province[terrain_index] == 0) {
+					terrain_first_pixel_per_province[terrain_index] = band.terrain_first_pixels[terrain_index];
 				}
-			} else {
-				province_shape_image[pixel_index].terrain = 0;
+				terrain_pixels_per_province[terrain_index] += band_terrain_pixels;
 			}
 		}
 	}
 
-	if (!unrecognised_province_colours.empty()) {
-		Logger::warning("Province image contains ", unrecognised_province_colours.size(), " unrecognised province colours");
-	}
-
-	size_t missing = 0;
-	for (size_t array_index = 0; array_index < province_definitions.size(); ++array_index) {
+	for (size_t array_index = 0; array_index < province_count; ++array_index) {
 		ProvinceDefinition* province = province_definitions.get_item_by_index(array_index);
 
-		fixed_point_map_t<TerrainType const*> const& terrain_type_pixels = terrain_type_pixels_list[array_index];
-		const fixed_point_map_const_iterator_t<TerrainType const*> largest = get_largest_item(terrain_type_pixels);
-		province->default_terrain_type = largest != terrain_type_pixels.end() ? largest->first : nullptr;
+		/* The most common terrain type, with ties going to whichever appears first in the image. */
+		province->default_terrain_type = nullptr;
+		uint32_t largest_terrain_pixels = 0;
+		uint32_t largest_terrain_first_pixel = 0;
+		for (size_t terrain_type_id = 0; terrain_type_id < terrain_type_count; ++terrain_type_id) {
+			const size_t terrain_index = array_index * terrain_type_count + terrain_type_id;
+			const uint32_t terrain_pixels = terrain_pixels_per_province[terrain_index];
+			const uint32_t terrain_first_pixel = terrain_first_pixel_per_province[terrain_index];
+			if (terrain_pixels > largest_terrain_pixels || (
+				terrain_pixels > 0 && terrain_pixels == largest_terrain_pixels &&
+				terrain_first_pixel < largest_terrain_first_pixel
+			)) {
+				province->default_terrain_type = terrain_types[terrain_type_id];
+				largest_terrain_pixels = terrain_pixels;
+				largest_terrain_first_pixel = terrain_first_pixel;
+			}
+		}
 
-		const fixed_point_t pixel_count = pixels_per_province[array_index];
+		const uint32_t pixel_count = pixels_per_province[array_index];
 		province->on_map = pixel_count > 0;
 
 		if (province->on_map) {
-			province->centre = pixel_position_sum_per_province[array_index] / pixel_count;
-		} else {
-			if (detailed_errors) {
-				Logger::warning("Province missing from shape image: ", province->to_string());
-			}
-			missing++;
+			province->centre = fvec2_t {
+				fixed_point_t::parse(position_x_sum_per_province[array_index]),
+				fixed_point_t::parse(position_y_sum_per_province[array_index])
+			} / fixed_point_t::parse(pixel_count);
 		}
 	}
-	if (missing > 0) {
-		Logger::warning("Province image is missing ", missing, " province colours");
-	}
+
+	_log_map_image_warnings(detailed_errors);
 
 	// Constants in the River BMP Palette
 	static constexpr uint8_t START_COLOUR = 0;
@@ -852,31 +947,223 @@ bool MapDefinition::load_map_images(fs::path const& province_path, fs::path cons
 	return ret;
 }
 
+void MapDefinition::_log_map_image_warnings(bool detailed_errors) const {
+	if (detailed_errors) {
+		for (auto const& [colour, pos] : unrecognised_province_colours) {
+			Logger::warning("Unrecognised province colour ", colour, " at ", pos);
+		}
+	}
+	if (!unrecognised_province_colours.empty()) {
+		Logger::warning("Province image contains ", unrecognised_province_colours.size(), " unrecognised province colours");
+	}
+
+	size_t missing = 0;
+	for (ProvinceDefinition const& province : province_definitions.get_items()) {
+		if (!province.on_map) {
+			if (detailed_errors) {
+				Logger::warning("Province missing from shape image: ", province.to_string());
+			}
+			missing++;
+		}
+	}
+	if (missing > 0) {
+		Logger::warning("Province image is missing ", missing, " province colours");
+	}
+}
+
+void MapDefinition::write_map_images_cache(DefinitionCache::Writer& writer) const {
+	writer.write(dims);
+	writer.write_vector(province_shape_image);
+
+	writer.write<uint64_t>(province_definitions.size());
+	for (ProvinceDefinition const& province : province_definitions.get_items()) {
+		writer.write<uint8_t>(province.on_map);
+		writer.write(province.centre.x.get_raw_value());
+		writer.write(province.centre.y.get_raw_value());
+		writer.write_string(province.default_terrain_type != nullptr ? province.default_terrain_type->get_identifier() : "");
+	}
+
+	writer.write<uint64_t>(rivers.size());
+	for (river_t const& river : rivers) {
+		writer.write<uint64_t>(river.size());
+		for (RiverSegment const& segment : river) {
+			writer.write(segment.get_size());
+			writer.write_vector(segment.get_points());
+		}
+	}
+
+	writer.write<uint64_t>(unrecognised_province_colours.size());
+	for (auto const& [colour, pos] : unrecognised_province_colours) {
+		writer.write(colour);
+		writer.write(pos);
+	}
+}
+
+bool MapDefinition::read_map_images_cache(DefinitionCache::Reader& reader, bool detailed_errors) {
+	if (!province_definitions_are_locked()) {
+		Logger::error("Province index image cannot be restored until after provinces are locked!");
+		return false;
+	}
+	if (!terrain_type_manager.terrain_type_mappings_are_locked()) {
+		Logger::error("Province index image cannot be restored until after terrain type mappings are locked!");
+		return false;
+	}
+
+	struct province_data_t {
+		bool on_map;
+		fvec2_t centre;
+		TerrainType const* default_terrain_type;
+	};
+
+	ivec2_t new_dims;
+	std::vector<shape_pixel_t> new_province_shape_image;
+	uint64_t province_count = 0;
+
+	if (!(
+		reader.read(new_dims) && reader.read_vector(new_province_shape_image) && reader.read(province_count)
+	) || new_dims.x <= 0 || new_dims.y <= 0 ||
+		new_province_shape_image.size() != static_cast<size_t>(new_dims.x) * static_cast<size_t>(new_dims.y) ||
+		province_count != province_definitions.size()) {
+		Logger::error("Invalid cached province shape image!");
+		return false;
+	}
+
+	for (shape_pixel_t const& pixel : new_province_shape_image) {
+		if (pixel.index > province_count) {
+			Logger::error("Invalid province index ", pixel.index, " in cached province shape image!");
+			return false;
+		}
+	}
+
+	std::vector<province_data_t> province_data(province_count);
+	std::string terrain_type_identifier;
+	for (province_data_t& data : province_data) {
+		uint8_t on_map = 0;
+		int64_t centre_x = 0, centre_y = 0;
+		if (!(
+			reader.read(on_map) && reader.read(centre_x) && reader.read(centre_y) && reader.read_string(terrain_type_identifier)
+		)) {
+			Logger::error("Invalid cached province data!");
+			return false;
+		}
+		data.on_map = on_map != 0;
+		data.centre = { fixed_point_t::parse_raw(centre_x), fixed_point_t::parse_raw(centre_y) };
+		if (terrain_type_identifier.empty()) {
+			data.default_terrain_type = nullptr;
+		} else {
+			data.default_terrain_type = terrain_type_manager.get_terrain_type_by_identifier(terrain_type_identifier);
+			if (data.default_terrain_type == nullptr) {
+				Logger::error("Invalid terrain type \"", terrain_type_identifier, "\" in cached province data!");
+				return false;
+			}
+		}
+	}
+
+	std::vector<river_t> new_rivers;
+	uint64_t river_count = 0;
+	if (!reader.read(river_count)) {
+		Logger::error("Invalid cached river count!");
+		return false;
+	}
+	for (uint64_t river_index = 0; river_index < river_count; ++river_index) {
+		river_t& river = new_rivers.emplace_back();
+		uint64_t segment_count = 0;
+		if (!reader.read(segment_count)) {
+			Logger::error("Invalid cached river segment count!");
+			return false;
+		}
+		for (uint64_t segment_index = 0; segment_index < segment_count; ++segment_index) {
+			uint8_t size = 0;
+			std::vector<ivec2_t> points;
+			if (!(reader.read(size) && reader.read_vector(points))) {
+				Logger::error("Invalid cached river segment!");
+				return false;
+			}
+			river.push_back({ size, std::move(points) });
+		}
+	}
+
+	ordered_map<colour_t, ivec2_t> new_unrecognised_province_colours;
+	uint64_t unrecognised_colour_count = 0;
+	if (!reader.read(unrecognised_colour_count)) {
+		Logger::error("Invalid cached unrecognised province colour count!");
+		return false;
+	}
+	for (uint64_t colour_index = 0; colour_index < unrecognised_colour_count; ++colour_index) {
+		colour_t colour;
+		ivec2_t pos;
+		if (!(reader.read(colour) && reader.read(pos))) {
+			Logger::error("Invalid cached unrecognised province colour!");
+			return false;
+		}
+		new_unrecognised_province_colours.emplace(colour, pos);
+	}
+
+	if (!reader.is_at_end()) {
+		Logger::error("Unexpected data after cached map images!");
+		return false;
+	}
+
+	dims = new_dims;
+	province_shape_image = std::move(new_province_shape_image);
+	for (size_t array_index = 0; array_index < province_data.size(); ++array_index) {
+		ProvinceDefinition* province = province_definitions.get_item_by_index(array_index);
+		province->on_map = province_data[array_index].on_map;
+		province->centre = province_data[array_index].centre;
+		province->default_terrain_type = province_data[array_index].default_terrain_type;
+	}
+	rivers = std::move(new_rivers);
+	unrecognised_province_colours = std::move(new_unrecognised_province_colours);
+
+	Logger::info("Restored ", rivers.size(), " rivers from cache.");
+
+	_log_map_image_warnings(detailed_errors);
+
+	return true;
+}
+
 /* REQUIREMENTS:
  * MAP-19, MAP-84
  */
 bool MapDefinition::_generate_standard_province_adjacencies() {
-	bool changed = false;
-
-	const auto generate_adjacency = [this](ProvinceDefinition* current, ivec2_t pos) -> bool {
-		ProvinceDefinition* neighbour = get_province_definition_at(pos);
-		if (neighbour != nullptr) {
-			return add_standard_adjacency(*current, *neighbour);
+	using index_t = ProvinceDefinition::index_t;
+
+	/* Almost every adjacent pixel pair is either inside one province or a pair of provinces which has already been seen,
+	 * so the distinct pairs are collected first, in the order they're found, and only those are added as adjacencies. */
+	ordered_set<uint32_t> province_pairs;
+
+	const auto add_pair = [&province_pairs](index_t current, index_t neighbour) -> void {
+		if (neighbour != ProvinceDefinition::NULL_INDEX && neighbour != current) {
+			const uint32_t pair = (static_cast<uint32_t>(current) << 16) | neighbour;
+			const uint32_t reverse_pair = (static_cast<uint32_t>(neighbour) << 16) | current;
+			if (!province_pairs.contains(reverse_pair)) {
+				province_pairs.insert(pair);
+			}
 		}
-		return false;
 	};
 
 	for (ivec2_t pos {}; pos.y < get_height(); ++pos.y) {
 		for (pos.x = 0; pos.x < get_width(); ++pos.x) {
-			ProvinceDefinition* cur = get_province_definition_at(pos);
+			const index_t current = get_province_index_at(pos);
 
-			if (cur != nullptr) {
-				changed |= generate_adjacency(cur, { (pos.x + 1) % get_width(), pos.y });
-				changed |= generate_adjacency(cur, { pos.x, pos.y + 1 });
+			if (current != ProvinceDefinition::NULL_INDEX) {
+				add_pair(current, get_province_index_at({ (pos.x + 1) % get_width(), pos.y }));
+				add_pair(current, get_province_index_at({ pos.x, pos.y + 1 }));
 			}
 		}
 	}
 
+	bool changed = false;
+
+	for (const uint32_t pair : province_pairs) {
+		ProvinceDefinition* from = get_province_definition_by_index(pair >> 16);
+		ProvinceDefinition* to = get_province_definition_by_index(pair & 0xFFFF);
+
+		if (from != nullptr && to != nullptr) {
+			changed |= add_standard_adjacency(*from, *to);
+		}
+	}
+
 	return changed;
 }
 
@@ -888,6 +1175,7 @@ bool MapDefinition::generate_and_load_province_adjacencies(std::vector<LineObjec
 	/* Skip first line containing column headers */
 	if (additional_adjacencies.size() <= 1) {
 		Logger::error("No entries in province adjacencies file!");
+		_build_adjacency_graph();
 		return false;
 	}
 	std::for_each(
@@ -939,9 +1227,18 @@ bool MapDefinition::generate_and_load_province_adjacencies(std::vector<LineObjec
 			ret &= add_special_adjacency(*from, *to, type, through, data);
 		}
 	);
+	_build_adjacency_graph();
 	return ret;
 }
 
+void MapDefinition::_build_adjacency_graph() {
+	adjacency_graph.build(get_province_definitions());
+	Logger::info(
+		"Built province adjacency graph with ", adjacency_graph.get_edge_count(), " adjacencies between ",
+		get_province_definition_count(), " provinces"
+	);
+}
+
 bool MapDefinition::load_climate_file(ModifierManager const& modifier_manager, ast::NodeCPtr root) {
 	bool ret = expect_dictionary_reserve_length(
 		climates,
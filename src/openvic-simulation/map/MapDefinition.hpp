@@ -7,6 +7,8 @@
 
 #include <openvic-dataloader/csv/LineObject.hpp>
 
+#include "openvic-simulation/dataloader/DefinitionCache.hpp"
+#include "openvic-simulation/map/ProvinceAdjacencyGraph.hpp"
 #include "openvic-simulation/map/ProvinceDefinition.hpp"
 #include "openvic-simulation/map/Region.hpp"
 #include "openvic-simulation/map/TerrainType.hpp"
@@ -20,6 +22,7 @@ namespace OpenVic {
 
 	struct BuildingTypeManager;
 	struct ModifierManager;
+	struct ThreadPool;
 
 	struct RiverSegment {
 		friend struct MapDefinition;
@@ -62,11 +65,19 @@ namespace OpenVic {
 		ivec2_t PROPERTY(dims);
 		std::vector<shape_pixel_t> PROPERTY(province_shape_image);
 		colour_index_map_t colour_index_map;
+		/* Each colour in the province image without a province and where it first appears, in order of appearance. Kept
+		 * so that restoring the map images from a cache repeats the warnings generating them gave. */
+		ordered_map<colour_t, ivec2_t> unrecognised_province_colours;
 
 		ProvinceDefinition::index_t PROPERTY(max_provinces);
+		/* Built from every province's adjacencies once they have all been generated and loaded. */
+		ProvinceAdjacencyGraph PROPERTY(adjacency_graph);
 
 		ProvinceDefinition::index_t get_index_from_colour(colour_t colour) const;
 		bool _generate_standard_province_adjacencies();
+		void _build_adjacency_graph();
+		/* Warns about unrecognised province colours and provinces missing from the province image. */
+		void _log_map_image_warnings(bool detailed_errors) const;
 
 		inline constexpr int32_t get_pixel_index_from_pos(ivec2_t pos) const {
 			return pos.x + pos.y * dims.x;
@@ -120,7 +131,17 @@ namespace OpenVic {
 		bool load_province_positions(BuildingTypeManager const& building_type_manager, ast::NodeCPtr root);
 		static bool load_region_colours(ast::NodeCPtr root, std::vector<colour_t>& colours);
 		bool load_region_file(ast::NodeCPtr root, std::vector<colour_t> const& colours);
-		bool load_map_images(fs::path const& province_path, fs::path const& terrain_path, fs::path const& rivers_path, bool detailed_errors);
+		/* The pixel pass is split into bands of rows processed in parallel on thread_pool. */
+		bool load_map_images(
+			fs::path const& province_path, fs::path const& terrain_path, fs::path const& rivers_path, ThreadPool& thread_pool,
+			bool detailed_errors
+		);
+		/* Store or restore everything generated by load_map_images: the shape image, each province's default terrain type,
+		 * centre and whether it's on the map, the rivers and the unrecognised province colours. Reading has the same
+		 * requirements as load_map_images, logs the same warnings, and leaves the map unchanged if the cached data doesn't
+		 * fit the current provinces and terrain types. */
+		void write_map_images_cache(DefinitionCache::Writer& writer) const;
+		bool read_map_images_cache(DefinitionCache::Reader& reader, bool detailed_errors);
 		bool generate_and_load_province_adjacencies(std::vector<ovdl::csv::LineObject> const& additional_adjacencies);
 		bool load_climate_file(ModifierManager const& modifier_manager, ast::NodeCPtr root);
 		bool load_continent_file(ModifierManager const& modifier_manager, ast::NodeCPtr root);
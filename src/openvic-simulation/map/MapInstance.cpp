@@ -3,12 +3,14 @@
 #include "openvic-simulation/history/ProvinceHistory.hpp"
 #include "openvic-simulation/map/MapDefinition.hpp"
 #include "openvic-simulation/utility/Logger.hpp"
+#include "openvic-simulation/utility/Profiler.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
 
 using namespace OpenVic;
 
 MapInstance::MapInstance(MapDefinition const& new_map_definition)
   : map_definition { new_map_definition }, selected_province { nullptr }, highest_province_population { 0 },
-	total_map_population { 0 } {}
+	total_map_population { 0 }, pathfinder { new_map_definition } {}
 
 ProvinceInstance& MapInstance::get_province_instance_from_definition(ProvinceDefinition const& province) {
 	return province_instances.get_items()[province.get_index() - 1];
@@ -44,7 +46,9 @@ ProvinceDefinition::index_t MapInstance::get_selected_province_index() const {
 bool MapInstance::setup(
 	BuildingTypeManager const& building_type_manager,
 	decltype(ProvinceInstance::pop_type_distribution)::keys_t const& pop_type_keys,
-	decltype(ProvinceInstance::ideology_distribution)::keys_t const& ideology_keys
+	decltype(ProvinceInstance::ideology_distribution)::keys_t const& ideology_keys,
+	std::vector<Culture> const& culture_keys, std::vector<Religion> const& religion_keys,
+	IssueManager const& issue_manager, ModifierManager const& modifier_manager
 ) {
 	if (province_instances_are_locked()) {
 		Logger::error("Cannot setup map - province instances are locked!");
@@ -55,12 +59,12 @@ bool MapInstance::setup(
 		return false;
 	}
 
-	bool ret = true;
+	bool ret = pop_store.setup(pop_type_keys, culture_keys, religion_keys, ideology_keys, issue_manager);
 
 	province_instances.reserve(map_definition.get_province_definition_count());
 
 	for (ProvinceDefinition const& province : map_definition.get_province_definitions()) {
-		ret &= province_instances.add_item({ province, pop_type_keys, ideology_keys });
+		ret &= province_instances.add_item({ province, pop_store, pop_type_keys, ideology_keys });
 	}
 
 	province_instances.lock();
@@ -77,15 +81,22 @@ bool MapInstance::setup(
 		return false;
 	}
 
+	ret &= pathfinder.setup(modifier_manager);
+
 	return ret;
 }
 
 bool MapInstance::apply_history_to_provinces(
 	ProvinceHistoryManager const& history_manager, Date date, CountryInstanceManager& country_manager,
-	IssueManager const& issue_manager
+	IssueManager const& issue_manager, uint64_t random_seed
 ) {
 	bool ret = true;
 
+	/* The most recent pop history entry for each province, with pops added once all history has been applied so that
+	 * the pop store can be allocated up front. Pops are added one province at a time so each province's are contiguous. */
+	std::vector<std::pair<ProvinceInstance*, ProvinceHistoryEntry const*>> pop_history_entries;
+	size_t total_pop_count = 0;
+
 	for (ProvinceInstance& province : province_instances.get_items()) {
 		ProvinceDefinition const& province_definition = province.get_province_definition();
 		if (!province_definition.is_water()) {
@@ -94,35 +105,61 @@ bool MapInstance::apply_history_to_provinces(
 			if (history_map != nullptr) {
 				ProvinceHistoryEntry const* pop_history_entry = nullptr;
 
-				for (auto const& [entry_date, entry] : history_map->get_entries()) {
-					if (entry_date > date) {
-						break;
-					}
+				/* Bookmark dates have all of their history folded into a single snapshot entry, other dates are replayed. */
+				ProvinceHistoryEntry const* snapshot = history_map->get_snapshot(date);
+				if (snapshot != nullptr) {
+					province.apply_history_to_province(*snapshot, country_manager);
 
-					province.apply_history_to_province(*entry, country_manager);
+					if (!snapshot->get_pops().empty()) {
+						pop_history_entry = snapshot;
+					}
+				} else {
+					for (ProvinceHistoryEntry const& entry : history_map->get_entries_up_to(date)) {
+						province.apply_history_to_province(entry, country_manager);
 
-					if (!entry->get_pops().empty()) {
-						pop_history_entry = entry.get();
+						if (!entry.get_pops().empty()) {
+							pop_history_entry = &entry;
+						}
 					}
 				}
 
 				if (pop_history_entry != nullptr) {
-					province.add_pop_vec(pop_history_entry->get_pops());
-
-					province.setup_pop_test_values(issue_manager);
+					pop_history_entries.emplace_back(&province, pop_history_entry);
+					total_pop_count += pop_history_entry->get_pops().size();
 				}
 			}
 		}
 	}
 
+	pop_store.reserve(pop_store.get_pop_count() + total_pop_count);
+
+	for (auto const& [province, pop_history_entry] : pop_history_entries) {
+		ret &= province->add_pop_vec(pop_history_entry->get_pops());
+
+		province->setup_pop_test_values(issue_manager, random_seed, date);
+	}
+
+	/* History can change province terrain types. */
+	pathfinder.update_movement_costs(*this);
+
 	return ret;
 }
 
-void MapInstance::update_gamestate(Date today, DefineManager const& define_manager) {
-	for (ProvinceInstance& province : province_instances.get_items()) {
-		province.update_gamestate(today, define_manager);
+void MapInstance::update_gamestate(
+	Date today, DefineManager const& define_manager, ThreadPool& thread_pool, Profiler& profiler
+) {
+	thread_pool.parallel_for_each(
+		province_instances.get_items(), [today, &define_manager, &profiler](ProvinceInstance& province) -> void {
+			if (province.is_gamestate_dirty()) {
+				province.update_gamestate(today, define_manager, profiler);
+			}
+		}
+	);
+
+	{
+		const Profiler::ScopedTimer timer { profiler, Profiler::phase_t::STATE_UPDATE };
+		state_manager.update_gamestate();
 	}
-	state_manager.update_gamestate();
 
 	// Update population stats
 	highest_province_population = 0;
@@ -139,8 +176,21 @@ void MapInstance::update_gamestate(Date today, DefineManager const& define_manag
 	}
 }
 
-void MapInstance::tick(Date today) {
+void MapInstance::mark_all_gamestate_dirty() {
 	for (ProvinceInstance& province : province_instances.get_items()) {
+		province.mark_gamestate_dirty();
+	}
+}
+
+void MapInstance::tick(Date today, ThreadPool& thread_pool) {
+	thread_pool.parallel_for_each(province_instances.get_items(), [today](ProvinceInstance& province) -> void {
 		province.tick(today);
+	});
+
+	/* Provinces only set their own dirty flag while ticking in parallel, so their states and owners are marked here. */
+	for (ProvinceInstance& province : province_instances.get_items()) {
+		if (province.is_gamestate_dirty()) {
+			province.mark_gamestate_dirty();
+		}
 	}
 }
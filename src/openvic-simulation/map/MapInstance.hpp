@@ -2,7 +2,9 @@
 
 #include "openvic-simulation/map/ProvinceDefinition.hpp"
 #include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/map/ProvincePathfinder.hpp"
 #include "openvic-simulation/map/State.hpp"
+#include "openvic-simulation/pop/PopStore.hpp"
 #include "openvic-simulation/types/Date.hpp"
 #include "openvic-simulation/types/IdentifierRegistry.hpp"
 
@@ -11,6 +13,9 @@ namespace OpenVic {
 	struct BuildingTypeManager;
 	struct ProvinceHistoryManager;
 	struct IssueManager;
+	struct ModifierManager;
+	struct ThreadPool;
+	struct Profiler;
 
 	/* REQUIREMENTS:
 	 * MAP-4
@@ -18,6 +23,9 @@ namespace OpenVic {
 	struct MapInstance {
 		MapDefinition const& PROPERTY(map_definition);
 
+		/* Every province's pops, stored contiguously province by province. */
+		PopStore PROPERTY_REF(pop_store);
+
 		IdentifierRegistry<ProvinceInstance> IDENTIFIER_REGISTRY_CUSTOM_INDEX_OFFSET(province_instance, 1);
 
 		ProvinceInstance* PROPERTY(selected_province); // is it right for this to be mutable? how about using an index instead?
@@ -26,6 +34,9 @@ namespace OpenVic {
 
 		StateManager PROPERTY_REF(state_manager);
 
+		/* Movement costs are read from province terrain once history has been applied. */
+		ProvincePathfinder PROPERTY_REF(pathfinder);
+
 	public:
 		MapInstance(MapDefinition const& new_map_definition);
 
@@ -45,14 +56,25 @@ namespace OpenVic {
 		bool setup(
 			BuildingTypeManager const& building_type_manager,
 			decltype(ProvinceInstance::pop_type_distribution)::keys_t const& pop_type_keys,
-			decltype(ProvinceInstance::ideology_distribution)::keys_t const& ideology_keys
+			decltype(ProvinceInstance::ideology_distribution)::keys_t const& ideology_keys,
+			std::vector<Culture> const& culture_keys, std::vector<Religion> const& religion_keys,
+			IssueManager const& issue_manager, ModifierManager const& modifier_manager
 		);
 		bool apply_history_to_provinces(
 			ProvinceHistoryManager const& history_manager, Date date, CountryInstanceManager& country_manager,
-			IssueManager const& issue_manager
+			IssueManager const& issue_manager, uint64_t random_seed
 		);
 
-		void update_gamestate(Date today, DefineManager const& define_manager);
-		void tick(Date today);
+		/* Province and building updates are split across the thread pool's threads, as each province only writes to its
+		 * own data. Anything combining values from multiple provinces is done serially afterwards. Only provinces and states
+		 * marked as dirty are updated. */
+		void update_gamestate(
+			Date today, DefineManager const& define_manager, ThreadPool& thread_pool, Profiler& profiler
+		);
+		/* Marks every province, along with their states and owners, as needing a gamestate update. */
+		void mark_all_gamestate_dirty();
+		/* Ticks provinces across the thread pool's threads, then marks those whose buildings changed or are still
+		 * expanding, along with their states and owners, as needing a gamestate update. */
+		void tick(Date today, ThreadPool& thread_pool);
 	};
 }
@@ -1,10 +1,13 @@
 #include "Mapmode.hpp"
 
+#include <algorithm>
+
 #include "openvic-simulation/country/CountryInstance.hpp"
 #include "openvic-simulation/map/MapDefinition.hpp"
 #include "openvic-simulation/map/MapInstance.hpp"
 #include "openvic-simulation/map/ProvinceDefinition.hpp"
 #include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/utility/ThreadPool.hpp"
 #include "openvic-simulation/utility/Utility.hpp"
 
 using namespace OpenVic;
@@ -13,42 +16,69 @@ using namespace OpenVic::colour_literals;
 Mapmode::Mapmode(
 	std::string_view new_identifier,
 	index_t new_index,
-	colour_func_t new_colour_func
+	batch_colour_func_t new_batch_colour_func,
+	bool new_province_local
 ) : HasIdentifier { new_identifier },
 	HasIndex { new_index },
-	colour_func { new_colour_func } {}
+	batch_colour_func { new_batch_colour_func },
+	province_local { new_province_local } {}
 
 const Mapmode Mapmode::ERROR_MAPMODE {
-	"mapmode_error", 0, [](MapInstance const&, ProvinceInstance const& province) -> base_stripe_t {
-		return { 0xFFFF0000_argb, colour_argb_t::null() };
-	}
+	"mapmode_error", 0, make_batch_colour_func(
+		[](MapInstance const&, ProvinceInstance const& province) -> base_stripe_t {
+			return { 0xFFFF0000_argb, colour_argb_t::null() };
+		}
+	), true
 };
 
 Mapmode::base_stripe_t Mapmode::get_base_stripe_colours(
 	MapInstance const& map_instance, ProvinceInstance const& province
 ) const {
-	return colour_func ? colour_func(map_instance, province) : colour_argb_t::null();
+	base_stripe_t colours = colour_argb_t::null();
+	get_base_stripe_colours(map_instance, { &province, 1 }, &colours);
+	return colours;
 }
 
-bool MapmodeManager::add_mapmode(std::string_view identifier, Mapmode::colour_func_t colour_func) {
-	if (identifier.empty()) {
-		Logger::error("Invalid mapmode identifier - empty!");
-		return false;
+void Mapmode::get_base_stripe_colours(
+	MapInstance const& map_instance, std::span<const ProvinceInstance> provinces, base_stripe_t* target
+) const {
+	if (batch_colour_func) {
+		batch_colour_func(map_instance, provinces, target);
+	} else {
+		std::fill_n(target, provinces.size(), colour_argb_t::null());
 	}
+}
+
+void MapmodeManager::target_state_t::invalidate() {
+	mapmode = nullptr;
+	map_instance = nullptr;
+	province_revisions.clear();
+}
+
+bool MapmodeManager::add_mapmode(std::string_view identifier, Mapmode::colour_func_t colour_func) {
 	if (colour_func == nullptr) {
 		Logger::error("Mapmode colour function is null for identifier: ", identifier);
 		return false;
 	}
-	return mapmodes.add_item({ identifier, mapmodes.size(), colour_func });
+	/* Nothing is known about what an arbitrary colour function reads, so it can't be treated as province local. */
+	return add_mapmode(identifier, Mapmode::make_batch_colour_func(std::move(colour_func)), false);
 }
 
-bool MapmodeManager::generate_mapmode_colours(MapInstance const& map_instance, Mapmode::index_t index, uint8_t* target) const {
-	if (target == nullptr) {
-		Logger::error("Mapmode colour target pointer is null!");
+bool MapmodeManager::add_mapmode(
+	std::string_view identifier, Mapmode::batch_colour_func_t batch_colour_func, bool province_local
+) {
+	if (identifier.empty()) {
+		Logger::error("Invalid mapmode identifier - empty!");
 		return false;
 	}
+	if (batch_colour_func == nullptr) {
+		Logger::error("Mapmode colour function is null for identifier: ", identifier);
+		return false;
+	}
+	return mapmodes.add_item({ identifier, mapmodes.size(), std::move(batch_colour_func), province_local });
+}
 
-	bool ret = true;
+Mapmode const& MapmodeManager::_get_mapmode_or_error(Mapmode::index_t index, bool& ret) const {
 	Mapmode const* mapmode = get_mapmode_by_index(index);
 	if (mapmode == nullptr) {
 		// Not an error if mapmodes haven't yet been loaded,
@@ -60,24 +90,108 @@ bool MapmodeManager::generate_mapmode_colours(MapInstance const& map_instance, M
 		}
 		mapmode = &Mapmode::ERROR_MAPMODE;
 	}
+	return *mapmode;
+}
+
+bool MapmodeManager::generate_mapmode_colours(
+	MapInstance const& map_instance, Mapmode::index_t index, uint8_t* target, ThreadPool* thread_pool
+) const {
+	if (target == nullptr) {
+		Logger::error("Mapmode colour target pointer is null!");
+		return false;
+	}
+
+	bool ret = true;
+	Mapmode const& mapmode = _get_mapmode_or_error(index, ret);
 
 	Mapmode::base_stripe_t* target_stripes = reinterpret_cast<Mapmode::base_stripe_t*>(target);
 
 	target_stripes[ProvinceDefinition::NULL_INDEX] = colour_argb_t::null();
 
 	if (map_instance.province_instances_are_locked()) {
-		for (ProvinceInstance const& province : map_instance.get_province_instances()) {
-			target_stripes[province.get_province_definition().get_index()] =
-				mapmode->get_base_stripe_colours(map_instance, province);
+		/* Province instances are stored in index order, starting from NULL_INDEX + 1. */
+		std::span<const ProvinceInstance> provinces = map_instance.get_province_instances();
+		Mapmode::base_stripe_t* province_stripes = target_stripes + ProvinceDefinition::NULL_INDEX + 1;
+
+		const auto fill_range = [&mapmode, &map_instance, provinces, province_stripes](size_t begin, size_t end) -> void {
+			mapmode.get_base_stripe_colours(map_instance, provinces.subspan(begin, end - begin), province_stripes + begin);
+		};
+
+		if (thread_pool != nullptr) {
+			thread_pool->parallel_for(provinces.size(), fill_range);
+		} else {
+			fill_range(0, provinces.size());
 		}
 	} else {
-		for (
-			size_t index = ProvinceDefinition::NULL_INDEX + 1;
-			index <= map_instance.get_map_definition().get_province_definition_count();
-			++index
-		) {
-			target_stripes[index] = colour_argb_t::null();
+		std::fill_n(
+			target_stripes + ProvinceDefinition::NULL_INDEX + 1,
+			map_instance.get_map_definition().get_province_definition_count(), colour_argb_t::null()
+		);
+	}
+
+	return ret;
+}
+
+bool MapmodeManager::update_mapmode_colours(
+	MapInstance const& map_instance, Mapmode::index_t index, uint8_t* target, target_state_t& target_state,
+	ThreadPool* thread_pool
+) const {
+	if (target == nullptr) {
+		Logger::error("Mapmode colour target pointer is null!");
+		return false;
+	}
+
+	bool ret = true;
+	Mapmode const& mapmode = _get_mapmode_or_error(index, ret);
+
+	std::span<const ProvinceInstance> provinces;
+	if (map_instance.province_instances_are_locked()) {
+		provinces = map_instance.get_province_instances();
+	}
+
+	if (
+		!mapmode.is_province_local() || target_state.mapmode != &mapmode || target_state.map_instance != &map_instance ||
+		target_state.province_revisions.size() != provinces.size() || provinces.empty()
+	) {
+		ret &= generate_mapmode_colours(map_instance, index, target, thread_pool);
+
+		target_state.mapmode = &mapmode;
+		target_state.map_instance = &map_instance;
+		target_state.province_revisions.resize(provinces.size());
+		for (size_t province_index = 0; province_index < provinces.size(); ++province_index) {
+			target_state.province_revisions[province_index] = provinces[province_index].get_revision();
+		}
+
+		return ret;
+	}
+
+	Mapmode::base_stripe_t* province_stripes =
+		reinterpret_cast<Mapmode::base_stripe_t*>(target) + ProvinceDefinition::NULL_INDEX + 1;
+	std::vector<uint32_t>& province_revisions = target_state.province_revisions;
+
+	/* Changed provinces are coloured in runs, so neighbouring changes still share a single batch call. */
+	const auto update_range = [&mapmode, &map_instance, provinces, province_stripes, &province_revisions](
+		size_t begin, size_t end
+	) -> void {
+		size_t run_begin = begin;
+		for (size_t province_index = begin; province_index <= end; ++province_index) {
+			if (province_index < end && province_revisions[province_index] != provinces[province_index].get_revision()) {
+				province_revisions[province_index] = provinces[province_index].get_revision();
+				continue;
+			}
+			if (run_begin < province_index) {
+				mapmode.get_base_stripe_colours(
+					map_instance, provinces.subspan(run_begin, province_index - run_begin), province_stripes + run_begin
+				);
+			}
+			run_begin = province_index + 1;
 		}
+	};
+
+	if (thread_pool != nullptr) {
+		thread_pool->parallel_for(provinces.size(), update_range);
+	} else {
+		update_range(0, provinces.size());
 	}
 
 	return ret;
@@ -115,15 +229,15 @@ static constexpr auto get_colour_mapmode(T const*(P::*get_item)() const) {
 }
 
 template<HasGetColour T>
-static constexpr Mapmode::base_stripe_t shaded_mapmode(fixed_point_map_t<T const*> const& map) {
-	const std::pair<fixed_point_map_const_iterator_t<T const*>, fixed_point_map_const_iterator_t<T const*>> largest =
-		get_largest_two_items(map);
-	if (largest.first != map.end()) {
-		const colour_argb_t base_colour = colour_argb_t { largest.first->first->get_colour(), ALPHA_VALUE };
-		if (largest.second != map.end()) {
+static constexpr Mapmode::base_stripe_t shaded_mapmode(SparseIndexedMap<T, fixed_point_t> const& map) {
+	using map_t = SparseIndexedMap<T, fixed_point_t>;
+	const std::pair<size_t, size_t> largest = map.get_largest_two_indices();
+	if (largest.first != map_t::NO_INDEX) {
+		const colour_argb_t base_colour = colour_argb_t { map(largest.first).get_colour(), ALPHA_VALUE };
+		if (largest.second != map_t::NO_INDEX) {
 			/* If second largest is at least a third... */
-			if (largest.second->second * 3 >= get_total(map)) {
-				const colour_argb_t stripe_colour = colour_argb_t { largest.second->first->get_colour(), ALPHA_VALUE };
+			if (map.get_value(largest.second) * 3 >= map.get_total()) {
+				const colour_argb_t stripe_colour = colour_argb_t { map(largest.second).get_colour(), ALPHA_VALUE };
 				return { base_colour, stripe_colour };
 			}
 		}
@@ -133,7 +247,7 @@ static constexpr Mapmode::base_stripe_t shaded_mapmode(fixed_point_map_t<T const
 }
 
 template<HasGetColour T>
-static constexpr auto shaded_mapmode(fixed_point_map_t<T const*> const&(ProvinceInstance::*get_map)() const) {
+static constexpr auto shaded_mapmode(SparseIndexedMap<T, fixed_point_t> const&(ProvinceInstance::*get_map)() const) {
 	return [get_map](MapInstance const&, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
 		return shaded_mapmode((province.*get_map)());
 	};
@@ -142,145 +256,171 @@ static constexpr auto shaded_mapmode(fixed_point_map_t<T const*> const&(Province
 bool MapmodeManager::setup_mapmodes() {
 	bool ret = true;
 
-	using mapmode_definition_t = std::pair<std::string, Mapmode::colour_func_t>;
+	struct mapmode_definition_t {
+		std::string_view identifier;
+		Mapmode::batch_colour_func_t batch_colour_func;
+		/* Whether each province's colours only depend on that province, see Mapmode::is_province_local. */
+		bool province_local;
+	};
 	const std::vector<mapmode_definition_t> mapmode_definitions {
 		{
 			"mapmode_terrain",
-			[](MapInstance const&, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
-				return colour_argb_t::null();
-			}
+			Mapmode::make_batch_colour_func(
+				[](MapInstance const&, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
+					return colour_argb_t::null();
+				}
+			), true
 		},
 		{
-			"mapmode_political", get_colour_mapmode(&ProvinceInstance::get_owner)
+			"mapmode_political",
+			Mapmode::make_batch_colour_func(get_colour_mapmode(&ProvinceInstance::get_owner)), true
 		},
 		{
 			/* TEST MAPMODE, TO BE REMOVED */
 			"mapmode_province",
-			[](MapInstance const&, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
-				return colour_argb_t { province.get_province_definition().get_colour(), ALPHA_VALUE };
-			}
+			Mapmode::make_batch_colour_func(
+				[](MapInstance const&, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
+					return colour_argb_t { province.get_province_definition().get_colour(), ALPHA_VALUE };
+				}
+			), true
 		},
 		{
-			"mapmode_region", get_colour_mapmode(&ProvinceDefinition::get_region)
+			"mapmode_region",
+			Mapmode::make_batch_colour_func(get_colour_mapmode(&ProvinceDefinition::get_region)), true
 		},
 		{
 			/* TEST MAPMODE, TO BE REMOVED */
 			"mapmode_index",
-			[](MapInstance const& map_instance, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
-				const colour_argb_t::value_type f = colour_argb_t::colour_traits::component_from_fraction(
-					province.get_province_definition().get_index(),
-					map_instance.get_map_definition().get_province_definition_count() + 1
-				);
-				return colour_argb_t::fill_as(f).with_alpha(ALPHA_VALUE);
-			}
+			Mapmode::make_batch_colour_func(
+				[](MapInstance const& map_instance, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
+					const colour_argb_t::value_type f = colour_argb_t::colour_traits::component_from_fraction(
+						province.get_province_definition().get_index(),
+						map_instance.get_map_definition().get_province_definition_count() + 1
+					);
+					return colour_argb_t::fill_as(f).with_alpha(ALPHA_VALUE);
+				}
+			), true
 		},
 		{
 			/* Non-vanilla mapmode, still of use in game. */
-			"mapmode_terrain_type", get_colour_mapmode(&ProvinceInstance::get_terrain_type)
+			"mapmode_terrain_type",
+			Mapmode::make_batch_colour_func(get_colour_mapmode(&ProvinceInstance::get_terrain_type)), true
 		},
 		{
-			"mapmode_rgo", get_colour_mapmode(&ProvinceInstance::get_rgo)
+			"mapmode_rgo",
+			Mapmode::make_batch_colour_func(get_colour_mapmode(&ProvinceInstance::get_rgo)), true
 		},
 		{
 			"mapmode_infrastructure",
-			[](MapInstance const&, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
-				BuildingInstance const* railroad = province.get_building_by_identifier("railroad");
-				if (railroad != nullptr) {
-					const colour_argb_t::value_type val = colour_argb_t::colour_traits::component_from_fraction(
-						railroad->get_level(), railroad->get_building_type().get_max_level() + 1, 0.5f, 1.0f
-					);
-					switch (railroad->get_expansion_state()) {
-					case BuildingInstance::ExpansionState::CannotExpand:
-						return colour_argb_t { val, 0, 0, ALPHA_VALUE };
-					case BuildingInstance::ExpansionState::CanExpand:
-						return colour_argb_t { 0, 0, val, ALPHA_VALUE };
-					default:
-						return colour_argb_t { 0, val, 0, ALPHA_VALUE };
+			Mapmode::make_batch_colour_func(
+				[](MapInstance const&, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
+					BuildingInstance const* railroad = province.get_building_by_identifier("railroad");
+					if (railroad != nullptr) {
+						const colour_argb_t::value_type val = colour_argb_t::colour_traits::component_from_fraction(
+							railroad->get_level(), railroad->get_building_type().get_max_level() + 1, 0.5f, 1.0f
+						);
+						switch (railroad->get_expansion_state()) {
+						case BuildingInstance::ExpansionState::CannotExpand:
+							return colour_argb_t { val, 0, 0, ALPHA_VALUE };
+						case BuildingInstance::ExpansionState::CanExpand:
+							return colour_argb_t { 0, 0, val, ALPHA_VALUE };
+						default:
+							return colour_argb_t { 0, val, 0, ALPHA_VALUE };
+						}
 					}
+					return colour_argb_t::null();
 				}
-				return colour_argb_t::null();
-			}
+			), true
 		},
 		{
 			"mapmode_population",
-			[](MapInstance const& map_instance, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
-				// TODO - explore non-linear scaling to have more variation among non-massive provinces
-				// TODO - when selecting a province, only show the population of provinces controlled (or owned?)
-				// by the same country, relative to the most populous province in that set of provinces
-				if (!province.get_province_definition().is_water()) {
-					const colour_argb_t::value_type val = colour_argb_t::colour_traits::component_from_fraction(
-						province.get_total_population(), map_instance.get_highest_province_population() + 1, 0.1f, 1.0f
-					);
-					return colour_argb_t { 0, val, 0, ALPHA_VALUE };
-				} else {
-					return colour_argb_t::null();
+			Mapmode::make_batch_colour_func(
+				[](MapInstance const& map_instance, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
+					// TODO - explore non-linear scaling to have more variation among non-massive provinces
+					// TODO - when selecting a province, only show the population of provinces controlled (or owned?)
+					// by the same country, relative to the most populous province in that set of provinces
+					if (!province.get_province_definition().is_water()) {
+						const colour_argb_t::value_type val = colour_argb_t::colour_traits::component_from_fraction(
+							province.get_total_population(), map_instance.get_highest_province_population() + 1, 0.1f, 1.0f
+						);
+						return colour_argb_t { 0, val, 0, ALPHA_VALUE };
+					} else {
+						return colour_argb_t::null();
+					}
 				}
-			}
+			), false
 		},
 		{
-			"mapmode_culture", shaded_mapmode(&ProvinceInstance::get_culture_distribution)
+			"mapmode_culture",
+			Mapmode::make_batch_colour_func(shaded_mapmode(&ProvinceInstance::get_culture_distribution)), true
 		},
 		{
 			/* Non-vanilla mapmode, still of use in game. */
-			"mapmode_religion", shaded_mapmode(&ProvinceInstance::get_religion_distribution)
+			"mapmode_religion",
+			Mapmode::make_batch_colour_func(shaded_mapmode(&ProvinceInstance::get_religion_distribution)), true
 		},
 		{
 			/* TEST MAPMODE, TO BE REMOVED */
 			"mapmode_adjacencies",
-			[](MapInstance const& map_instance, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
-				ProvinceInstance const* selected_province = map_instance.get_selected_province();
+			Mapmode::make_batch_colour_func(
+				[](MapInstance const& map_instance, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
+					ProvinceInstance const* selected_province = map_instance.get_selected_province();
 
-				if (selected_province != nullptr) {
-					ProvinceDefinition const& selected_province_definition = selected_province->get_province_definition();
+					if (selected_province != nullptr) {
+						ProvinceDefinition const& selected_province_definition = selected_province->get_province_definition();
 
-					if (selected_province == &province) {
-						return (0xFFFFFF_argb).with_alpha(ALPHA_VALUE);
-					}
+						if (selected_province == &province) {
+							return (0xFFFFFF_argb).with_alpha(ALPHA_VALUE);
+						}
 
-					ProvinceDefinition const* province_definition = &province.get_province_definition();
-
-					colour_argb_t base = colour_argb_t::null(), stripe = colour_argb_t::null();
-					ProvinceDefinition::adjacency_t const* adj =
-						selected_province_definition.get_adjacency_to(province_definition);
-
-					if (adj != nullptr) {
-						colour_argb_t::integer_type base_int;
-						switch (adj->get_type()) {
-							using enum ProvinceDefinition::adjacency_t::type_t;
-						case LAND:       base_int = 0x00FF00; break;
-						case WATER:      base_int = 0x0000FF; break;
-						case COASTAL:    base_int = 0xF9D199; break;
-						case IMPASSABLE: base_int = 0x8B4513; break;
-						case STRAIT:     base_int = 0x00FFFF; break;
-						case CANAL:      base_int = 0x888888; break;
-						default:         base_int = 0xFF0000; break;
+						ProvinceDefinition const* province_definition = &province.get_province_definition();
+
+						colour_argb_t base = colour_argb_t::null(), stripe = colour_argb_t::null();
+						ProvinceDefinition::adjacency_t const* adj = map_instance.get_map_definition().get_adjacency_graph()
+							.get_adjacency(selected_province_definition, *province_definition);
+
+						if (adj != nullptr) {
+							colour_argb_t::integer_type base_int;
+							switch (adj->get_type()) {
+								using enum ProvinceDefinition::adjacency_t::type_t;
+							case LAND:       base_int = 0x00FF00; break;
+							case WATER:      base_int = 0x0000FF; break;
+							case COASTAL:    base_int = 0xF9D199; break;
+							case IMPASSABLE: base_int = 0x8B4513; break;
+							case STRAIT:     base_int = 0x00FFFF; break;
+							case CANAL:      base_int = 0x888888; break;
+							default:         base_int = 0xFF0000; break;
+							}
+							base = colour_argb_t::from_integer(base_int).with_alpha(ALPHA_VALUE);
+							stripe = base;
+						}
+
+						if (selected_province_definition.has_adjacency_going_through(province_definition)) {
+							stripe = (0xFFFF00_argb).with_alpha(ALPHA_VALUE);
 						}
-						base = colour_argb_t::from_integer(base_int).with_alpha(ALPHA_VALUE);
-						stripe = base;
-					}
 
-					if (selected_province_definition.has_adjacency_going_through(province_definition)) {
-						stripe = (0xFFFF00_argb).with_alpha(ALPHA_VALUE);
+						return { base, stripe };
 					}
 
-					return { base, stripe };
+					return colour_argb_t::null();
 				}
-
-				return colour_argb_t::null();
-			}
+			), false
 		},
 		{
-			"mapmode_port", [](MapInstance const&, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
-				ProvinceDefinition const& province_definition = province.get_province_definition();
-
-				if (province_definition.has_port()) {
-					return (0xFFFFFF_argb).with_alpha(ALPHA_VALUE);
-				} else if (!province_definition.is_water()) {
-					return (0x333333_argb).with_alpha(ALPHA_VALUE);
-				} else {
-					return colour_argb_t::null();
+			"mapmode_port",
+			Mapmode::make_batch_colour_func(
+				[](MapInstance const&, ProvinceInstance const& province) -> Mapmode::base_stripe_t {
+					ProvinceDefinition const& province_definition = province.get_province_definition();
+
+					if (province_definition.has_port()) {
+						return (0xFFFFFF_argb).with_alpha(ALPHA_VALUE);
+					} else if (!province_definition.is_water()) {
+						return (0x333333_argb).with_alpha(ALPHA_VALUE);
+					} else {
+						return colour_argb_t::null();
+					}
 				}
-			}
+			), true
 		}
 	};
 
@@ -288,7 +428,7 @@ bool MapmodeManager::setup_mapmodes() {
 	reserve_mapmodes(mapmode_definitions.size());
 
 	for (mapmode_definition_t const& mapmode : mapmode_definitions) {
-		ret &= add_mapmode(mapmode.first, mapmode.second);
+		ret &= add_mapmode(mapmode.identifier, mapmode.batch_colour_func, mapmode.province_local);
 	}
 
 	lock_mapmodes();
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
+#include <span>
+#include <vector>
 
 #include "openvic-simulation/types/Colour.hpp"
 #include "openvic-simulation/types/HasIdentifier.hpp"
@@ -10,6 +13,7 @@ namespace OpenVic {
 	struct MapmodeManager;
 	struct MapInstance;
 	struct ProvinceInstance;
+	struct ThreadPool;
 
 	struct Mapmode : HasIdentifier, HasIndex<> {
 		friend struct MapmodeManager;
@@ -22,13 +26,37 @@ namespace OpenVic {
 			constexpr base_stripe_t(colour_argb_t base, colour_argb_t stripe)
 				: base_colour { base }, stripe_colour { stripe } {}
 			constexpr base_stripe_t(colour_argb_t both) : base_stripe_t { both, both } {}
+
+			constexpr bool operator==(base_stripe_t const&) const = default;
 		};
 		using colour_func_t = std::function<base_stripe_t(MapInstance const&, ProvinceInstance const&)>;
+		/* Fills target[i] with the colours of provinces[i], for a contiguous range of provinces. */
+		using batch_colour_func_t =
+			std::function<void(MapInstance const&, std::span<const ProvinceInstance>, base_stripe_t*)>;
+
+		/* Wraps a per-province colour function in a loop over a range of provinces, so when func's type is known (e.g. a
+		 * lambda) it can be inlined rather than called through a std::function for every province. */
+		template<typename Func>
+		static batch_colour_func_t make_batch_colour_func(Func&& func) {
+			return [func = std::forward<Func>(func)](
+				MapInstance const& map_instance, std::span<const ProvinceInstance> provinces, base_stripe_t* target
+			) -> void {
+				for (ProvinceInstance const& province : provinces) {
+					*target++ = func(map_instance, province);
+				}
+			};
+		}
 
 	private:
-		const colour_func_t colour_func;
+		const batch_colour_func_t batch_colour_func;
+		/* Whether each province's colours only depend on that province, rather than also on map-wide state such as the
+		 * selected province or the highest province population. */
+		const bool PROPERTY_CUSTOM_PREFIX(province_local, is);
 
-		Mapmode(std::string_view new_identifier, index_t new_index, colour_func_t new_colour_func);
+		Mapmode(
+			std::string_view new_identifier, index_t new_index, batch_colour_func_t new_batch_colour_func,
+			bool new_province_local
+		);
 
 	public:
 		static const Mapmode ERROR_MAPMODE;
@@ -36,23 +64,55 @@ namespace OpenVic {
 		Mapmode(Mapmode&&) = default;
 
 		base_stripe_t get_base_stripe_colours(MapInstance const& map_instance, ProvinceInstance const& province) const;
+		void get_base_stripe_colours(
+			MapInstance const& map_instance, std::span<const ProvinceInstance> provinces, base_stripe_t* target
+		) const;
 	};
 
 	struct MapmodeManager {
+		/* What was last written to a mapmode colour target by update_mapmode_colours, which should be given the same
+		 * target_state_t every time it is called for a given target. */
+		struct target_state_t {
+			friend struct MapmodeManager;
+
+		private:
+			Mapmode const* mapmode = nullptr;
+			MapInstance const* map_instance = nullptr;
+			/* Each province's ProvinceInstance::revision when its colours were last written, indexed by index - 1. */
+			std::vector<uint32_t> province_revisions;
+
+		public:
+			/* Makes the next update rewrite every province's colours. */
+			void invalidate();
+		};
+
 	private:
 		IdentifierRegistry<Mapmode> IDENTIFIER_REGISTRY(mapmode);
 
+		Mapmode const& _get_mapmode_or_error(Mapmode::index_t index, bool& ret) const;
+
 	public:
 		MapmodeManager() = default;
 
 		bool add_mapmode(std::string_view identifier, Mapmode::colour_func_t colour_func);
+		bool add_mapmode(std::string_view identifier, Mapmode::batch_colour_func_t batch_colour_func, bool province_local);
 
 		/* The mapmode colour image contains of a list of base colours and stripe colours. Each colour is four bytes
 		 * in RGBA format, with the alpha value being used to interpolate with the terrain colour, so A = 0 is fully terrain
 		 * and A = 255 is fully the RGB colour packaged with A. The base and stripe colours for each province are packed
 		 * together adjacently, so each province's entry is 8 bytes long. The list contains ProvinceDefinition::MAX_INDEX + 1
-		 * entries, that is the maximum allowed number of provinces plus one for the index-zero "null province". */
-		bool generate_mapmode_colours(MapInstance const& map_instance, Mapmode::index_t index, uint8_t* target) const;
+		 * entries, that is the maximum allowed number of provinces plus one for the index-zero "null province".
+		 * If thread_pool isn't null, ranges of provinces are coloured in parallel on its threads. */
+		bool generate_mapmode_colours(
+			MapInstance const& map_instance, Mapmode::index_t index, uint8_t* target, ThreadPool* thread_pool = nullptr
+		) const;
+		/* As generate_mapmode_colours, but only rewrites the colours of provinces whose ProvinceInstance::revision has
+		 * changed since target_state was last used, unless the mapmode or map instance is different or the mapmode isn't
+		 * province local, in which case every province is rewritten. */
+		bool update_mapmode_colours(
+			MapInstance const& map_instance, Mapmode::index_t index, uint8_t* target, target_state_t& target_state,
+			ThreadPool* thread_pool = nullptr
+		) const;
 
 		bool setup_mapmodes();
 	};
@@ -0,0 +1,69 @@
+#include "ProvinceAdjacencyGraph.hpp"
+
+using namespace OpenVic;
+
+void ProvinceAdjacencyGraph::build(std::span<const ProvinceDefinition> provinces) {
+	clear();
+
+	size_t edge_count = 0;
+	for (ProvinceDefinition const& province : provinces) {
+		edge_count += province.get_adjacencies().size();
+	}
+
+	edge_offsets.reserve(provinces.size() + 1);
+	edge_targets.reserve(edge_count);
+	edge_adjacencies.reserve(edge_count);
+	edge_lookup.reserve(edge_count);
+
+	edge_offsets.push_back(0);
+	for (ProvinceDefinition const& province : provinces) {
+		for (adjacency_t const& adjacency : province.get_adjacencies()) {
+			const index_t to = adjacency.get_to()->get_index();
+			edge_lookup.emplace(_edge_key(province.get_index(), to), edge_targets.size());
+			edge_targets.push_back(to);
+			edge_adjacencies.push_back(&adjacency);
+		}
+		edge_offsets.push_back(edge_targets.size());
+	}
+}
+
+void ProvinceAdjacencyGraph::clear() {
+	edge_offsets.clear();
+	edge_targets.clear();
+	edge_adjacencies.clear();
+	edge_lookup.clear();
+}
+
+bool ProvinceAdjacencyGraph::is_adjacent(ProvinceDefinition const& from, ProvinceDefinition const& to) const {
+	return edge_lookup.contains(_edge_key(from.get_index(), to.get_index()));
+}
+
+ProvinceAdjacencyGraph::adjacency_t const* ProvinceAdjacencyGraph::get_adjacency(
+	ProvinceDefinition const& from, ProvinceDefinition const& to
+) const {
+	const decltype(edge_lookup)::const_iterator it = edge_lookup.find(_edge_key(from.get_index(), to.get_index()));
+	if (it != edge_lookup.end()) {
+		return edge_adjacencies[it->second];
+	}
+	return nullptr;
+}
+
+std::span<const ProvinceAdjacencyGraph::index_t> ProvinceAdjacencyGraph::get_neighbour_indices(
+	ProvinceDefinition const& province
+) const {
+	const index_t index = province.get_index();
+	if (!_has_province(index)) {
+		return {};
+	}
+	return { edge_targets.data() + edge_offsets[index - 1], edge_targets.data() + edge_offsets[index] };
+}
+
+std::span<ProvinceAdjacencyGraph::adjacency_t const* const> ProvinceAdjacencyGraph::get_adjacencies(
+	ProvinceDefinition const& province
+) const {
+	const index_t index = province.get_index();
+	if (!_has_province(index)) {
+		return {};
+	}
+	return { edge_adjacencies.data() + edge_offsets[index - 1], edge_adjacencies.data() + edge_offsets[index] };
+}
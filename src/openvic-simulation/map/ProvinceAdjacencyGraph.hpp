@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "openvic-simulation/map/ProvinceDefinition.hpp"
+#include "openvic-simulation/types/OrderedContainers.hpp"
+
+namespace OpenVic {
+	/* Compressed sparse row copy of every province's adjacencies, built once all adjacencies have been loaded. Each
+	 * province's edges are stored contiguously for fast neighbour iteration, and every edge is also in a hash map keyed
+	 * by its endpoints, so adjacency checks take constant time instead of searching through a province's adjacencies. */
+	struct ProvinceAdjacencyGraph {
+		using adjacency_t = ProvinceDefinition::adjacency_t;
+		using index_t = ProvinceDefinition::index_t;
+
+	private:
+		/* Province index i's edges are [edge_offsets[i - 1], edge_offsets[i]) in edge_targets and edge_adjacencies. */
+		std::vector<uint32_t> edge_offsets;
+		std::vector<index_t> edge_targets;
+		std::vector<adjacency_t const*> edge_adjacencies;
+		/* Maps each edge's _edge_key to its position in edge_targets and edge_adjacencies. */
+		ordered_map<uint32_t, uint32_t> edge_lookup;
+
+		static_assert(sizeof(index_t) <= sizeof(uint16_t), "Province edge keys must fit both indices in 32 bits");
+
+		static constexpr uint32_t _edge_key(index_t from, index_t to) {
+			return (static_cast<uint32_t>(from) << 16) | to;
+		}
+
+		constexpr bool _has_province(index_t index) const {
+			return index != ProvinceDefinition::NULL_INDEX && index < edge_offsets.size();
+		}
+
+	public:
+		/* The adjacencies are referenced rather than copied, so they must not be changed afterwards. */
+		void build(std::span<const ProvinceDefinition> provinces);
+		void clear();
+
+		constexpr size_t get_edge_count() const {
+			return edge_targets.size();
+		}
+
+		bool is_adjacent(ProvinceDefinition const& from, ProvinceDefinition const& to) const;
+		/* Returns nullptr if there is no adjacency from from to to. */
+		adjacency_t const* get_adjacency(ProvinceDefinition const& from, ProvinceDefinition const& to) const;
+
+		/* The indices of the provinces province has adjacencies to, in the same order as get_adjacencies. */
+		std::span<const index_t> get_neighbour_indices(ProvinceDefinition const& province) const;
+		std::span<adjacency_t const* const> get_adjacencies(ProvinceDefinition const& province) const;
+	};
+}
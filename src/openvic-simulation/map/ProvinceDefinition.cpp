@@ -85,14 +85,15 @@ bool ProvinceDefinition::load_positions(
 			ProvinceDefinition const* province = map_definition.get_province_definition_at(port_facing_position);
 
 			if (province != nullptr) {
-				if (province->is_water() && is_adjacent_to(province)) {
+				const bool adjacent = map_definition.get_adjacency_graph().is_adjacent(*this, *province);
+				if (province->is_water() && adjacent) {
 					port = true;
 					port_adjacent_province = province;
 				} else {
 					/*  Expected provinces with invalid ports: 39, 296, 1047, 1406, 2044 */
 					Logger::warning(
 						"Invalid port for province ", get_identifier(), ": facing province ", province,
-						" which has: water = ", province->is_water(), ", adjacent = ", is_adjacent_to(province)
+						" which has: water = ", province->is_water(), ", adjacent = ", adjacent
 					);
 				}
 			} else {
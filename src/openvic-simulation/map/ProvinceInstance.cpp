@@ -3,14 +3,18 @@
 #include "openvic-simulation/country/CountryInstance.hpp"
 #include "openvic-simulation/history/ProvinceHistory.hpp"
 #include "openvic-simulation/map/ProvinceDefinition.hpp"
+#include "openvic-simulation/map/State.hpp"
 #include "openvic-simulation/military/UnitInstanceGroup.hpp"
 #include "openvic-simulation/misc/Define.hpp"
 #include "openvic-simulation/politics/Ideology.hpp"
+#include "openvic-simulation/utility/Profiler.hpp"
+#include "openvic-simulation/utility/RandomStream.hpp"
 
 using namespace OpenVic;
 
 ProvinceInstance::ProvinceInstance(
-	ProvinceDefinition const& new_province_definition, decltype(pop_type_distribution)::keys_t const& pop_type_keys,
+	ProvinceDefinition const& new_province_definition, PopStore& new_pop_store,
+	decltype(pop_type_distribution)::keys_t const& pop_type_keys,
 	decltype(ideology_distribution)::keys_t const& ideology_keys
 ) : HasIdentifierAndColour { new_province_definition },
 	province_definition { new_province_definition },
@@ -27,18 +31,46 @@ ProvinceInstance::ProvinceInstance(
 	buildings { "buildings", false },
 	armies {},
 	navies {},
-	pops {},
+	pop_store { &new_pop_store },
+	pop_range {},
 	total_population { 0 },
 	pop_type_distribution { &pop_type_keys },
 	ideology_distribution { &ideology_keys },
-	culture_distribution {},
-	religion_distribution {},
-	max_supported_regiments { 0 } {}
+	culture_distribution { new_pop_store.get_culture_keys() },
+	religion_distribution { new_pop_store.get_religion_keys() },
+	max_supported_regiments { 0 },
+	gamestate_dirty { true },
+	revision { 0 } {}
+
+void ProvinceInstance::mark_gamestate_dirty() {
+	gamestate_dirty = true;
+
+	if (state != nullptr) {
+		state->mark_gamestate_dirty();
+	}
+	if (owner != nullptr) {
+		owner->mark_gamestate_dirty();
+	}
+}
+
+void ProvinceInstance::increment_revision() {
+	revision++;
+}
+
+void ProvinceInstance::set_crime(Crime const* new_crime) {
+	if (crime != new_crime) {
+		crime = new_crime;
+		increment_revision();
+	}
+}
 
 bool ProvinceInstance::set_owner(CountryInstance* new_owner) {
 	bool ret = true;
 
 	if (owner != new_owner) {
+		/* Marked both before and after so that the old and new owners are both updated. */
+		mark_gamestate_dirty();
+
 		if (owner != nullptr) {
 			ret &= owner->remove_owned_province(*this);
 		}
@@ -48,6 +80,9 @@ bool ProvinceInstance::set_owner(CountryInstance* new_owner) {
 		if (owner != nullptr) {
 			ret &= owner->add_owned_province(*this);
 		}
+
+		mark_gamestate_dirty();
+		increment_revision();
 	}
 
 	return ret;
@@ -57,6 +92,8 @@ bool ProvinceInstance::set_controller(CountryInstance* new_controller) {
 	bool ret = true;
 
 	if (controller != new_controller) {
+		mark_gamestate_dirty();
+
 		if (controller != nullptr) {
 			ret &= controller->remove_controlled_province(*this);
 		}
@@ -66,6 +103,8 @@ bool ProvinceInstance::set_controller(CountryInstance* new_controller) {
 		if (controller != nullptr) {
 			ret &= controller->add_controlled_province(*this);
 		}
+
+		increment_revision();
 	}
 
 	return ret;
@@ -73,6 +112,8 @@ bool ProvinceInstance::set_controller(CountryInstance* new_controller) {
 
 bool ProvinceInstance::add_core(CountryInstance& new_core) {
 	if (cores.emplace(&new_core).second) {
+		mark_gamestate_dirty();
+		increment_revision();
 		return new_core.add_core_province(*this);
 	} else {
 		Logger::error(
@@ -84,6 +125,8 @@ bool ProvinceInstance::add_core(CountryInstance& new_core) {
 
 bool ProvinceInstance::remove_core(CountryInstance& core_to_remove) {
 	if (cores.erase(&core_to_remove) > 0) {
+		mark_gamestate_dirty();
+		increment_revision();
 		return core_to_remove.remove_core_province(*this);
 	} else {
 		Logger::error(
@@ -104,39 +147,67 @@ bool ProvinceInstance::expand_building(size_t building_index) {
 		Logger::error("Trying to expand non-existent building index ", building_index, " in province ", get_identifier());
 		return false;
 	}
-	return building->expand();
+	mark_gamestate_dirty();
+	if (!building->expand()) {
+		return false;
+	}
+	increment_revision();
+	return true;
 }
 
-void ProvinceInstance::_add_pop(Pop&& pop) {
-	pop.set_location(*this);
-	pops.insert(std::move(pop));
+bool ProvinceInstance::_can_add_pops() const {
+	if (province_definition.is_water()) {
+		Logger::error("Trying to add pops to water province ", get_identifier());
+		return false;
+	}
+	if (!pop_range.empty() && pop_range.end != pop_store->get_pop_count()) {
+		Logger::error(
+			"Trying to add pops to province ", get_identifier(), " after pops have been added to other provinces, its pops ",
+			"would no longer be contiguous!"
+		);
+		return false;
+	}
+	return true;
 }
 
-bool ProvinceInstance::add_pop(Pop&& pop) {
-	if (!province_definition.is_water()) {
-		_add_pop(std::move(pop));
-		return true;
-	} else {
-		Logger::error("Trying to add pop to water province ", get_identifier());
+void ProvinceInstance::_add_pop(PopBase const& pop) {
+	if (pop_range.empty()) {
+		pop_range.begin = pop_range.end = pop_store->get_pop_count();
+	}
+	pop_store->add_pop(pop).set_location(*this);
+	pop_range.end++;
+	mark_gamestate_dirty();
+	increment_revision();
+}
+
+bool ProvinceInstance::add_pop(PopBase const& pop) {
+	if (!_can_add_pops()) {
 		return false;
 	}
+	_add_pop(pop);
+	return true;
 }
 
 bool ProvinceInstance::add_pop_vec(std::vector<PopBase> const& pop_vec) {
-	if (!province_definition.is_water()) {
-		reserve_more(pops, pop_vec.size());
-		for (PopBase const& pop : pop_vec) {
-			_add_pop(Pop { pop, *ideology_distribution.get_keys() });
-		}
-		return true;
-	} else {
-		Logger::error("Trying to add pop vector to water province ", get_identifier());
+	if (!_can_add_pops()) {
 		return false;
 	}
+	for (PopBase const& pop : pop_vec) {
+		_add_pop(pop);
+	}
+	return true;
 }
 
 size_t ProvinceInstance::get_pop_count() const {
-	return pops.size();
+	return pop_range.size();
+}
+
+std::span<Pop> ProvinceInstance::get_pops() {
+	return pop_store->get_pops(pop_range);
+}
+
+std::span<Pop const> ProvinceInstance::get_pops() const {
+	return static_cast<PopStore const*>(pop_store)->get_pops(pop_range);
 }
 
 /* REQUIREMENTS:
@@ -162,18 +233,37 @@ void ProvinceInstance::_update_pops(DefineManager const& define_manager) {
 		: colony_status == COLONY ? define_manager.get_pop_size_per_regiment_colony_multiplier()
 		: is_owner_core() ? fixed_point_t::_1() : define_manager.get_pop_size_per_regiment_non_core_multiplier();
 
-	for (Pop& pop : pops) {
+	std::vector<Pop>& pops = pop_store->get_pops();
+	std::vector<Pop::pop_size_t> const& sizes = pop_store->get_sizes();
+	std::vector<size_t> const& type_indices = pop_store->get_type_indices();
+	std::vector<size_t> const& culture_indices = pop_store->get_culture_indices();
+	std::vector<size_t> const& religion_indices = pop_store->get_religion_indices();
+	std::vector<fixed_point_t> const& literacies = pop_store->get_literacies();
+	std::vector<fixed_point_t> const& consciousnesses = pop_store->get_consciousnesses();
+	std::vector<fixed_point_t> const& militancies = pop_store->get_militancies();
+
+	for (PopStore::pop_index_t index = pop_range.begin; index < pop_range.end; ++index) {
+		Pop& pop = pops[index];
 		pop.update_gamestate(define_manager, owner, pop_size_per_regiment_multiplier);
 
-		total_population += pop.get_size();
-		average_literacy += pop.get_literacy();
-		average_consciousness += pop.get_consciousness();
-		average_militancy += pop.get_militancy();
+		const Pop::pop_size_t pop_size = sizes[index];
 
-		pop_type_distribution[pop.get_type()] += pop.get_size();
-		ideology_distribution += pop.get_ideologies();
-		culture_distribution[&pop.get_culture()] += pop.get_size();
-		religion_distribution[&pop.get_religion()] += pop.get_size();
+		total_population += pop_size;
+		average_literacy += literacies[index];
+		average_consciousness += consciousnesses[index];
+		average_militancy += militancies[index];
+
+		/* Pops whose keys weren't found when they were added have already been logged, so are left out. */
+		if (type_indices[index] != PopStore::NO_KEY_INDEX) {
+			pop_type_distribution[type_indices[index]] += pop_size;
+		}
+		ideology_distribution += static_cast<PopStore const*>(pop_store)->get_ideology_weights(index);
+		if (culture_indices[index] != PopStore::NO_KEY_INDEX) {
+			culture_distribution[culture_indices[index]] += pop_size;
+		}
+		if (religion_indices[index] != PopStore::NO_KEY_INDEX) {
+			religion_distribution[religion_indices[index]] += pop_size;
+		}
 
 		max_supported_regiments += pop.get_max_supported_regiments();
 	}
@@ -185,16 +275,45 @@ void ProvinceInstance::_update_pops(DefineManager const& define_manager) {
 	}
 }
 
-void ProvinceInstance::update_gamestate(Date today, DefineManager const& define_manager) {
+void ProvinceInstance::update_gamestate(Date today, DefineManager const& define_manager, Profiler& profiler) {
+	bool building_state_changed = false;
 	for (BuildingInstance& building : buildings.get_items()) {
+		const BuildingInstance::ExpansionState old_expansion_state = building.get_expansion_state();
 		building.update_gamestate(today);
+		building_state_changed |= building.get_expansion_state() != old_expansion_state;
+	}
+
+	/* Only this province's own revision is touched, as provinces are updated in parallel. */
+	if (building_state_changed) {
+		increment_revision();
+	}
+
+	{
+		const Profiler::ScopedTimer timer { profiler, Profiler::phase_t::PROVINCE_UPDATE_POPS };
+		_update_pops(define_manager);
 	}
-	_update_pops(define_manager);
+
+	gamestate_dirty = false;
 }
 
 void ProvinceInstance::tick(Date today) {
+	bool building_state_changed = false, building_expanding = false;
 	for (BuildingInstance& building : buildings.get_items()) {
+		const BuildingInstance::level_t old_level = building.get_level();
+		const BuildingInstance::ExpansionState old_expansion_state = building.get_expansion_state();
 		building.tick(today);
+		building_state_changed |=
+			building.get_level() != old_level || building.get_expansion_state() != old_expansion_state;
+		building_expanding |= building.get_expansion_state() == BuildingInstance::ExpansionState::Expanding;
+	}
+
+	/* Only this province's own revision and dirty flag are touched, as provinces are ticked in parallel. Expanding
+	 * buildings' progress depends on the date, so they need updating every day until they finish. */
+	if (building_state_changed) {
+		increment_revision();
+	}
+	if (building_state_changed || building_expanding) {
+		gamestate_dirty = true;
 	}
 }
 
@@ -258,6 +377,8 @@ bool ProvinceInstance::setup(BuildingTypeManager const& building_type_manager) {
 bool ProvinceInstance::apply_history_to_province(ProvinceHistoryEntry const& entry, CountryInstanceManager& country_manager) {
 	bool ret = true;
 
+	revision++;
+
 	constexpr auto set_optional = []<typename T>(T& target, std::optional<T> const& source) {
 		if (source) {
 			target = *source;
@@ -299,8 +420,9 @@ bool ProvinceInstance::apply_history_to_province(ProvinceHistoryEntry const& ent
 	return ret;
 }
 
-void ProvinceInstance::setup_pop_test_values(IssueManager const& issue_manager) {
-	for (Pop& pop : pops) {
-		pop.setup_pop_test_values(issue_manager);
+void ProvinceInstance::setup_pop_test_values(IssueManager const& issue_manager, uint64_t random_seed, Date date) {
+	for (Pop& pop : get_pops()) {
+		RandomStream random { random_seed, date, RandomStream::domain_t::POP, pop.get_id() };
+		pop.setup_pop_test_values(issue_manager, random);
 	}
 }
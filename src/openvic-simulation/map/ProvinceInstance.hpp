@@ -1,14 +1,16 @@
 #pragma once
 
-#include <plf_colony.h>
+#include <span>
 
 #include "openvic-simulation/economy/BuildingInstance.hpp"
 #include "openvic-simulation/military/UnitInstance.hpp"
 #include "openvic-simulation/military/UnitType.hpp"
 #include "openvic-simulation/pop/Pop.hpp"
+#include "openvic-simulation/pop/PopStore.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPointMap.hpp"
 #include "openvic-simulation/types/HasIdentifier.hpp"
 #include "openvic-simulation/types/OrderedContainers.hpp"
+#include "openvic-simulation/types/SparseIndexedMap.hpp"
 
 namespace OpenVic {
 	struct MapInstance;
@@ -25,6 +27,7 @@ namespace OpenVic {
 	struct ProvinceHistoryEntry;
 	struct IssueManager;
 	struct CountryInstanceManager;
+	struct Profiler;
 
 	template<UnitType::branch_t>
 	struct UnitInstanceGroup;
@@ -69,7 +72,7 @@ namespace OpenVic {
 		ordered_set<CountryInstance*> PROPERTY(cores);
 
 		bool PROPERTY(slave);
-		Crime const* PROPERTY_RW(crime);
+		Crime const* PROPERTY(crime);
 		// TODO - change this into a factory-like structure
 		GoodDefinition const* PROPERTY(rgo);
 		IdentifierRegistry<BuildingInstance> IDENTIFIER_REGISTRY(building);
@@ -78,7 +81,9 @@ namespace OpenVic {
 
 		UNIT_BRANCHED_GETTER(get_unit_instance_groups, armies, navies);
 
-		plf::colony<Pop> PROPERTY(pops); // TODO - replace with a more easily vectorisable container?
+		PopStore* pop_store;
+		/* This province's pops are the contiguous range of pops in the MapInstance's PopStore. */
+		PopStore::pop_range_t PROPERTY(pop_range);
 		Pop::pop_size_t PROPERTY(total_population);
 		// TODO - population change (growth + migration), monthly totals + breakdown by source/destination
 		fixed_point_t PROPERTY(average_literacy);
@@ -86,16 +91,28 @@ namespace OpenVic {
 		fixed_point_t PROPERTY(average_militancy);
 		IndexedMap<PopType, fixed_point_t> PROPERTY(pop_type_distribution);
 		IndexedMap<Ideology, fixed_point_t> PROPERTY(ideology_distribution);
-		fixed_point_map_t<Culture const*> PROPERTY(culture_distribution);
-		fixed_point_map_t<Religion const*> PROPERTY(religion_distribution);
+		SparseIndexedMap<Culture, fixed_point_t> PROPERTY(culture_distribution);
+		SparseIndexedMap<Religion, fixed_point_t> PROPERTY(religion_distribution);
 		size_t PROPERTY(max_supported_regiments);
 
+		/* Set when something this province's aggregates depend on has changed since its last gamestate update. */
+		bool PROPERTY_CUSTOM_PREFIX(gamestate_dirty, is);
+		/* Incremented whenever something this province displays changes (its owner, controller, cores, pops, crime or
+		 * buildings' levels and expansion states, or history being applied), so data derived from it such as mapmode
+		 * colours can tell when it needs regenerating. Being marked as dirty doesn't increment it, as full gamestate
+		 * updates mark every province dirty without changing what they display. Aggregates such as the culture
+		 * distribution are recalculated by the gamestate update following a change, so derived data should be
+		 * regenerated after that update. */
+		uint32_t PROPERTY(revision);
+
 		ProvinceInstance(
-			ProvinceDefinition const& new_province_definition, decltype(pop_type_distribution)::keys_t const& pop_type_keys,
+			ProvinceDefinition const& new_province_definition, PopStore& new_pop_store,
+			decltype(pop_type_distribution)::keys_t const& pop_type_keys,
 			decltype(ideology_distribution)::keys_t const& ideology_keys
 		);
 
-		void _add_pop(Pop&& pop);
+		bool _can_add_pops() const;
+		void _add_pop(PopBase const& pop);
 		void _update_pops(DefineManager const& define_manager);
 
 	public:
@@ -112,6 +129,13 @@ namespace OpenVic {
 			return controller;
 		}
 
+		/* Marks this province, its state and its owner as needing a gamestate update, without changing the revision. */
+		void mark_gamestate_dirty();
+		/* Marks data derived from this province as stale without needing a gamestate update, e.g. when its owner's colour
+		 * changes. */
+		void increment_revision();
+
+		void set_crime(Crime const* new_crime);
 		bool set_owner(CountryInstance* new_owner);
 		bool set_controller(CountryInstance* new_controller);
 		bool add_core(CountryInstance& new_core);
@@ -120,11 +144,15 @@ namespace OpenVic {
 
 		bool expand_building(size_t building_index);
 
-		bool add_pop(Pop&& pop);
+		/* Pops can only be added while this province's pops are at the end of the PopStore, so that they stay contiguous,
+		 * meaning provinces must have their pops added one province at a time. */
+		bool add_pop(PopBase const& pop);
 		bool add_pop_vec(std::vector<PopBase> const& pop_vec);
 		size_t get_pop_count() const;
+		std::span<Pop> get_pops();
+		std::span<Pop const> get_pops() const;
 
-		void update_gamestate(Date today, DefineManager const& define_manager);
+		void update_gamestate(Date today, DefineManager const& define_manager, Profiler& profiler);
 		void tick(Date today);
 
 		template<UnitType::branch_t Branch>
@@ -135,6 +163,7 @@ namespace OpenVic {
 		bool setup(BuildingTypeManager const& building_type_manager);
 		bool apply_history_to_province(ProvinceHistoryEntry const& entry, CountryInstanceManager& country_manager);
 
-		void setup_pop_test_values(IssueManager const& issue_manager);
+		/* Each pop draws its test values from its own random stream, keyed by the seed, the date and its ID. */
+		void setup_pop_test_values(IssueManager const& issue_manager, uint64_t random_seed, Date date);
 	};
 }
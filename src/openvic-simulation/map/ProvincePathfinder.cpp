@@ -0,0 +1,243 @@
+#include "ProvincePathfinder.hpp"
+
+#include <algorithm>
+
+#include "openvic-simulation/map/MapDefinition.hpp"
+#include "openvic-simulation/map/MapInstance.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/modifier/Modifier.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
+
+using namespace OpenVic;
+
+ProvincePathfinder::ProvincePathfinder(MapDefinition const& new_map_definition)
+  : map_definition { new_map_definition }, movement_cost_effect { nullptr }, min_movement_cost { fixed_point_t::_1() },
+	search_id { 0 }, cache_capacity { DEFAULT_CACHE_CAPACITY }, cache_clock { 0 }, cache_hits { 0 }, cache_misses { 0 } {}
+
+bool ProvincePathfinder::setup(ModifierManager const& modifier_manager) {
+	static constexpr std::string_view movement_cost_effect_identifier = "movement_cost";
+
+	movement_cost_effect = modifier_manager.get_modifier_effect_by_identifier(movement_cost_effect_identifier);
+
+	const size_t province_count = map_definition.get_province_definition_count();
+	movement_costs.assign(province_count, fixed_point_t::_1());
+	nodes.assign(province_count, {});
+	search_id = 0;
+	clear_cache();
+
+	if (movement_cost_effect == nullptr) {
+		Logger::error("Failed to find modifier effect \"", movement_cost_effect_identifier, "\" for pathfinding!");
+		return false;
+	}
+	return true;
+}
+
+void ProvincePathfinder::update_movement_costs(MapInstance const& map_instance) {
+	for (ProvinceInstance const& province : map_instance.get_province_instances()) {
+		TerrainType const* terrain_type = province.get_terrain_type();
+		fixed_point_t movement_cost = fixed_point_t::_1();
+
+		if (terrain_type != nullptr && movement_cost_effect != nullptr) {
+			bool effect_found = false;
+			const fixed_point_t terrain_movement_cost = terrain_type->get_effect(*movement_cost_effect, &effect_found);
+			/* Non-positive costs would break the search, so are treated as if they were missing. */
+			if (effect_found && terrain_movement_cost > 0) {
+				movement_cost = terrain_movement_cost;
+			}
+		}
+
+		const size_t array_index = province.get_province_definition().get_index() - 1;
+		if (array_index < movement_costs.size()) {
+			movement_costs[array_index] = movement_cost;
+		}
+	}
+
+	min_movement_cost = movement_costs.empty()
+		? fixed_point_t::_1() : *std::min_element(movement_costs.begin(), movement_costs.end());
+
+	clear_cache();
+}
+
+void ProvincePathfinder::clear_cache() {
+	cache.clear();
+}
+
+void ProvincePathfinder::set_cache_capacity(size_t new_cache_capacity) {
+	cache_capacity = new_cache_capacity;
+	_evict_least_recently_used(cache_capacity);
+}
+
+void ProvincePathfinder::_evict_least_recently_used(size_t max_size) {
+	/* Only done when a new path is found, so a linear scan costs far less than the search itself. */
+	while (cache.size() > max_size) {
+		const decltype(cache)::const_iterator least_recently_used = std::min_element(
+			cache.begin(), cache.end(),
+			[](auto const& lhs, auto const& rhs) -> bool {
+				return lhs.second.last_used < rhs.second.last_used;
+			}
+		);
+		cache.unordered_erase(least_recently_used);
+	}
+}
+
+bool ProvincePathfinder::is_canal_open(adjacency_t::data_t canal) const {
+	return canal < open_canals.size() && open_canals[canal];
+}
+
+void ProvincePathfinder::set_canal_open(adjacency_t::data_t canal, bool open) {
+	if (canal == adjacency_t::NO_CANAL) {
+		Logger::error("Cannot open or close invalid canal ID ", static_cast<uint32_t>(canal));
+		return;
+	}
+	if (is_canal_open(canal) == open) {
+		return;
+	}
+	if (canal >= open_canals.size()) {
+		open_canals.resize(canal + 1);
+	}
+	open_canals[canal] = open;
+	clear_cache();
+}
+
+fixed_point_t ProvincePathfinder::get_movement_cost(ProvinceDefinition const& province) const {
+	const size_t array_index = province.get_index() - 1;
+	return array_index < movement_costs.size() ? movement_costs[array_index] : fixed_point_t::_1();
+}
+
+bool ProvincePathfinder::_can_traverse(
+	ProvinceDefinition const& from, adjacency_t const& adjacency, branch_t branch
+) const {
+	using enum adjacency_t::type_t;
+
+	switch (adjacency.get_type()) {
+	case LAND:
+	case STRAIT:
+		return branch == branch_t::LAND;
+	case WATER:
+		return branch == branch_t::NAVAL;
+	case CANAL:
+		return branch == branch_t::NAVAL && is_canal_open(adjacency.get_data());
+	case COASTAL: {
+		/* Ships can only enter or leave a land province through its port's sea zone. */
+		ProvinceDefinition const& to = *adjacency.get_to();
+		return branch == branch_t::NAVAL && (from.is_water()
+			? to.has_port() && to.get_port_adjacent_province() == &from
+			: from.has_port() && from.get_port_adjacent_province() == &to);
+	}
+	default:
+		return false;
+	}
+}
+
+fixed_point_t ProvincePathfinder::_estimate_cost(ProvinceDefinition const& from, ProvinceDefinition const& to) const {
+	return map_definition.calculate_distance_between(from, to) * min_movement_cost;
+}
+
+void ProvincePathfinder::_search(
+	ProvinceDefinition const& from, ProvinceDefinition const& to, branch_t branch, std::vector<index_t>& path
+) {
+	path.clear();
+
+	/* Bumping the search ID invalidates every node at once, so they only need resetting when it wraps around. */
+	if (++search_id == 0) {
+		for (node_t& node : nodes) {
+			node.search_id = 0;
+		}
+		search_id = 1;
+	}
+
+	const auto get_node = [this](index_t index) -> node_t& {
+		node_t& node = nodes[index - 1];
+		if (node.search_id != search_id) {
+			node = { fixed_point_t::_0(), ProvinceDefinition::NULL_INDEX, false, search_id };
+		}
+		return node;
+	};
+
+	/* std::push_heap and std::pop_heap build a max-heap, so the comparison is reversed to pop the lowest cost first. */
+	const auto heap_compare = [](open_entry_t const& lhs, open_entry_t const& rhs) -> bool {
+		return lhs.estimated_cost > rhs.estimated_cost;
+	};
+
+	ProvinceAdjacencyGraph const& graph = map_definition.get_adjacency_graph();
+
+	open_heap.clear();
+	get_node(from.get_index());
+	open_heap.push_back({ _estimate_cost(from, to), from.get_index() });
+
+	while (!open_heap.empty()) {
+		std::pop_heap(open_heap.begin(), open_heap.end(), heap_compare);
+		const index_t current_index = open_heap.back().index;
+		open_heap.pop_back();
+
+		node_t& current = get_node(current_index);
+		/* Provinces are pushed again whenever a cheaper route is found, leaving stale entries to skip. */
+		if (current.closed) {
+			continue;
+		}
+		current.closed = true;
+
+		if (current_index == to.get_index()) {
+			for (index_t index = current_index; index != ProvinceDefinition::NULL_INDEX; index = get_node(index).parent) {
+				path.push_back(index);
+			}
+			std::reverse(path.begin(), path.end());
+			return;
+		}
+
+		ProvinceDefinition const& current_province = *map_definition.get_province_definition_by_index(current_index);
+		const fixed_point_t current_cost = current.cost;
+
+		for (adjacency_t const* adjacency : graph.get_adjacencies(current_province)) {
+			if (!_can_traverse(current_province, *adjacency, branch)) {
+				continue;
+			}
+
+			ProvinceDefinition const& neighbour_province = *adjacency->get_to();
+			node_t& neighbour = get_node(neighbour_province.get_index());
+			if (neighbour.closed) {
+				continue;
+			}
+
+			const fixed_point_t cost = current_cost + adjacency->get_distance() * get_movement_cost(neighbour_province);
+			if (neighbour.parent == ProvinceDefinition::NULL_INDEX || cost < neighbour.cost) {
+				neighbour.cost = cost;
+				neighbour.parent = current_index;
+				open_heap.push_back({ cost + _estimate_cost(neighbour_province, to), neighbour_province.get_index() });
+				std::push_heap(open_heap.begin(), open_heap.end(), heap_compare);
+			}
+		}
+	}
+}
+
+std::span<const ProvincePathfinder::index_t> ProvincePathfinder::find_path(
+	ProvinceDefinition const& from, ProvinceDefinition const& to, branch_t branch
+) {
+	if (from.get_index() > nodes.size() || to.get_index() > nodes.size()) {
+		Logger::error("Cannot find path from ", from, " to ", to, " - pathfinder has not been set up for these provinces!");
+		return {};
+	}
+
+	if (cache_capacity == 0) {
+		_search(from, to, branch, uncached_path);
+		return uncached_path;
+	}
+
+	const uint64_t key = _cache_key(from.get_index(), to.get_index(), branch);
+
+	const decltype(cache)::iterator it = cache.find(key);
+	if (it != cache.end()) {
+		cache_hits++;
+		cache_entry_t& entry = it.value();
+		entry.last_used = ++cache_clock;
+		return entry.path;
+	}
+	cache_misses++;
+
+	_evict_least_recently_used(cache_capacity - 1);
+
+	cache_entry_t& entry = cache[key];
+	_search(from, to, branch, entry.path);
+	entry.last_used = ++cache_clock;
+	return entry.path;
+}
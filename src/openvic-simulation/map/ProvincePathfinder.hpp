@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "openvic-simulation/map/ProvinceDefinition.hpp"
+#include "openvic-simulation/military/UnitType.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/types/OrderedContainers.hpp"
+
+namespace OpenVic {
+	struct MapDefinition;
+	struct MapInstance;
+	struct ModifierEffect;
+	struct ModifierManager;
+
+	/* A* search over the map's ProvinceAdjacencyGraph for the cheapest route a land or naval unit can take between two
+	 * provinces. Entering a province costs the adjacency's distance multiplied by the movement_cost of the province's
+	 * terrain, and the heuristic is the distance to the target (wrapping around the map horizontally) multiplied by the
+	 * lowest movement cost on the map, so it never overestimates and every path found is a cheapest one.
+	 * Land units follow land and strait adjacencies, naval units follow water adjacencies, open canals and coastal
+	 * adjacencies between a port and the sea zone it faces. Impassable adjacencies are never used.
+	 * Paths are kept in a least recently used cache, which is cleared whenever movement costs or canals change.
+	 * Searches reuse internal buffers, so a pathfinder must only be used by one thread at a time. */
+	struct ProvincePathfinder {
+		using index_t = ProvinceDefinition::index_t;
+		using adjacency_t = ProvinceDefinition::adjacency_t;
+		using branch_t = UnitType::branch_t;
+
+		static constexpr size_t DEFAULT_CACHE_CAPACITY = 1024;
+
+	private:
+		struct cache_entry_t {
+			/* Includes the start and target provinces, or is empty if there is no path. */
+			std::vector<index_t> path;
+			uint64_t last_used;
+		};
+
+		/* Per-province search state, only valid if search_id matches the current search. */
+		struct node_t {
+			fixed_point_t cost;
+			index_t parent;
+			bool closed;
+			uint32_t search_id;
+		};
+
+		struct open_entry_t {
+			fixed_point_t estimated_cost;
+			index_t index;
+		};
+
+		MapDefinition const& map_definition;
+		ModifierEffect const* movement_cost_effect;
+
+		/* Indexed by province index - 1. */
+		std::vector<fixed_point_t> movement_costs;
+		fixed_point_t min_movement_cost;
+		/* Indexed by canal ID (adjacency_t::data_t), canals start closed. */
+		std::vector<bool> open_canals;
+
+		std::vector<node_t> nodes;
+		std::vector<open_entry_t> open_heap;
+		uint32_t search_id;
+
+		ordered_map<uint64_t, cache_entry_t> cache;
+		size_t PROPERTY(cache_capacity);
+		uint64_t cache_clock;
+		size_t PROPERTY(cache_hits);
+		size_t PROPERTY(cache_misses);
+		/* Holds the last path found when the cache is disabled. */
+		std::vector<index_t> uncached_path;
+
+		static constexpr uint64_t _cache_key(index_t from, index_t to, branch_t branch) {
+			return (static_cast<uint64_t>(from) << 24) | (static_cast<uint64_t>(to) << 8) | static_cast<uint64_t>(branch);
+		}
+
+		/* The cache's order doesn't matter, so entries are removed with unordered_erase to avoid shifting the rest. */
+		void _evict_least_recently_used(size_t max_size);
+		bool _can_traverse(ProvinceDefinition const& from, adjacency_t const& adjacency, branch_t branch) const;
+		fixed_point_t _estimate_cost(ProvinceDefinition const& from, ProvinceDefinition const& to) const;
+		void _search(ProvinceDefinition const& from, ProvinceDefinition const& to, branch_t branch, std::vector<index_t>& path);
+
+	public:
+		ProvincePathfinder(MapDefinition const& new_map_definition);
+
+		bool setup(ModifierManager const& modifier_manager);
+
+		/* Reads every province's current terrain type, and clears the cache. */
+		void update_movement_costs(MapInstance const& map_instance);
+		void clear_cache();
+		/* Evicts the least recently used paths if the cache is already larger than the new capacity. 0 disables caching. */
+		void set_cache_capacity(size_t new_cache_capacity);
+
+		bool is_canal_open(adjacency_t::data_t canal) const;
+		void set_canal_open(adjacency_t::data_t canal, bool open);
+
+		fixed_point_t get_movement_cost(ProvinceDefinition const& province) const;
+
+		/* Returns the indices of the provinces along the cheapest path from from to to, including both ends, or an empty span
+		 * if branch can't reach to. The span is only valid until the next call of any non-const member function. */
+		std::span<const index_t> find_path(ProvinceDefinition const& from, ProvinceDefinition const& to, branch_t branch);
+	};
+}
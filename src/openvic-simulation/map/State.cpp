@@ -15,15 +15,20 @@ State::State(
 	ProvinceInstance* new_capital,
 	std::vector<ProvinceInstance*>&& new_provinces,
 	ProvinceInstance::colony_status_t new_colony_status,
-	decltype(pop_type_distribution)::keys_t const& pop_type_keys
+	decltype(pop_type_distribution)::keys_t const& pop_type_keys,
+	decltype(culture_distribution)::keys_t const& culture_keys,
+	decltype(religion_distribution)::keys_t const& religion_keys
 ) : state_set { new_state_set },
 	owner { new_owner },
 	capital { new_capital },
 	provinces { std::move(new_provinces) },
 	colony_status { new_colony_status },
 	pop_type_distribution { &pop_type_keys },
+	culture_distribution { &culture_keys },
+	religion_distribution { &religion_keys },
 	industrial_power { 0 },
-	max_supported_regiments { 0 } {}
+	max_supported_regiments { 0 },
+	gamestate_dirty { true } {}
 
 std::string State::get_identifier() const {
 	return StringUtils::append_string_views(
@@ -32,12 +37,22 @@ std::string State::get_identifier() const {
 	);
 }
 
+void State::mark_gamestate_dirty() {
+	gamestate_dirty = true;
+
+	if (owner != nullptr) {
+		owner->mark_gamestate_dirty();
+	}
+}
+
 void State::update_gamestate() {
 	total_population = 0;
 	average_literacy = 0;
 	average_consciousness = 0;
 	average_militancy = 0;
 	pop_type_distribution.clear();
+	culture_distribution.clear();
+	religion_distribution.clear();
 	max_supported_regiments = 0;
 
 	for (ProvinceInstance const* province : provinces) {
@@ -50,6 +65,8 @@ void State::update_gamestate() {
 		average_militancy += province->get_average_militancy() * province_population;
 
 		pop_type_distribution += province->get_pop_type_distribution();
+		culture_distribution += province->get_culture_distribution();
+		religion_distribution += province->get_religion_distribution();
 
 		max_supported_regiments += province->get_max_supported_regiments();
 	}
@@ -69,6 +86,8 @@ void State::update_gamestate() {
 		(fixed_point_t { potential_workforce_in_state } / 100).floor() * 400 / potential_employment_in_state,
 		fixed_point_t::_0_20(), fixed_point_t::_4()
 	);
+
+	gamestate_dirty = false;
 }
 
 /* Whether two provinces in the same region should be grouped into the same state or not.
@@ -85,12 +104,16 @@ size_t StateSet::get_state_count() const {
 
 void StateSet::update_gamestate() {
 	for (State& state : states) {
-		state.update_gamestate();
+		if (state.is_gamestate_dirty()) {
+			state.update_gamestate();
+		}
 	}
 }
 
 bool StateManager::add_state_set(
-	MapInstance& map_instance, Region const& region, decltype(State::pop_type_distribution)::keys_t const& pop_type_keys
+	MapInstance& map_instance, Region const& region, decltype(State::pop_type_distribution)::keys_t const& pop_type_keys,
+	decltype(State::culture_distribution)::keys_t const& culture_keys,
+	decltype(State::religion_distribution)::keys_t const& religion_keys
 ) {
 	if (region.get_meta()) {
 		Logger::error("Cannot use meta region \"", region.get_identifier(), "\" as state template!");
@@ -139,7 +162,10 @@ bool StateManager::add_state_set(
 
 		State& state = *state_set.states.insert(
 			/* TODO: capital province logic */
-			{ state_set, owner, capital, std::move(provinces), capital->get_colony_status(), pop_type_keys }
+			{
+				state_set, owner, capital, std::move(provinces), capital->get_colony_status(), pop_type_keys, culture_keys,
+				religion_keys
+			}
 		);
 
 		for (ProvinceInstance* province : state.get_provinces()) {
@@ -155,7 +181,9 @@ bool StateManager::add_state_set(
 }
 
 bool StateManager::generate_states(
-	MapInstance& map_instance, decltype(State::pop_type_distribution)::keys_t const& pop_type_keys
+	MapInstance& map_instance, decltype(State::pop_type_distribution)::keys_t const& pop_type_keys,
+	decltype(State::culture_distribution)::keys_t const& culture_keys,
+	decltype(State::religion_distribution)::keys_t const& religion_keys
 ) {
 	MapDefinition const& map_definition = map_instance.get_map_definition();
 
@@ -167,7 +195,7 @@ bool StateManager::generate_states(
 
 	for (Region const& region : map_definition.get_regions()) {
 		if (!region.get_meta()) {
-			if (add_state_set(map_instance, region, pop_type_keys)) {
+			if (add_state_set(map_instance, region, pop_type_keys, culture_keys, religion_keys)) {
 				state_count += state_sets.back().get_state_count();
 			} else {
 				ret = false;
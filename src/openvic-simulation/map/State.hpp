@@ -30,23 +30,33 @@ namespace OpenVic {
 		fixed_point_t PROPERTY(average_consciousness);
 		fixed_point_t PROPERTY(average_militancy);
 		IndexedMap<PopType, fixed_point_t> PROPERTY(pop_type_distribution);
+		SparseIndexedMap<Culture, fixed_point_t> PROPERTY(culture_distribution);
+		SparseIndexedMap<Religion, fixed_point_t> PROPERTY(religion_distribution);
 
 		fixed_point_t PROPERTY(industrial_power);
 
 		size_t PROPERTY(max_supported_regiments);
 
+		/* Set when one of this state's provinces has changed since the state's last gamestate update. */
+		bool PROPERTY_CUSTOM_PREFIX(gamestate_dirty, is);
+
 		State(
 			StateSet const& new_state_set,
 			CountryInstance* new_owner,
 			ProvinceInstance* new_capital,
 			std::vector<ProvinceInstance*>&& new_provinces,
 			ProvinceInstance::colony_status_t new_colony_status,
-			decltype(pop_type_distribution)::keys_t const& pop_type_keys
+			decltype(pop_type_distribution)::keys_t const& pop_type_keys,
+			decltype(culture_distribution)::keys_t const& culture_keys,
+			decltype(religion_distribution)::keys_t const& religion_keys
 		);
 
 	public:
 		std::string get_identifier() const;
 
+		/* Marks this state and its owner as needing a gamestate update. */
+		void mark_gamestate_dirty();
+
 		void update_gamestate();
 	};
 
@@ -66,6 +76,7 @@ namespace OpenVic {
 	public:
 		size_t get_state_count() const;
 
+		/* Only updates states marked as dirty. */
 		void update_gamestate();
 	};
 
@@ -78,17 +89,24 @@ namespace OpenVic {
 
 		bool add_state_set(
 			MapInstance& map_instance, Region const& region,
-			decltype(State::pop_type_distribution)::keys_t const& pop_type_keys
+			decltype(State::pop_type_distribution)::keys_t const& pop_type_keys,
+			decltype(State::culture_distribution)::keys_t const& culture_keys,
+			decltype(State::religion_distribution)::keys_t const& religion_keys
 		);
 
 	public:
 		/* Creates states from current province gamestate & regions, sets province state value.
 		 * After this function, the `regions` property is unmanaged and must be carefully updated and
 		 * validated by functions that modify it. */
-		bool generate_states(MapInstance& map_instance, decltype(State::pop_type_distribution)::keys_t const& pop_type_keys);
+		bool generate_states(
+			MapInstance& map_instance, decltype(State::pop_type_distribution)::keys_t const& pop_type_keys,
+			decltype(State::culture_distribution)::keys_t const& culture_keys,
+			decltype(State::religion_distribution)::keys_t const& religion_keys
+		);
 
 		void reset();
 
+		/* Only updates states marked as dirty. */
 		void update_gamestate();
 	};
 }
@@ -5,6 +5,7 @@
 #include <string_view>
 
 #include "openvic-simulation/military/UnitType.hpp"
+#include "openvic-simulation/pop/Pop.hpp"
 #include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
 #include "openvic-simulation/utility/Getters.hpp"
 
@@ -30,8 +31,6 @@ namespace OpenVic {
 		void set_unit_name(std::string_view new_unit_name);
 	};
 
-	struct Pop;
-
 	template<UnitType::branch_t>
 	struct UnitInstanceBranched;
 
@@ -40,11 +39,12 @@ namespace OpenVic {
 		friend struct UnitInstanceManager;
 
 	private:
-		Pop* PROPERTY(pop);
+		/* Held by ID as adding pops can move them, see PopStore. */
+		Pop::pop_id_t PROPERTY(pop_id);
 		bool PROPERTY_CUSTOM_PREFIX(mobilised, is);
 
 		UnitInstanceBranched(
-			std::string_view new_name, RegimentType const& new_regiment_type, Pop* new_pop, bool new_mobilised)
+			std::string_view new_name, RegimentType const& new_regiment_type, Pop::pop_id_t new_pop_id, bool new_mobilised)
 		;
 
 	public:
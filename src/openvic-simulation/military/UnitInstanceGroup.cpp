@@ -1,5 +1,6 @@
 #include "UnitInstanceGroup.hpp"
 
+#include <span>
 #include <vector>
 
 #include "openvic-simulation/country/CountryInstance.hpp"
@@ -11,9 +12,23 @@ using namespace OpenVic;
 
 MovementInfo::MovementInfo() : path {}, movement_progress {} {}
 
-//TODO: pathfinding logic
-MovementInfo::MovementInfo(ProvinceInstance const* starting_province, ProvinceInstance const* target_province)
-	: path { starting_province, target_province }, movement_progress { 0 } {}
+MovementInfo::MovementInfo(
+	MapInstance& map_instance, ProvinceInstance const* starting_province, ProvinceInstance const* target_province,
+	UnitType::branch_t branch
+) : path {}, movement_progress { 0 } {
+	if (starting_province == nullptr || target_province == nullptr) {
+		return;
+	}
+
+	const std::span<const ProvinceDefinition::index_t> province_indices = map_instance.get_pathfinder().find_path(
+		starting_province->get_province_definition(), target_province->get_province_definition(), branch
+	);
+
+	path.reserve(province_indices.size());
+	for (const ProvinceDefinition::index_t index : province_indices) {
+		path.push_back(map_instance.get_province_instance_by_index(index));
+	}
+}
 
 template<UnitType::branch_t Branch>
 UnitInstanceGroup<Branch>::UnitInstanceGroup(
@@ -174,7 +189,7 @@ bool UnitInstanceManager::generate_unit_instance(
 			if constexpr (Branch == UnitType::branch_t::LAND) {
 				return {
 					unit_deployment.get_name(), unit_deployment.get_type(),
-					nullptr, // TODO - get pop from Province unit_deployment.get_home()
+					Pop::NULL_ID, // TODO - get pop from Province unit_deployment.get_home()
 					false // Not mobilised
 				};
 			} else if constexpr (Branch == UnitType::branch_t::NAVAL) {
@@ -12,6 +12,7 @@
 #include "openvic-simulation/utility/Getters.hpp"
 
 namespace OpenVic {
+	struct MapInstance;
 	struct ProvinceInstance;
 
 	struct MovementInfo {
@@ -21,8 +22,11 @@ namespace OpenVic {
 
 	public:
 		MovementInfo();
-		// contains/calls pathfinding logic
-		MovementInfo(ProvinceInstance const* starting_province, ProvinceInstance const* target_province);
+		/* Uses the map's pathfinder, leaving the path empty if units of the given branch can't reach target_province. */
+		MovementInfo(
+			MapInstance& map_instance, ProvinceInstance const* starting_province, ProvinceInstance const* target_province,
+			UnitType::branch_t branch
+		);
 	};
 
 	template<UnitType::branch_t>
@@ -54,6 +54,8 @@ namespace OpenVic {
 		bool can_decrease_simulation_speed() const;
 
 		void conditionally_advance_game();
+		/* Ticks and updates the game immediately, regardless of speed and pause state, e.g. for batch simulation. */
+		void force_advance_game();
 		void reset();
 	};
 }
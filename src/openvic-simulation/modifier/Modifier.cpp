@@ -1,11 +1,14 @@
 #include "Modifier.hpp"
 
+#include <algorithm>
+#include <bit>
 #include <string>
 
 #include <openvic-dataloader/v2script/AbstractSyntaxTree.hpp>
 
 #include <dryad/node.hpp>
 
+#include "openvic-simulation/types/fixed_point/FixedPointSIMD.hpp"
 #include "openvic-simulation/types/OrderedContainers.hpp"
 #include "openvic-simulation/utility/TslHelper.hpp"
 
@@ -17,8 +20,9 @@ static std::string make_default_modifier_effect_localisation_key(std::string_vie
 }
 
 ModifierEffect::ModifierEffect(
-	std::string_view new_identifier, bool new_positive_good, format_t new_format, std::string_view new_localisation_key
-) : HasIdentifier { new_identifier }, positive_good { new_positive_good }, format { new_format },
+	std::string_view new_identifier, index_t new_index, bool new_positive_good, format_t new_format,
+	std::string_view new_localisation_key
+) : HasIdentifier { new_identifier }, HasIndex { new_index }, positive_good { new_positive_good }, format { new_format },
 	localisation_key {
 		new_localisation_key.empty() ? make_default_modifier_effect_localisation_key(new_identifier) : new_localisation_key
 	} {}
@@ -129,6 +133,80 @@ void ModifierValue::multiply_add(ModifierValue const& other, fixed_point_t multi
 	}
 }
 
+static constexpr size_t EFFECT_FLAG_BITS = 64;
+
+void DenseModifierValue::_fit_effect_index(size_t index) {
+	if (index >= values.size()) {
+		values.resize(index + 1);
+		effect_flags.resize(index / EFFECT_FLAG_BITS + 1);
+	}
+}
+
+void DenseModifierValue::clear() {
+	std::fill(values.begin(), values.end(), fixed_point_t::_0());
+	std::fill(effect_flags.begin(), effect_flags.end(), 0);
+}
+
+bool DenseModifierValue::empty() const {
+	return std::all_of(effect_flags.begin(), effect_flags.end(), [](uint64_t flags) -> bool {
+		return flags == 0;
+	});
+}
+
+size_t DenseModifierValue::get_effect_count() const {
+	size_t count = 0;
+	for (const uint64_t flags : effect_flags) {
+		count += std::popcount(flags);
+	}
+	return count;
+}
+
+fixed_point_t DenseModifierValue::get_effect(ModifierEffect const& effect, bool* effect_found) const {
+	const bool found = has_effect(effect);
+	if (effect_found != nullptr) {
+		*effect_found = found;
+	}
+	return found ? values[effect.get_index()] : fixed_point_t::_0();
+}
+
+bool DenseModifierValue::has_effect(ModifierEffect const& effect) const {
+	const size_t index = effect.get_index();
+	return index < values.size() && (effect_flags[index / EFFECT_FLAG_BITS] >> (index % EFFECT_FLAG_BITS)) & 1;
+}
+
+DenseModifierValue& DenseModifierValue::operator+=(ModifierValue const& right) {
+	multiply_add(right, fixed_point_t::_1());
+	return *this;
+}
+
+DenseModifierValue& DenseModifierValue::operator+=(DenseModifierValue const& right) {
+	if (right.values.size() > values.size()) {
+		_fit_effect_index(right.values.size() - 1);
+	}
+	FixedPointSIMD::add(values, right.values);
+	for (size_t index = 0; index < right.effect_flags.size(); ++index) {
+		effect_flags[index] |= right.effect_flags[index];
+	}
+	return *this;
+}
+
+DenseModifierValue& DenseModifierValue::operator*=(fixed_point_t const& right) {
+	FixedPointSIMD::multiply(values, right);
+	return *this;
+}
+
+void DenseModifierValue::multiply_add(ModifierValue const& other, fixed_point_t multiplier) {
+	if (multiplier == fixed_point_t::_0()) {
+		return;
+	}
+	for (ModifierValue::effect_map_t::value_type const& value : other.get_values()) {
+		const size_t index = value.first->get_index();
+		_fit_effect_index(index);
+		values[index] += multiplier == fixed_point_t::_1() ? value.second : value.second * multiplier;
+		effect_flags[index / EFFECT_FLAG_BITS] |= uint64_t { 1 } << (index % EFFECT_FLAG_BITS);
+	}
+}
+
 Modifier::Modifier(std::string_view new_identifier, ModifierValue&& new_values, modifier_type_t new_type)
 	: HasIdentifier { new_identifier }, ModifierValue { std::move(new_values) }, type { new_type } {}
 
@@ -155,7 +233,9 @@ bool ModifierManager::add_modifier_effect(
 		Logger::error("Invalid modifier effect identifier - empty!");
 		return false;
 	}
-	return modifier_effects.add_item({ std::move(identifier), positive_good, format, localisation_key });
+	return modifier_effects.add_item({
+		std::move(identifier), modifier_effects.size(), positive_good, format, localisation_key
+	});
 }
 
 bool ModifierManager::setup_modifier_effects() {
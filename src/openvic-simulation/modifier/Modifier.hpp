@@ -1,12 +1,15 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include "openvic-simulation/scripts/ConditionScript.hpp"
 #include "openvic-simulation/types/IdentifierRegistry.hpp"
 
 namespace OpenVic {
 	struct ModifierManager;
 
-	struct ModifierEffect : HasIdentifier {
+	struct ModifierEffect : HasIdentifier, HasIndex<> {
 		friend struct ModifierManager;
 
 		enum class format_t {
@@ -27,7 +30,8 @@ namespace OpenVic {
 		// TODO - format/precision, e.g. 80% vs 0.8 vs 0.800, 2 vs 2.0 vs 200%
 
 		ModifierEffect(
-			std::string_view new_identifier, bool new_positive_good, format_t new_format, std::string_view new_localisation_key
+			std::string_view new_identifier, index_t new_index, bool new_positive_good, format_t new_format,
+			std::string_view new_localisation_key
 		);
 
 	public:
@@ -76,6 +80,42 @@ namespace OpenVic {
 		friend std::ostream& operator<<(std::ostream& stream, ModifierValue const& value);
 	};
 
+	/* A ModifierValue stored as one value per ModifierEffect, indexed by ModifierEffect::index, for accumulating the many
+	 * modifiers applied to a country or province. Adding a ModifierValue only visits that value's own effects, while
+	 * adding or scaling a whole DenseModifierValue uses the vectorised FixedPointSIMD kernels, so nothing is hashed.
+	 * Storage grows to fit the highest effect index added, so it never needs to know the total number of effects. */
+	struct DenseModifierValue {
+	private:
+		std::vector<fixed_point_t> values;
+		/* Bit i is set once effect i has been added, even if its value has since summed to zero, matching whether
+		 * ModifierValue would contain an entry for it. */
+		std::vector<uint64_t> effect_flags;
+
+		void _fit_effect_index(size_t index);
+
+	public:
+		DenseModifierValue() = default;
+		DenseModifierValue(DenseModifierValue const&) = default;
+		DenseModifierValue(DenseModifierValue&&) = default;
+
+		DenseModifierValue& operator=(DenseModifierValue const&) = default;
+		DenseModifierValue& operator=(DenseModifierValue&&) = default;
+
+		/* Zeroes every value and forgets which effects were added, keeping the storage for reuse. */
+		void clear();
+		bool empty() const;
+		size_t get_effect_count() const;
+
+		fixed_point_t get_effect(ModifierEffect const& effect, bool* effect_found = nullptr) const;
+		bool has_effect(ModifierEffect const& effect) const;
+
+		DenseModifierValue& operator+=(ModifierValue const& right);
+		DenseModifierValue& operator+=(DenseModifierValue const& right);
+		DenseModifierValue& operator*=(fixed_point_t const& right);
+
+		void multiply_add(ModifierValue const& other, fixed_point_t multiplier);
+	};
+
 	struct Modifier : HasIdentifier, ModifierValue {
 		friend struct ModifierManager;
 
@@ -1,5 +1,7 @@
 #include "ModifierSum.hpp"
 
+#include <algorithm>
+
 using namespace OpenVic;
 
 void ModifierSum::clear() {
@@ -20,12 +22,12 @@ bool ModifierSum::has_effect(ModifierEffect const& effect) const {
 }
 
 void ModifierSum::add_modifier(Modifier const& modifier, fixed_point_t multiplier) {
-	modifiers[&modifier] += multiplier;
+	modifiers.emplace_back(&modifier, multiplier);
 	value_sum.multiply_add(modifier, multiplier);
 }
 
 void ModifierSum::add_modifier_sum(ModifierSum const& modifier_sum) {
-	modifiers += modifier_sum.modifiers;
+	modifiers.insert(modifiers.end(), modifier_sum.modifiers.begin(), modifier_sum.modifiers.end());
 	value_sum += modifier_sum.value_sum;
 }
 
@@ -45,12 +47,21 @@ std::vector<std::pair<Modifier const*, fixed_point_t>> ModifierSum::get_contribu
 ) const {
 	std::vector<std::pair<Modifier const*, fixed_point_t>> ret;
 
-	for (auto const& [modifier, multiplier] : modifiers) {
+	for (modifier_entry_t const& entry : modifiers) {
 		bool effect_found = false;
-		const fixed_point_t value = modifier->get_effect(effect, &effect_found);
+		const fixed_point_t value = entry.first->get_effect(effect, &effect_found);
 
 		if (effect_found) {
-			ret.emplace_back(modifier, value * multiplier);
+			const decltype(ret)::iterator it = std::find_if(
+				ret.begin(), ret.end(), [&entry](std::pair<Modifier const*, fixed_point_t> const& contribution) -> bool {
+					return contribution.first == entry.first;
+				}
+			);
+			if (it != ret.end()) {
+				it->second += value * entry.second;
+			} else {
+				ret.emplace_back(entry.first, value * entry.second);
+			}
 		}
 	}
 
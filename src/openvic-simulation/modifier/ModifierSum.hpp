@@ -1,13 +1,19 @@
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "openvic-simulation/modifier/Modifier.hpp"
-#include "openvic-simulation/types/fixed_point/FixedPointMap.hpp"
 
 namespace OpenVic {
 	struct ModifierSum {
+		using modifier_entry_t = std::pair<Modifier const*, fixed_point_t>;
+
 	private:
-		fixed_point_map_t<Modifier const*> PROPERTY(modifiers);
-		ModifierValue PROPERTY(value_sum);
+		/* Every modifier added along with its multiplier, in the order they were added. Adding the same modifier again
+		 * adds another entry rather than looking up and updating the existing one. */
+		std::vector<modifier_entry_t> PROPERTY(modifiers);
+		DenseModifierValue PROPERTY(value_sum);
 
 	public:
 		ModifierSum() = default;
@@ -25,6 +31,7 @@ namespace OpenVic {
 		ModifierSum& operator+=(Modifier const& modifier);
 		ModifierSum& operator+=(ModifierSum const& modifier_sum);
 
+		/* Each contributing modifier appears once, with the values of all its entries combined. */
 		std::vector<std::pair<Modifier const*, fixed_point_t>> get_contributing_modifiers(ModifierEffect const& effect) const;
 	};
 }
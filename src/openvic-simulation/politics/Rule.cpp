@@ -10,34 +10,55 @@ static std::string make_default_rule_localisation_key(std::string_view identifie
 	return "RULE_" + StringUtils::string_toupper(identifier);
 }
 
-Rule::Rule(std::string_view new_identifier, rule_group_t new_group, index_t new_index, std::string_view new_localisation_key)
-  : HasIdentifier { new_identifier }, HasIndex { new_index }, group { new_group },
+Rule::Rule(
+	std::string_view new_identifier, rule_group_t new_group, index_t new_index, size_t new_global_index,
+	std::string_view new_localisation_key
+) : HasIdentifier { new_identifier }, HasIndex { new_index }, group { new_group }, global_index { new_global_index },
 	localisation_key {
 		new_localisation_key.empty() ? make_default_rule_localisation_key(new_identifier) : new_localisation_key
 	} {}
 
-RuleSet::RuleSet(rule_group_map_t&& new_rule_groups) : rule_groups { std::move(new_rule_groups) } {}
+RuleSet::RuleSet() : rule_manager { nullptr } {}
+
+RuleSet::RuleSet(RuleManager const& new_rule_manager) : rule_manager { &new_rule_manager } {}
 
 bool RuleSet::trim_and_resolve_conflicts(bool log) {
+	if (rule_manager == nullptr) {
+		return true;
+	}
+
 	bool ret = true;
-	for (auto [group, rule_map] : mutable_iterator(rule_groups)) {
-		if (Rule::is_mutually_exclusive_group(group)) {
-			Rule const* primary_rule = nullptr;
-			for (auto const& [rule, value] : rule_map) {
-				if (value) {
-					if (primary_rule == nullptr) {
+	for (auto const& [group, group_mask] : rule_manager->get_rule_group_masks()) {
+		if (!Rule::is_mutually_exclusive_group(group)) {
+			continue;
+		}
+
+		const rule_bitset_t group_flags = rule_flags & group_mask;
+		if (group_flags.none()) {
+			continue;
+		}
+		const rule_bitset_t enabled_flags = group_flags & rule_values;
+
+		Rule const* primary_rule = nullptr;
+		if (enabled_flags.any()) {
+			for (size_t global_index = 0; global_index < enabled_flags.size(); ++global_index) {
+				if (enabled_flags.test(global_index)) {
+					Rule const* rule = rule_manager->get_rule_by_index(global_index);
+					if (primary_rule == nullptr || primary_rule->get_index() < rule->get_index()) {
 						primary_rule = rule;
-					} else {
-						if (primary_rule->get_index() < rule->get_index()) {
-							primary_rule = rule;
-						}
-						ret = false;
 					}
 				}
 			}
-			if (log) {
-				for (auto const& [rule, value] : rule_map) {
-					if (value) {
+			if (enabled_flags.count() > 1) {
+				ret = false;
+			}
+		}
+
+		if (log) {
+			for (size_t global_index = 0; global_index < group_flags.size(); ++global_index) {
+				if (group_flags.test(global_index)) {
+					Rule const* rule = rule_manager->get_rule_by_index(global_index);
+					if (enabled_flags.test(global_index)) {
 						if (rule != primary_rule) {
 							Logger::error(
 								"Conflicting mutually exclusive rule: ", rule, " superceeded by ", primary_rule, " - removing!"
@@ -48,86 +69,59 @@ bool RuleSet::trim_and_resolve_conflicts(bool log) {
 					}
 				}
 			}
-			rule_map.clear();
-			if (primary_rule != nullptr) {
-				rule_map.emplace(primary_rule, true);
-			}
+		}
+
+		rule_flags &= ~group_mask;
+		rule_values &= ~group_mask;
+		if (primary_rule != nullptr) {
+			rule_flags.set(primary_rule->get_global_index());
+			rule_values.set(primary_rule->get_global_index());
 		}
 	}
 	return ret;
 }
 
 size_t RuleSet::get_rule_group_count() const {
-	return rule_groups.size();
-}
-
-size_t RuleSet::get_rule_count() const {
-	size_t ret = 0;
-	for (auto const& [group, rule_map] : rule_groups) {
-		ret += rule_map.size();
+	if (rule_manager == nullptr) {
+		return 0;
 	}
-	return ret;
-}
-
-void RuleSet::clear() {
-	rule_groups.clear();
-}
 
-bool RuleSet::empty() const {
-	for (auto const& [group, rule_map] : rule_groups) {
-		if (!rule_map.empty()) {
-			return false;
+	size_t ret = 0;
+	for (auto const& [group, group_mask] : rule_manager->get_rule_group_masks()) {
+		if ((rule_flags & group_mask).any()) {
+			ret++;
 		}
 	}
-
-	return true;
+	return ret;
 }
 
-RuleSet::rule_map_t const& RuleSet::get_rule_group(Rule::rule_group_t group, bool* rule_group_found) const {
-	const rule_group_map_t::const_iterator it = rule_groups.find(group);
-	if (it != rule_groups.end()) {
-		if (rule_group_found != nullptr) {
-			*rule_group_found = true;
-		}
-		return it->second;
-	}
-	if (rule_group_found != nullptr) {
-		*rule_group_found = false;
-	}
-	static const rule_map_t empty_map {};
-	return empty_map;
+size_t RuleSet::get_rule_count() const {
+	return rule_flags.count();
 }
 
-bool RuleSet::get_rule(Rule const& rule, bool* rule_found) const {
-	rule_map_t const& rule_map = get_rule_group(rule.get_group());
-	const rule_map_t::const_iterator it = rule_map.find(&rule);
-	if (it != rule_map.end()) {
-		if (rule_found != nullptr) {
-			*rule_found = true;
-		}
-		return it->second;
-	}
-	if (rule_found != nullptr) {
-		*rule_found = false;
-	}
-	return Rule::is_default_enabled(rule.get_group());
+void RuleSet::clear() {
+	rule_flags.reset();
+	rule_values.reset();
 }
 
-bool RuleSet::has_rule(Rule const& rule) const {
-	return get_rule_group(rule.get_group()).contains(&rule);
+bool RuleSet::empty() const {
+	return rule_flags.none();
 }
 
 bool RuleSet::set_rule(Rule const& rule, bool value) {
-	rule_groups[rule.get_group()][&rule] = value;
-	return true;
+	const size_t global_index = rule.get_global_index();
+	const bool existing_rule = rule_flags.test(global_index);
+	rule_flags.set(global_index);
+	rule_values.set(global_index, value);
+	return !existing_rule;
 }
 
 RuleSet& RuleSet::operator|=(RuleSet const& right) {
-	for (auto const& [group, rule_map] : right.rule_groups) {
-		for (auto const& [rule, value] : rule_map) {
-			rule_groups[group][rule] |= value;
-		}
+	if (rule_manager == nullptr) {
+		rule_manager = right.rule_manager;
 	}
+	rule_flags |= right.rule_flags;
+	rule_values |= right.rule_values;
 	return *this;
 }
 
@@ -141,7 +135,17 @@ bool RuleManager::add_rule(std::string_view identifier, Rule::rule_group_t group
 		Logger::error("Invalid rule identifier - empty!");
 		return false;
 	}
-	return rules.add_item({ identifier, group, rule_group_sizes[group]++, localisation_key });
+	const size_t global_index = rules.size();
+	if (global_index >= Rule::MAX_RULE_COUNT) {
+		Logger::error("Cannot add rule ", identifier, " - the maximum of ", Rule::MAX_RULE_COUNT, " rules has been reached!");
+		return false;
+	}
+	if (!rules.add_item({ identifier, group, rule_group_sizes[group], global_index, localisation_key })) {
+		return false;
+	}
+	rule_group_sizes[group]++;
+	rule_group_masks[group].set(global_index);
+	return true;
 }
 
 bool RuleManager::setup_rules(BuildingTypeManager const& building_type_manager) {
@@ -186,16 +190,18 @@ bool RuleManager::setup_rules(BuildingTypeManager const& building_type_manager)
 
 node_callback_t RuleManager::expect_rule_set(callback_t<RuleSet&&> ruleset_callback) const {
 	return [this, ruleset_callback](ast::NodeCPtr root) -> bool {
-		RuleSet ruleset;
+		RuleSet ruleset { *this };
 		bool ret = expect_dictionary(
 			[this, &ruleset](std::string_view rule_key, ast::NodeCPtr rule_value) -> bool {
 				Rule const* rule = get_rule_by_identifier(rule_key);
 				if (rule != nullptr) {
 					return expect_bool(
 						[&ruleset, rule](bool value) -> bool {
-							/* Wrapped in a lambda function so that the rule group is only initialised
-							 * if the value bool is successfully parsed. */
-							return map_callback(ruleset.rule_groups[rule->get_group()], rule)(value);
+							if (ruleset.set_rule(*rule, value)) {
+								return true;
+							}
+							Logger::error("Duplicate rule: ", rule);
+							return false;
 						}
 					)(rule_value);
 				} else {
@@ -212,9 +218,11 @@ node_callback_t RuleManager::expect_rule_set(callback_t<RuleSet&&> ruleset_callb
 
 namespace OpenVic { // so the compiler shuts up (copied from Modifier.cpp)
 	std::ostream& operator<<(std::ostream& stream, RuleSet const& value) {
-		for (auto const& [group, rule_map] : value.rule_groups) {
-			for (auto const& [rule, value] : rule_map) {
-				stream << rule << ": " << (value ? "yes" : "no") << "\n";
+		if (value.rule_manager != nullptr) {
+			for (Rule const& rule : value.rule_manager->get_rules()) {
+				if (value.has_rule(rule)) {
+					stream << &rule << ": " << (value.get_rule(rule) ? "yes" : "no") << "\n";
+				}
 			}
 		}
 		return stream;
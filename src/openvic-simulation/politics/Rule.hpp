@@ -1,5 +1,7 @@
 #pragma once
 
+#include <bitset>
+
 #include "openvic-simulation/types/IdentifierRegistry.hpp"
 #include "openvic-simulation/types/OrderedContainers.hpp"
 
@@ -26,30 +28,42 @@ namespace OpenVic {
 			return !is_mutually_exclusive_group(group) && group != SLAVERY;
 		}
 
+		/* The maximum number of rules, so that every RuleSet fits in a fixed size bitset. */
+		static constexpr size_t MAX_RULE_COUNT = 64;
+
 	private:
 		const rule_group_t PROPERTY(group);
+		/* The index of the Rule among all rules, used as its bit position in RuleSets. */
+		const size_t PROPERTY(global_index);
 		std::string PROPERTY(localisation_key);
 
 		Rule(
-			std::string_view new_identifier, rule_group_t new_group, index_t new_index, std::string_view new_localisation_key
+			std::string_view new_identifier, rule_group_t new_group, index_t new_index, size_t new_global_index,
+			std::string_view new_localisation_key
 		);
 
 	public:
 		Rule(Rule&&) = default;
 	};
 
+	/* Each rule is represented by two bits at its global index: whether the set contains the rule, and if so the rule's
+	 * value. This makes merging and looking up rules single bitwise operations, rather than nested map operations. */
 	struct RuleSet {
 		friend struct RuleManager;
 
-		using rule_map_t = ordered_map<Rule const*, bool>;
-		using rule_group_map_t = ordered_map<Rule::rule_group_t, rule_map_t>;
+		using rule_bitset_t = std::bitset<Rule::MAX_RULE_COUNT>;
 
 	private:
-		rule_group_map_t PROPERTY(rule_groups);
+		/* Needed to find which rules bits correspond to, e.g. to resolve conflicts within mutually exclusive groups.
+		 * Null if no rules have been set, and otherwise taken from the first RuleSet merged into this one. */
+		RuleManager const* rule_manager;
+		rule_bitset_t PROPERTY(rule_flags);
+		rule_bitset_t PROPERTY(rule_values);
+
+		RuleSet(RuleManager const& new_rule_manager);
 
 	public:
-		RuleSet() = default;
-		RuleSet(rule_group_map_t&& new_rule_groups);
+		RuleSet();
 		RuleSet(RuleSet const&) = default;
 		RuleSet(RuleSet&&) = default;
 
@@ -65,9 +79,16 @@ namespace OpenVic {
 		void clear();
 		bool empty() const;
 
-		rule_map_t const& get_rule_group(Rule::rule_group_t group, bool* rule_group_found = nullptr) const;
-		bool get_rule(Rule const& rule, bool* rule_found = nullptr) const;
-		bool has_rule(Rule const& rule) const;
+		bool get_rule(Rule const& rule, bool* rule_found = nullptr) const {
+			const bool found = has_rule(rule);
+			if (rule_found != nullptr) {
+				*rule_found = found;
+			}
+			return found ? rule_values.test(rule.get_global_index()) : Rule::is_default_enabled(rule.get_group());
+		}
+		bool has_rule(Rule const& rule) const {
+			return rule_flags.test(rule.get_global_index());
+		}
 
 		/* Sets the rule to the specified value. Returns false if there was an existing rule, regardless of its value. */
 		bool set_rule(Rule const& rule, bool value);
@@ -82,6 +103,8 @@ namespace OpenVic {
 	private:
 		IdentifierRegistry<Rule> IDENTIFIER_REGISTRY(rule);
 		ordered_map<Rule::rule_group_t, size_t> rule_group_sizes;
+		/* The bits of each group's rules, for every group with at least one rule. */
+		ordered_map<Rule::rule_group_t, RuleSet::rule_bitset_t> PROPERTY(rule_group_masks);
 
 	public:
 		bool add_rule(std::string_view identifier, Rule::rule_group_t group, std::string_view localisation_key = {});
@@ -8,6 +8,8 @@
 #include "openvic-simulation/politics/Ideology.hpp"
 #include "openvic-simulation/politics/Issue.hpp"
 #include "openvic-simulation/politics/Rebel.hpp"
+#include "openvic-simulation/pop/PopStore.hpp"
+#include "openvic-simulation/utility/RandomStream.hpp"
 #include "openvic-simulation/utility/TslHelper.hpp"
 
 using namespace OpenVic;
@@ -21,8 +23,14 @@ PopBase::PopBase(
 ) : type { new_type }, culture { new_culture }, religion { new_religion }, size { new_size }, militancy { new_militancy },
 	consciousness { new_consciousness }, rebel_type { new_rebel_type } {}
 
-Pop::Pop(PopBase const& pop_base, decltype(ideologies)::keys_t const& ideology_keys)
-  : PopBase { pop_base },
+Pop::Pop(PopBase const& pop_base, PopStore& new_store, size_t new_store_index, pop_id_t new_id)
+  : store { &new_store },
+	store_index { new_store_index },
+	id { new_id },
+	type { pop_base.get_type() },
+	culture { pop_base.get_culture() },
+	religion { pop_base.get_religion() },
+	rebel_type { pop_base.get_rebel_type() },
 	location { nullptr },
 	total_change { 0 },
 	num_grown { 0 },
@@ -31,8 +39,6 @@ Pop::Pop(PopBase const& pop_base, decltype(ideologies)::keys_t const& ideology_k
 	num_migrated_internal { 0 },
 	num_migrated_external { 0 },
 	num_migrated_colonial { 0 },
-	ideologies { &ideology_keys },
-	issues {},
 	votes { nullptr },
 	unemployment { 0 },
 	cash { 0 },
@@ -44,10 +50,49 @@ Pop::Pop(PopBase const& pop_base, decltype(ideologies)::keys_t const& ideology_k
 	luxury_needs_fulfilled { 0 },
 	max_supported_regiments { 0 } {}
 
-void Pop::setup_pop_test_values(IssueManager const& issue_manager) {
+Pop::pop_size_t Pop::get_size() const {
+	return store->get_sizes()[store_index];
+}
+
+fixed_point_t Pop::get_literacy() const {
+	return store->get_literacies()[store_index];
+}
+
+fixed_point_t Pop::get_militancy() const {
+	return store->get_militancies()[store_index];
+}
+
+fixed_point_t Pop::get_consciousness() const {
+	return store->get_consciousnesses()[store_index];
+}
+
+std::span<fixed_point_t const> Pop::get_ideologies() const {
+	return static_cast<PopStore const*>(store)->get_ideology_weights(store_index);
+}
+
+std::span<fixed_point_t const> Pop::get_issues() const {
+	return static_cast<PopStore const*>(store)->get_issue_weights(store_index);
+}
+
+/* Divides every value by their total, if the total is positive. */
+static void normalise_weights(std::span<fixed_point_t> weights) {
+	fixed_point_t total = 0;
+	for (fixed_point_t const& weight : weights) {
+		total += weight;
+	}
+	if (total > 0) {
+		for (fixed_point_t& weight : weights) {
+			weight /= total;
+		}
+	}
+}
+
+void Pop::setup_pop_test_values(IssueManager const& issue_manager, RandomStream& random) {
+	const pop_size_t size = get_size();
+
 	/* Returns +/- range% of size. */
-	const auto test_size = [this](int32_t range) -> pop_size_t {
-		return size * ((rand() % (2 * range + 1)) - range) / 100;
+	const auto test_size = [size, &random](int32_t range) -> pop_size_t {
+		return size * random.next_in_range(-range, range) / 100;
 	};
 
 	num_grown = test_size(5);
@@ -60,48 +105,48 @@ void Pop::setup_pop_test_values(IssueManager const& issue_manager) {
 	total_change =
 		num_grown + num_promoted + num_demoted + num_migrated_internal + num_migrated_external + num_migrated_colonial;
 
-	/* Generates a number between 0 and max (inclusive) and sets map[&key] to it if it's at least min. */
-	auto test_weight =
-		[]<typename T, typename U>(T& map, U const& key, int32_t min, int32_t max) -> void {
-			const int32_t value = rand() % (max + 1);
-			if (value >= min) {
-				if constexpr (utility::is_specialization_of_v<T, IndexedMap>) {
-					map[key] = value;
-				} else {
-					map.emplace(&key, value);
-				}
-			}
-		};
+	/* Generates a number between 0 and max (inclusive) and sets weight to it if it's at least min. */
+	const auto test_weight = [&random](fixed_point_t& weight, int32_t min, int32_t max) -> void {
+		const int32_t value = random.next_in_range(0, max);
+		if (value >= min) {
+			weight = value;
+		}
+	};
 
 	/* All entries equally weighted for testing. */
-	ideologies.clear();
-	for (Ideology const& ideology : *ideologies.get_keys()) {
-		test_weight(ideologies, ideology, 1, 5);
+	const std::span<fixed_point_t> ideologies = store->get_ideology_weights(store_index);
+	std::fill(ideologies.begin(), ideologies.end(), fixed_point_t::_0());
+	for (fixed_point_t& ideology_weight : ideologies) {
+		test_weight(ideology_weight, 1, 5);
 	}
-	ideologies.normalise();
+	normalise_weights(ideologies);
 
-	issues.clear();
+	/* The store's issue columns are all Issues followed by all Reforms, matching the order they're iterated in here. */
+	const std::span<fixed_point_t> issues = store->get_issue_weights(store_index);
+	std::fill(issues.begin(), issues.end(), fixed_point_t::_0());
+	size_t issue_column = 0;
 	for (Issue const& issue : issue_manager.get_issues()) {
-		test_weight(issues, issue, 3, 6);
+		test_weight(issues[issue_column++], 3, 6);
 	}
 	for (Reform const& reform : issue_manager.get_reforms()) {
 		if (!reform.get_reform_group().get_type().is_uncivilised()) {
-			test_weight(issues, reform, 3, 6);
+			test_weight(issues[issue_column], 3, 6);
 		}
+		issue_column++;
 	}
-	normalise_fixed_point_map(issues);
+	normalise_weights(issues);
 
 	if (votes.has_keys()) {
 		votes.clear();
-		for (CountryParty const& party : *votes.get_keys()) {
-			test_weight(votes, party, 4, 10);
+		for (fixed_point_t& vote : votes) {
+			test_weight(vote, 4, 10);
 		}
 		votes.normalise();
 	}
 
 	/* Returns a fixed point between 0 and max. */
-	const auto test_range = [](fixed_point_t max = 1) -> fixed_point_t {
-		return (rand() % 256) * max / 256;
+	const auto test_range = [&random](fixed_point_t max = 1) -> fixed_point_t {
+		return random.next_in_range(0, 255) * max / 256;
 	};
 
 	unemployment = test_range();
@@ -131,6 +176,8 @@ void Pop::update_gamestate(
 	DefineManager const& define_manager, CountryInstance const* owner, fixed_point_t const& pop_size_per_regiment_multiplier
 ) {
 	if (type.get_can_be_recruited()) {
+		const pop_size_t size = get_size();
+
 		if (
 			size < define_manager.get_min_pop_size_for_regiment() || owner == nullptr ||
 			!RegimentType::allowed_cultures_check_culture_in_country(owner->get_allowed_regiment_cultures(), culture, *owner)
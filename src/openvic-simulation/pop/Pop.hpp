@@ -2,6 +2,7 @@
 
 #include <limits>
 #include <ostream>
+#include <span>
 #include <tuple>
 
 #include "openvic-simulation/economy/GoodDefinition.hpp"
@@ -24,6 +25,7 @@ namespace OpenVic {
 	struct IdeologyManager;
 	struct Issue;
 	struct IssueManager;
+	struct RandomStream;
 	struct ProvinceInstance;
 	struct CountryParty;
 	struct DefineManager;
@@ -49,15 +51,34 @@ namespace OpenVic {
 		);
 	};
 
+	struct PopStore;
+
 	/* REQUIREMENTS:
 	 * POP-18, POP-19, POP-20, POP-21, POP-34, POP-35, POP-36, POP-37
 	 */
-	struct Pop : PopBase {
+	/* View onto a pop in a PopStore. Frequently aggregated values (size, literacy, militancy, consciousness, ideology and
+	 * issue weights) are read from the store's columns, while rarely used values are held directly. */
+	struct Pop {
+		friend struct PopStore;
 		friend struct ProvinceInstance;
 
+		using pop_size_t = PopBase::pop_size_t;
+		/* Stable handle for a pop, see PopStore. */
+		using pop_id_t = size_t;
+
 		static constexpr pop_size_t MAX_SIZE = std::numeric_limits<pop_size_t>::max();
+		static constexpr pop_id_t NULL_ID = 0;
 
 	private:
+		PopStore* store;
+		size_t PROPERTY(store_index);
+		pop_id_t PROPERTY(id);
+
+		PopType const& PROPERTY(type);
+		Culture const& PROPERTY(culture);
+		Religion const& PROPERTY(religion);
+		RebelType const* PROPERTY(rebel_type);
+
 		ProvinceInstance const* PROPERTY(location);
 
 		/* Last day's size change by source. */
@@ -69,10 +90,6 @@ namespace OpenVic {
 		pop_size_t PROPERTY(num_migrated_external);
 		pop_size_t PROPERTY(num_migrated_colonial);
 
-		fixed_point_t PROPERTY(literacy);
-
-		IndexedMap<Ideology, fixed_point_t> PROPERTY(ideologies);
-		fixed_point_map_t<Issue const*> PROPERTY(issues);
 		IndexedMap<CountryParty, fixed_point_t> PROPERTY(votes);
 
 		fixed_point_t PROPERTY(unemployment);
@@ -86,7 +103,7 @@ namespace OpenVic {
 
 		size_t PROPERTY(max_supported_regiments);
 
-		Pop(PopBase const& pop_base, decltype(ideologies)::keys_t const& ideology_keys);
+		Pop(PopBase const& pop_base, PopStore& new_store, size_t new_store_index, pop_id_t new_id);
 
 	public:
 		Pop(Pop const&) = delete;
@@ -94,7 +111,16 @@ namespace OpenVic {
 		Pop& operator=(Pop const&) = delete;
 		Pop& operator=(Pop&&) = delete;
 
-		void setup_pop_test_values(IssueManager const& issue_manager);
+		pop_size_t get_size() const;
+		fixed_point_t get_literacy() const;
+		fixed_point_t get_militancy() const;
+		fixed_point_t get_consciousness() const;
+		/* Indexed in the same order as the PopStore's ideology keys. */
+		std::span<fixed_point_t const> get_ideologies() const;
+		/* Indexed in the same order as the PopStore's issue keys. */
+		std::span<fixed_point_t const> get_issues() const;
+
+		void setup_pop_test_values(IssueManager const& issue_manager, RandomStream& random);
 
 		void set_location(ProvinceInstance const& new_location);
 
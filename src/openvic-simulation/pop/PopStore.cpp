@@ -0,0 +1,126 @@
+#include "PopStore.hpp"
+
+#include "openvic-simulation/politics/Ideology.hpp"
+#include "openvic-simulation/politics/Issue.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
+
+using namespace OpenVic;
+
+PopStore::PopStore()
+  : pop_type_keys { nullptr }, culture_keys { nullptr }, religion_keys { nullptr }, ideology_keys { nullptr } {}
+
+bool PopStore::setup(
+	std::vector<PopType> const& new_pop_type_keys, std::vector<Culture> const& new_culture_keys,
+	std::vector<Religion> const& new_religion_keys, std::vector<Ideology> const& new_ideology_keys,
+	IssueManager const& issue_manager
+) {
+	if (!pops.empty()) {
+		Logger::error("Cannot setup pop store - it already contains ", pops.size(), " pops!");
+		return false;
+	}
+
+	pop_type_keys = &new_pop_type_keys;
+	culture_keys = &new_culture_keys;
+	religion_keys = &new_religion_keys;
+	ideology_keys = &new_ideology_keys;
+
+	issue_keys.clear();
+	issue_keys.reserve(issue_manager.get_issue_count() + issue_manager.get_reform_count());
+	for (Issue const& issue : issue_manager.get_issues()) {
+		issue_keys.push_back(&issue);
+	}
+	for (Reform const& reform : issue_manager.get_reforms()) {
+		issue_keys.push_back(&reform);
+	}
+
+	return true;
+}
+
+void PopStore::reserve(size_t count) {
+	pops.reserve(count);
+	sizes.reserve(count);
+	type_indices.reserve(count);
+	culture_indices.reserve(count);
+	religion_indices.reserve(count);
+	literacies.reserve(count);
+	militancies.reserve(count);
+	consciousnesses.reserve(count);
+	ideology_weights.reserve(count * get_ideology_count());
+	issue_weights.reserve(count * get_issue_count());
+	pop_indices_by_id.reserve(count);
+}
+
+void PopStore::clear() {
+	pops.clear();
+	sizes.clear();
+	type_indices.clear();
+	culture_indices.clear();
+	religion_indices.clear();
+	literacies.clear();
+	militancies.clear();
+	consciousnesses.clear();
+	ideology_weights.clear();
+	issue_weights.clear();
+	pop_indices_by_id.clear();
+}
+
+template<typename T>
+static size_t get_key_index(std::vector<T> const* keys, T const& key) {
+	if (keys != nullptr && !keys->empty() && keys->data() <= &key && &key <= &keys->back()) {
+		return std::distance(keys->data(), &key);
+	} else {
+		Logger::error("Pop store key \"", key, "\" is not in the store's key list!");
+		return PopStore::NO_KEY_INDEX;
+	}
+}
+
+Pop& PopStore::add_pop(PopBase const& pop_base) {
+	const pop_index_t index = pops.size();
+
+	sizes.push_back(pop_base.get_size());
+	type_indices.push_back(get_key_index(pop_type_keys, pop_base.get_type()));
+	culture_indices.push_back(get_key_index(culture_keys, pop_base.get_culture()));
+	religion_indices.push_back(get_key_index(religion_keys, pop_base.get_religion()));
+	literacies.push_back(0);
+	militancies.push_back(pop_base.get_militancy());
+	consciousnesses.push_back(pop_base.get_consciousness());
+
+	ideology_weights.resize(ideology_weights.size() + get_ideology_count());
+	issue_weights.resize(issue_weights.size() + get_issue_count());
+
+	pop_indices_by_id.push_back(index);
+	pops.push_back(Pop { pop_base, *this, index, pop_indices_by_id.size() });
+	return pops.back();
+}
+
+Pop* PopStore::get_pop_by_id(pop_id_t id) {
+	return id != Pop::NULL_ID && id <= pop_indices_by_id.size() ? &pops[pop_indices_by_id[id - 1]] : nullptr;
+}
+
+Pop const* PopStore::get_pop_by_id(pop_id_t id) const {
+	return id != Pop::NULL_ID && id <= pop_indices_by_id.size() ? &pops[pop_indices_by_id[id - 1]] : nullptr;
+}
+
+std::span<Pop> PopStore::get_pops(pop_range_t range) {
+	return { pops.data() + range.begin, range.size() };
+}
+
+std::span<Pop const> PopStore::get_pops(pop_range_t range) const {
+	return { pops.data() + range.begin, range.size() };
+}
+
+std::span<fixed_point_t> PopStore::get_ideology_weights(pop_index_t index) {
+	return { ideology_weights.data() + index * get_ideology_count(), get_ideology_count() };
+}
+
+std::span<fixed_point_t const> PopStore::get_ideology_weights(pop_index_t index) const {
+	return { ideology_weights.data() + index * get_ideology_count(), get_ideology_count() };
+}
+
+std::span<fixed_point_t> PopStore::get_issue_weights(pop_index_t index) {
+	return { issue_weights.data() + index * get_issue_count(), get_issue_count() };
+}
+
+std::span<fixed_point_t const> PopStore::get_issue_weights(pop_index_t index) const {
+	return { issue_weights.data() + index * get_issue_count(), get_issue_count() };
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "openvic-simulation/pop/Pop.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
+
+namespace OpenVic {
+	struct Issue;
+	struct IssueManager;
+
+	/* Structure-of-arrays storage for every pop in the game. The values which are aggregated every day (size, type,
+	 * culture, religion, literacy, militancy and consciousness) each live in their own contiguous column, and ideology and
+	 * issue weights live in row-major tables with one row per pop, so province updates only pull in the data they sum.
+	 * The Pop objects stored alongside the columns are thin views onto them which also hold the rarely used per-pop data.
+	 * Pops are expected to be added province by province, with each province referring to its pops by an index range.
+	 * Unlike the plf::colony pops used to be stored in, adding a pop can move every other pop, so Pop pointers and
+	 * references must not be held across additions. Anything which needs to refer to a pop for longer, e.g. a regiment
+	 * or a list of employees, should hold its ID instead and look it up with get_pop_by_id. IDs are never reused until the
+	 * store is cleared. */
+	struct PopStore {
+		using pop_index_t = size_t;
+		using pop_id_t = Pop::pop_id_t;
+
+		/* Stored in a key index column when the pop's key isn't in the store's key list. */
+		static constexpr size_t NO_KEY_INDEX = static_cast<size_t>(-1);
+
+		struct pop_range_t {
+			pop_index_t begin = 0;
+			pop_index_t end = 0;
+
+			constexpr size_t size() const {
+				return end - begin;
+			}
+
+			constexpr bool empty() const {
+				return begin == end;
+			}
+		};
+
+	private:
+		std::vector<Pop> PROPERTY_REF(pops);
+
+		std::vector<Pop::pop_size_t> PROPERTY(sizes);
+		std::vector<size_t> PROPERTY(type_indices);
+		std::vector<size_t> PROPERTY(culture_indices);
+		std::vector<size_t> PROPERTY(religion_indices);
+		std::vector<fixed_point_t> PROPERTY(literacies);
+		std::vector<fixed_point_t> PROPERTY(militancies);
+		std::vector<fixed_point_t> PROPERTY(consciousnesses);
+
+		std::vector<PopType> const* PROPERTY(pop_type_keys);
+		std::vector<Culture> const* PROPERTY(culture_keys);
+		std::vector<Religion> const* PROPERTY(religion_keys);
+		std::vector<Ideology> const* PROPERTY(ideology_keys);
+		/* All Issues followed by all Reforms, each in registry order. */
+		std::vector<Issue const*> PROPERTY(issue_keys);
+
+		std::vector<fixed_point_t> ideology_weights;
+		std::vector<fixed_point_t> issue_weights;
+
+		/* Indexed by pop ID - 1, as Pop::NULL_ID is 0. */
+		std::vector<pop_index_t> pop_indices_by_id;
+
+	public:
+		PopStore();
+		PopStore(PopStore const&) = delete;
+		PopStore(PopStore&&) = delete;
+		PopStore& operator=(PopStore const&) = delete;
+		PopStore& operator=(PopStore&&) = delete;
+
+		bool setup(
+			std::vector<PopType> const& new_pop_type_keys, std::vector<Culture> const& new_culture_keys,
+			std::vector<Religion> const& new_religion_keys, std::vector<Ideology> const& new_ideology_keys,
+			IssueManager const& issue_manager
+		);
+
+		void reserve(size_t count);
+		void clear();
+
+		constexpr size_t get_pop_count() const {
+			return pops.size();
+		}
+
+		constexpr size_t get_ideology_count() const {
+			return ideology_keys != nullptr ? ideology_keys->size() : 0;
+		}
+
+		constexpr size_t get_issue_count() const {
+			return issue_keys.size();
+		}
+
+		/* Appends a new pop to the end of the store, returning a reference which is only valid until the next pop is added,
+		 * and giving it the next unused ID.
+		 * The pop's type, culture and religion must be from the key lists the store was set up with. */
+		Pop& add_pop(PopBase const& pop_base);
+
+		/* Returns nullptr if no pop has the ID. */
+		Pop* get_pop_by_id(pop_id_t id);
+		Pop const* get_pop_by_id(pop_id_t id) const;
+
+		std::span<Pop> get_pops(pop_range_t range);
+		std::span<Pop const> get_pops(pop_range_t range) const;
+
+		/* Rows of the weight tables, indexed in the same order as the ideology and issue key lists. */
+		std::span<fixed_point_t> get_ideology_weights(pop_index_t index);
+		std::span<fixed_point_t const> get_ideology_weights(pop_index_t index) const;
+		std::span<fixed_point_t> get_issue_weights(pop_index_t index);
+		std::span<fixed_point_t const> get_issue_weights(pop_index_t index) const;
+	};
+}
@@ -23,7 +23,7 @@ ConditionNode::ConditionNode(
 	HasIdentifier const* new_condition_key_item,
 	HasIdentifier const* new_condition_value_item
 ) : condition { new_condition }, value { std::move(new_value) }, valid { new_valid },
-	condition_key_item { new_condition_key_item }, condition_value_item { new_condition_key_item } {}
+	condition_key_item { new_condition_key_item }, condition_value_item { new_condition_value_item } {}
 
 bool ConditionManager::add_condition(
 	std::string_view identifier, value_type_t value_type, scope_t scope, scope_t scope_change,
@@ -0,0 +1,812 @@
+#include "ConditionBytecode.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <span>
+
+#include "openvic-simulation/country/CountryDefinition.hpp"
+#include "openvic-simulation/country/CountryInstance.hpp"
+#include "openvic-simulation/InstanceManager.hpp"
+#include "openvic-simulation/map/MapInstance.hpp"
+#include "openvic-simulation/map/ProvinceDefinition.hpp"
+#include "openvic-simulation/map/ProvinceInstance.hpp"
+#include "openvic-simulation/map/Region.hpp"
+#include "openvic-simulation/map/State.hpp"
+#include "openvic-simulation/map/TerrainType.hpp"
+#include "openvic-simulation/politics/Government.hpp"
+#include "openvic-simulation/politics/Ideology.hpp"
+#include "openvic-simulation/politics/Issue.hpp"
+#include "openvic-simulation/politics/NationalValue.hpp"
+#include "openvic-simulation/pop/Pop.hpp"
+#include "openvic-simulation/research/Invention.hpp"
+#include "openvic-simulation/research/Technology.hpp"
+#include "openvic-simulation/types/OrderedContainers.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
+#include "openvic-simulation/utility/StringUtils.hpp"
+
+using namespace OpenVic;
+
+using opcode_t = ConditionBytecode::opcode_t;
+using argument_t = ConditionBytecode::argument_t;
+using result_t = ConditionBytecode::result_t;
+
+struct ConditionBytecode::context_t {
+	ConditionScope this_scope;
+	ConditionScope from_scope;
+	InstanceManager const& instance_manager;
+};
+
+ConditionBytecode::ConditionBytecode() : unsupported_count { 0 } {}
+
+/* Opcodes for conditions with a fixed identifier. Conditions imported from other registries, e.g. country tag scopes and
+ * technologies, are recognised by their key identifier type instead. */
+static opcode_t get_opcode(Condition const& condition) {
+	using enum ConditionBytecode::opcode_t;
+
+	static const string_map_t<opcode_t> opcodes {
+		{ "AND", AND }, { "OR", OR }, { "NOT", NOT },
+
+		{ "THIS", SCOPE_THIS }, { "FROM", SCOPE_FROM }, { "owner", SCOPE_OWNER }, { "country", SCOPE_OWNER },
+		{ "controller", SCOPE_CONTROLLER }, { "capital_scope", SCOPE_CAPITAL }, { "location", SCOPE_LOCATION },
+		{ "state_scope", SCOPE_STATE }, { "any_owned_province", ANY_OWNED_PROVINCE }, { "any_core", ANY_CORE },
+		{ "all_core", ALL_CORE }, { "any_state", ANY_STATE }, { "any_pop", ANY_POP },
+		{ "any_greater_power", ANY_GREATER_POWER },
+
+		{ "always", ALWAYS }, { "year", YEAR }, { "month", MONTH },
+
+		{ "tag", TAG }, { "exists", EXISTS }, { "civilized", CIVILISED }, { "is_greater_power", GREAT_POWER },
+		{ "is_secondary_power", SECONDARY_POWER }, { "is_mobilised", MOBILISED }, { "is_disarmed", DISARMED },
+		{ "prestige", PRESTIGE }, { "badboy", BADBOY }, { "money", MONEY }, { "treasury", MONEY },
+		{ "plurality", PLURALITY }, { "revanchism", REVANCHISM }, { "war_exhaustion", WAR_EXHAUSTION },
+		{ "industrial_score", INDUSTRIAL_SCORE }, { "military_score", MILITARY_SCORE }, { "rank", RANK },
+		{ "total_pops", TOTAL_POPS }, { "number_of_states", NUMBER_OF_STATES }, { "primary_culture", PRIMARY_CULTURE },
+		{ "accepted_culture", ACCEPTED_CULTURE }, { "government", GOVERNMENT },
+		{ "ruling_party_ideology", RULING_PARTY_IDEOLOGY }, { "tech_school", TECH_SCHOOL },
+		{ "nationalvalue", NATIONAL_VALUE }, { "has_country_flag", HAS_COUNTRY_FLAG }, { "invention", INVENTION },
+		{ "owns", OWNS }, { "controls", CONTROLS }, { "capital", CAPITAL },
+
+		{ "culture", CULTURE }, { "religion", RELIGION }, { "militancy", MILITANCY },
+		{ "average_militancy", MILITANCY }, { "consciousness", CONSCIOUSNESS },
+		{ "average_consciousness", CONSCIOUSNESS }, { "literacy", LITERACY },
+
+		{ "owned_by", OWNED_BY }, { "controlled_by", CONTROLLED_BY }, { "is_core", IS_CORE_OF },
+		{ "is_capital", IS_CAPITAL }, { "is_coastal", IS_COASTAL }, { "port", PORT }, { "life_rating", LIFE_RATING },
+		{ "trade_goods", TRADE_GOODS }, { "terrain", TERRAIN }, { "province_id", PROVINCE_ID }, { "continent", CONTINENT },
+		{ "is_colonial", IS_COLONIAL }, { "is_slave", IS_SLAVE },
+
+		{ "pop_type", POP_TYPE }, { "type", POP_TYPE }, { "strata", STRATA }, { "life_needs", LIFE_NEEDS },
+		{ "everyday_needs", EVERYDAY_NEEDS }, { "luxury_needs", LUXURY_NEEDS }
+	};
+
+	const string_map_t<opcode_t>::const_iterator it = opcodes.find(condition.get_identifier());
+	if (it != opcodes.end()) {
+		return it->second;
+	}
+
+	switch (condition.get_key_identifier_type()) {
+	case identifier_type_t::COUNTRY_TAG:
+		return SCOPE_COUNTRY;
+	case identifier_type_t::PROVINCE_ID:
+		return SCOPE_PROVINCE;
+	case identifier_type_t::TECHNOLOGY:
+		return TECHNOLOGY;
+	case identifier_type_t::REFORM_GROUP:
+		return REFORM;
+	default:
+		return UNSUPPORTED;
+	}
+}
+
+static constexpr bool is_group(opcode_t opcode) {
+	using enum ConditionBytecode::opcode_t;
+	return AND <= opcode && opcode <= ANY_GREATER_POWER;
+}
+
+/* Whether the opcode's argument comes from the condition's key rather than its value. */
+static constexpr bool takes_key_item(opcode_t opcode) {
+	using enum ConditionBytecode::opcode_t;
+	return opcode == SCOPE_COUNTRY || opcode == SCOPE_PROVINCE || opcode == TECHNOLOGY;
+}
+
+/* Whether the opcode's argument is a country, which can also be given as THIS or FROM. */
+static constexpr bool takes_country(opcode_t opcode) {
+	using enum ConditionBytecode::opcode_t;
+	switch (opcode) {
+	case TAG:
+	case EXISTS:
+	case INDUSTRIAL_SCORE:
+	case MILITARY_SCORE:
+	case OWNED_BY:
+	case CONTROLLED_BY:
+	case IS_CORE_OF:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* Whether the opcode has no meaning without an identifier argument, whether from the condition's key or its value. */
+static constexpr bool requires_item(opcode_t opcode) {
+	using enum ConditionBytecode::opcode_t;
+	switch (opcode) {
+	case SCOPE_COUNTRY:
+	case SCOPE_PROVINCE:
+	case TECHNOLOGY:
+	case TAG:
+	case PRIMARY_CULTURE:
+	case ACCEPTED_CULTURE:
+	case GOVERNMENT:
+	case RULING_PARTY_IDEOLOGY:
+	case TECH_SCHOOL:
+	case NATIONAL_VALUE:
+	case INVENTION:
+	case REFORM:
+	case OWNS:
+	case CONTROLS:
+	case CAPITAL:
+	case HAS_CORE_IN_PROVINCE:
+	case CULTURE:
+	case RELIGION:
+	case OWNED_BY:
+	case CONTROLLED_BY:
+	case IS_CORE_OF:
+	case TRADE_GOODS:
+	case TERRAIN:
+	case PROVINCE_ID:
+	case CONTINENT:
+	case POP_TYPE:
+	case STRATA:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void ConditionBytecode::_compile_node(ConditionNode const& node) {
+	using enum opcode_t;
+
+	const size_t index = instructions.size();
+	instruction_t instruction { UNSUPPORTED, argument_t::NONE, false, 0, 0, 0, nullptr };
+
+	Condition const* condition = node.get_condition();
+	if (condition != nullptr && node.is_valid()) {
+		instruction.opcode = get_opcode(*condition);
+	}
+
+	ConditionNode::value_t const& value = node.get_value();
+
+	if (ConditionNode::boolean_t const* boolean = std::get_if<ConditionNode::boolean_t>(&value)) {
+		instruction.flag = *boolean;
+	} else if (ConditionNode::integer_t const* integer = std::get_if<ConditionNode::integer_t>(&value)) {
+		instruction.value = fixed_point_t::parse(static_cast<int64_t>(*integer));
+	} else if (ConditionNode::real_t const* real = std::get_if<ConditionNode::real_t>(&value)) {
+		instruction.value = *real;
+	} else if (ConditionNode::string_t const* string = std::get_if<ConditionNode::string_t>(&value)) {
+		if (instruction.opcode == HAS_COUNTRY_FLAG) {
+			instruction.string_index = strings.size();
+			strings.push_back(*string);
+		} else if (instruction.opcode == IS_CORE_OF && !string->empty() && std::all_of(
+			string->begin(), string->end(), [](char c) -> bool { return '0' <= c && c <= '9'; }
+		)) {
+			/* is_core takes a province ID in country scope and a country tag in province scope. */
+			instruction.opcode = HAS_CORE_IN_PROVINCE;
+		}
+
+		if (node.get_condition_value_item() != nullptr) {
+			instruction.argument = argument_t::ITEM;
+			instruction.item = node.get_condition_value_item();
+		} else if (takes_country(instruction.opcode) && StringUtils::strings_equal_case_insensitive(*string, "THIS")) {
+			instruction.argument = argument_t::THIS;
+		} else if (takes_country(instruction.opcode) && StringUtils::strings_equal_case_insensitive(*string, "FROM")) {
+			instruction.argument = argument_t::FROM;
+		} else {
+			/* Conditions accepting either an identifier or a boolean, e.g. exists, keep yes and no as a string. */
+			instruction.flag = StringUtils::strings_equal_case_insensitive(*string, "yes");
+		}
+	}
+
+	if (takes_key_item(instruction.opcode)) {
+		instruction.item = node.get_condition_key_item();
+		instruction.argument = instruction.item != nullptr ? argument_t::ITEM : argument_t::NONE;
+	}
+
+	if (requires_item(instruction.opcode) && instruction.argument == argument_t::NONE) {
+		instruction.opcode = UNSUPPORTED;
+	}
+	if (instruction.opcode == UNSUPPORTED) {
+		unsupported_count++;
+	}
+
+	instructions.push_back(instruction);
+
+	if (is_group(instruction.opcode)) {
+		if (ConditionNode::condition_list_t const* children = std::get_if<ConditionNode::condition_list_t>(&value)) {
+			for (ConditionNode const& child : *children) {
+				_compile_node(child);
+			}
+		}
+	}
+
+	instructions[index].end = instructions.size();
+}
+
+bool ConditionBytecode::compile(ConditionNode const& root) {
+	instructions.clear();
+	strings.clear();
+	unsupported_count = 0;
+
+	if (root.get_condition() == nullptr) {
+		return true;
+	}
+
+	_compile_node(root);
+
+	if (instructions.size() > std::numeric_limits<decltype(instruction_t::end)>::max()) {
+		Logger::error("Condition compiled to too many instructions: ", instructions.size());
+		instructions.clear();
+		return false;
+	}
+
+	instructions.shrink_to_fit();
+	return true;
+}
+
+static CountryInstance const* get_scope_country(ConditionScope scope) {
+	switch (scope.get_type()) {
+	case scope_t::COUNTRY:
+		return scope.get_country();
+	case scope_t::STATE:
+		return scope.get_state() != nullptr ? scope.get_state()->get_owner() : nullptr;
+	case scope_t::PROVINCE:
+		return scope.get_province() != nullptr ? scope.get_province()->get_owner() : nullptr;
+	case scope_t::POP:
+		return scope.get_pop() != nullptr && scope.get_pop()->get_location() != nullptr
+			? scope.get_pop()->get_location()->get_owner() : nullptr;
+	default:
+		return nullptr;
+	}
+}
+
+static ProvinceInstance const* get_scope_province(ConditionScope scope) {
+	switch (scope.get_type()) {
+	case scope_t::PROVINCE:
+		return scope.get_province();
+	case scope_t::POP:
+		return scope.get_pop() != nullptr ? scope.get_pop()->get_location() : nullptr;
+	default:
+		return nullptr;
+	}
+}
+
+static State const* get_scope_state(ConditionScope scope) {
+	if (scope.get_type() == scope_t::STATE) {
+		return scope.get_state();
+	}
+	ProvinceInstance const* province = get_scope_province(scope);
+	return province != nullptr ? province->get_state() : nullptr;
+}
+
+static constexpr result_t to_result(bool value) {
+	return value ? result_t::YES : result_t::NO;
+}
+
+/* Three-valued AND of func's result for each element: NO as soon as any is NO, otherwise INDETERMINATE if any is. */
+template<typename Range, typename Func>
+static result_t all_of_result(Range const& range, Func&& func) {
+	result_t result = result_t::YES;
+	for (auto const& element : range) {
+		const result_t element_result = func(element);
+		if (element_result == result_t::NO) {
+			return result_t::NO;
+		}
+		if (element_result == result_t::INDETERMINATE) {
+			result = result_t::INDETERMINATE;
+		}
+	}
+	return result;
+}
+
+/* Three-valued OR of func's result for each element: YES as soon as any is YES, otherwise INDETERMINATE if any is. */
+template<typename Range, typename Func>
+static result_t any_of_result(Range const& range, Func&& func) {
+	result_t result = result_t::NO;
+	for (auto const& element : range) {
+		const result_t element_result = func(element);
+		if (element_result == result_t::YES) {
+			return result_t::YES;
+		}
+		if (element_result == result_t::INDETERMINATE) {
+			result = result_t::INDETERMINATE;
+		}
+	}
+	return result;
+}
+
+/* Three-valued OR of func's result for each of the scope's pops. */
+template<typename Func>
+static result_t any_pop_in_scope(ConditionScope scope, Func&& func) {
+	const auto any_pop_in_province = [&func](ProvinceInstance const* province) -> result_t {
+		return any_of_result(province->get_pops(), func);
+	};
+
+	switch (scope.get_type()) {
+	case scope_t::COUNTRY:
+		return scope.get_country() != nullptr
+			? any_of_result(scope.get_country()->get_owned_provinces(), any_pop_in_province) : result_t::NO;
+	case scope_t::STATE:
+		return scope.get_state() != nullptr
+			? any_of_result(scope.get_state()->get_provinces(), any_pop_in_province) : result_t::NO;
+	case scope_t::PROVINCE:
+		return scope.get_province() != nullptr ? any_pop_in_province(scope.get_province()) : result_t::NO;
+	default:
+		return result_t::NO;
+	}
+}
+
+/* Whether item is the largest entry of a province or state's culture or religion distribution. */
+template<typename Key>
+static bool is_largest_in_distribution(SparseIndexedMap<Key, fixed_point_t> const& distribution, HasIdentifier const* item) {
+	const size_t largest_index = distribution.get_largest_two_indices().first;
+	return largest_index != SparseIndexedMap<Key, fixed_point_t>::NO_INDEX && &distribution(largest_index) == item;
+}
+
+template<typename Container>
+static bool contains_pointer(Container const& container, void const* pointer) {
+	return std::any_of(container.begin(), container.end(), [pointer](auto const* element) -> bool {
+		return element == pointer;
+	});
+}
+
+static CountryInstance const* get_argument_country(
+	ConditionBytecode::instruction_t const& instruction, ConditionScope this_scope, ConditionScope from_scope,
+	InstanceManager const& instance_manager
+) {
+	switch (instruction.argument) {
+	case argument_t::ITEM:
+		return &instance_manager.get_country_instance_manager().get_country_instance_from_definition(
+			*static_cast<CountryDefinition const*>(instruction.item)
+		);
+	case argument_t::THIS:
+		return get_scope_country(this_scope);
+	case argument_t::FROM:
+		return get_scope_country(from_scope);
+	default:
+		return nullptr;
+	}
+}
+
+result_t ConditionBytecode::_evaluate_all(size_t index, ConditionScope scope, context_t const& context) const {
+	const size_t end = instructions[index].end;
+	result_t result = result_t::YES;
+	for (size_t child = index + 1; child < end; child = instructions[child].end) {
+		const result_t child_result = _evaluate(child, scope, context);
+		if (child_result == result_t::NO) {
+			return result_t::NO;
+		}
+		if (child_result == result_t::INDETERMINATE) {
+			result = result_t::INDETERMINATE;
+		}
+	}
+	return result;
+}
+
+result_t ConditionBytecode::_evaluate_any(size_t index, ConditionScope scope, context_t const& context) const {
+	const size_t end = instructions[index].end;
+	result_t result = result_t::NO;
+	for (size_t child = index + 1; child < end; child = instructions[child].end) {
+		const result_t child_result = _evaluate(child, scope, context);
+		if (child_result == result_t::YES) {
+			return result_t::YES;
+		}
+		if (child_result == result_t::INDETERMINATE) {
+			result = result_t::INDETERMINATE;
+		}
+	}
+	return result;
+}
+
+result_t ConditionBytecode::_evaluate(size_t index, ConditionScope scope, context_t const& context) const {
+	using enum opcode_t;
+
+	instruction_t const& instruction = instructions[index];
+
+	/* Evaluates the children in a new scope, which is NO if the scope doesn't exist, e.g. an unowned province's owner. */
+	const auto evaluate_in = [this, index, &context](ConditionScope new_scope) -> result_t {
+		return new_scope.is_valid() ? _evaluate_all(index, new_scope, context) : result_t::NO;
+	};
+
+	switch (instruction.opcode) {
+	case UNSUPPORTED:
+		return result_t::INDETERMINATE;
+	case AND:
+		return _evaluate_all(index, scope, context);
+	case OR:
+		return _evaluate_any(index, scope, context);
+	case NOT:
+		switch (_evaluate_any(index, scope, context)) {
+		case result_t::NO:
+			return result_t::YES;
+		case result_t::YES:
+			return result_t::NO;
+		default:
+			return result_t::INDETERMINATE;
+		}
+	case SCOPE_THIS:
+		return evaluate_in(context.this_scope);
+	case SCOPE_FROM:
+		return evaluate_in(context.from_scope);
+	case SCOPE_COUNTRY:
+		return evaluate_in(&context.instance_manager.get_country_instance_manager().get_country_instance_from_definition(
+			*static_cast<CountryDefinition const*>(instruction.item)
+		));
+	case SCOPE_PROVINCE:
+		return evaluate_in(&context.instance_manager.get_map_instance().get_province_instance_from_definition(
+			*static_cast<ProvinceDefinition const*>(instruction.item)
+		));
+	case SCOPE_OWNER:
+		return evaluate_in(get_scope_country(scope));
+	case SCOPE_CONTROLLER: {
+		ProvinceInstance const* province = get_scope_province(scope);
+		return province != nullptr ? evaluate_in(province->get_controller()) : result_t::NO;
+	}
+	case SCOPE_CAPITAL: {
+		CountryInstance const* country = get_scope_country(scope);
+		return country != nullptr ? evaluate_in(country->get_capital()) : result_t::NO;
+	}
+	case SCOPE_LOCATION:
+		return evaluate_in(get_scope_province(scope));
+	case SCOPE_STATE:
+		return evaluate_in(get_scope_state(scope));
+	case ANY_OWNED_PROVINCE: {
+		CountryInstance const* country = get_scope_country(scope);
+		return country != nullptr ? any_of_result(country->get_owned_provinces(), evaluate_in) : result_t::NO;
+	}
+	case ANY_CORE: {
+		CountryInstance const* country = get_scope_country(scope);
+		return country != nullptr ? any_of_result(country->get_core_provinces(), evaluate_in) : result_t::NO;
+	}
+	case ALL_CORE: {
+		CountryInstance const* country = get_scope_country(scope);
+		return country != nullptr ? all_of_result(country->get_core_provinces(), evaluate_in) : result_t::NO;
+	}
+	case ANY_STATE: {
+		CountryInstance const* country = get_scope_country(scope);
+		return country != nullptr ? any_of_result(country->get_states(), evaluate_in) : result_t::NO;
+	}
+	case ANY_POP:
+		return any_pop_in_scope(scope, [&evaluate_in](Pop const& pop) -> result_t {
+			return evaluate_in(&pop);
+		});
+	case ANY_GREATER_POWER:
+		return any_of_result(context.instance_manager.get_country_instance_manager().get_great_powers(), evaluate_in);
+	default:
+		return to_result(_evaluate_leaf(instruction, scope, context));
+	}
+}
+
+bool ConditionBytecode::_evaluate_leaf(
+	instruction_t const& instruction, ConditionScope scope, context_t const& context
+) const {
+	using enum opcode_t;
+
+	const fixed_point_t value = instruction.value;
+	HasIdentifier const* item = instruction.item;
+
+	const auto argument_country = [&instruction, &context]() -> CountryInstance const* {
+		return get_argument_country(instruction, context.this_scope, context.from_scope, context.instance_manager);
+	};
+
+	switch (instruction.opcode) {
+	case ALWAYS:
+		return instruction.flag;
+	case YEAR:
+		return fixed_point_t::parse(context.instance_manager.get_today().get_year()) >= value;
+	case MONTH:
+		return fixed_point_t::parse(context.instance_manager.get_today().get_month()) >= value;
+	default:
+		break;
+	}
+
+	if (instruction.opcode < CULTURE) {
+		/* Country conditions */
+		CountryInstance const* country = get_scope_country(scope);
+		if (country == nullptr) {
+			return false;
+		}
+
+		switch (instruction.opcode) {
+		case TAG:
+			return instruction.argument == argument_t::ITEM
+				? country->get_country_definition() == item : country == argument_country();
+		case EXISTS:
+			if (instruction.argument == argument_t::NONE) {
+				return country->exists() == instruction.flag;
+			} else {
+				CountryInstance const* other = argument_country();
+				return other != nullptr && other->exists();
+			}
+		case CIVILISED:
+			return country->is_civilised() == instruction.flag;
+		case GREAT_POWER:
+			return country->is_great_power() == instruction.flag;
+		case SECONDARY_POWER:
+			return country->is_secondary_power() == instruction.flag;
+		case MOBILISED:
+			return country->is_mobilised() == instruction.flag;
+		case DISARMED:
+			return country->is_disarmed() == instruction.flag;
+		case PRESTIGE:
+			return country->get_prestige() >= value;
+		case BADBOY:
+			return country->get_infamy() >= value;
+		case MONEY:
+			return country->get_cash_stockpile() >= value;
+		case PLURALITY:
+			return country->get_plurality() >= value;
+		case REVANCHISM:
+			return country->get_revanchism() >= value;
+		case WAR_EXHAUSTION:
+			return country->get_war_exhaustion() >= value;
+		case INDUSTRIAL_SCORE:
+			if (instruction.argument == argument_t::NONE) {
+				return country->get_industrial_power() >= value;
+			} else {
+				CountryInstance const* other = argument_country();
+				return other != nullptr && country->get_industrial_power() >= other->get_industrial_power();
+			}
+		case MILITARY_SCORE:
+			if (instruction.argument == argument_t::NONE) {
+				return country->get_military_power() >= value;
+			} else {
+				CountryInstance const* other = argument_country();
+				return other != nullptr && country->get_military_power() >= other->get_military_power();
+			}
+		case RANK:
+			return fixed_point_t::parse(static_cast<int64_t>(country->get_total_rank())) <= value;
+		case TOTAL_POPS:
+			return fixed_point_t::parse(static_cast<int64_t>(country->get_total_population())) >= value;
+		case NUMBER_OF_STATES:
+			return fixed_point_t::parse(static_cast<int64_t>(country->get_states().size())) >= value;
+		case PRIMARY_CULTURE:
+			return country->get_primary_culture() == item;
+		case ACCEPTED_CULTURE:
+			return country->is_accepted_culture(*static_cast<Culture const*>(item));
+		case GOVERNMENT:
+			return country->get_government_type() == item;
+		case RULING_PARTY_IDEOLOGY:
+			return country->get_ruling_party() != nullptr && &country->get_ruling_party()->get_ideology() == item;
+		case TECH_SCHOOL:
+			return country->get_tech_school() == item;
+		case NATIONAL_VALUE:
+			return country->get_national_value() == item;
+		case HAS_COUNTRY_FLAG:
+			return country->get_country_flags().contains(strings[instruction.string_index]);
+		case TECHNOLOGY:
+			return country->is_technology_unlocked(*static_cast<Technology const*>(item)) == instruction.flag;
+		case INVENTION:
+			return country->is_invention_unlocked(*static_cast<Invention const*>(item));
+		case REFORM: {
+			Reform const& reform = *static_cast<Reform const*>(item);
+			return country->get_reforms()[reform.get_reform_group()] == &reform;
+		}
+		case OWNS:
+			return context.instance_manager.get_map_instance().get_province_instance_from_definition(
+				*static_cast<ProvinceDefinition const*>(item)
+			).get_owner() == country;
+		case CONTROLS:
+			return context.instance_manager.get_map_instance().get_province_instance_from_definition(
+				*static_cast<ProvinceDefinition const*>(item)
+			).get_controller() == country;
+		case CAPITAL:
+			return country->get_capital() != nullptr && &country->get_capital()->get_province_definition() == item;
+		case HAS_CORE_IN_PROVINCE:
+			return contains_pointer(
+				context.instance_manager.get_map_instance().get_province_instance_from_definition(
+					*static_cast<ProvinceDefinition const*>(item)
+				).get_cores(),
+				country
+			);
+		default:
+			return false;
+		}
+	}
+
+	if (instruction.opcode < OWNED_BY) {
+		/* Conditions whose meaning depends on the scope */
+		Pop const* pop = scope.get_pop();
+
+		switch (instruction.opcode) {
+		case CULTURE:
+			if (pop != nullptr) {
+				return &pop->get_culture() == item;
+			} else if (ProvinceInstance const* province = scope.get_province()) {
+				return is_largest_in_distribution(province->get_culture_distribution(), item);
+			} else if (State const* state = scope.get_state()) {
+				return is_largest_in_distribution(state->get_culture_distribution(), item);
+			} else {
+				CountryInstance const* country = scope.get_country();
+				return country != nullptr && country->get_primary_culture() == item;
+			}
+		case RELIGION:
+			if (pop != nullptr) {
+				return &pop->get_religion() == item;
+			} else if (ProvinceInstance const* province = scope.get_province()) {
+				return is_largest_in_distribution(province->get_religion_distribution(), item);
+			} else if (State const* state = scope.get_state()) {
+				return is_largest_in_distribution(state->get_religion_distribution(), item);
+			} else {
+				CountryInstance const* country = scope.get_country();
+				return country != nullptr && country->get_religion() == item;
+			}
+		default:
+			break;
+		}
+
+		if (pop != nullptr) {
+			switch (instruction.opcode) {
+			case MILITANCY:
+				return pop->get_militancy() >= value;
+			case CONSCIOUSNESS:
+				return pop->get_consciousness() >= value;
+			case LITERACY:
+				return pop->get_literacy() >= value;
+			default:
+				return false;
+			}
+		} else if (ProvinceInstance const* province = scope.get_province()) {
+			switch (instruction.opcode) {
+			case MILITANCY:
+				return province->get_average_militancy() >= value;
+			case CONSCIOUSNESS:
+				return province->get_average_consciousness() >= value;
+			case LITERACY:
+				return province->get_average_literacy() >= value;
+			default:
+				return false;
+			}
+		} else if (State const* state = scope.get_state()) {
+			switch (instruction.opcode) {
+			case MILITANCY:
+				return state->get_average_militancy() >= value;
+			case CONSCIOUSNESS:
+				return state->get_average_consciousness() >= value;
+			case LITERACY:
+				return state->get_average_literacy() >= value;
+			default:
+				return false;
+			}
+		} else if (CountryInstance const* country = scope.get_country()) {
+			switch (instruction.opcode) {
+			case MILITANCY:
+				return country->get_national_militancy() >= value;
+			case CONSCIOUSNESS:
+				return country->get_national_consciousness() >= value;
+			case LITERACY:
+				return country->get_national_literacy() >= value;
+			default:
+				return false;
+			}
+		}
+		return false;
+	}
+
+	if (instruction.opcode < POP_TYPE) {
+		/* State and province conditions */
+		State const* state = scope.get_state();
+
+		switch (instruction.opcode) {
+		case OWNED_BY: {
+			CountryInstance const* owner = state != nullptr ? state->get_owner() : get_scope_country(scope);
+			return owner != nullptr && owner == argument_country();
+		}
+		case CONTROLLED_BY: {
+			CountryInstance const* controller = argument_country();
+			if (controller == nullptr) {
+				return false;
+			}
+			if (state != nullptr) {
+				return std::all_of(
+					state->get_provinces().begin(), state->get_provinces().end(),
+					[controller](ProvinceInstance const* province) -> bool {
+						return province->get_controller() == controller;
+					}
+				);
+			}
+			ProvinceInstance const* province = get_scope_province(scope);
+			return province != nullptr && province->get_controller() == controller;
+		}
+		case IS_COLONIAL:
+			if (state != nullptr) {
+				return (state->get_colony_status() != ProvinceInstance::colony_status_t::STATE) == instruction.flag;
+			}
+			break;
+		case IS_SLAVE:
+			if (state != nullptr) {
+				return std::any_of(
+					state->get_provinces().begin(), state->get_provinces().end(),
+					[](ProvinceInstance const* province) -> bool {
+						return province->get_slave();
+					}
+				) == instruction.flag;
+			}
+			break;
+		default:
+			break;
+		}
+
+		ProvinceInstance const* province = get_scope_province(scope);
+		if (province == nullptr) {
+			/* A country's continent is that of its capital. */
+			if (instruction.opcode == CONTINENT) {
+				CountryInstance const* country = scope.get_country();
+				return country != nullptr && country->get_capital() != nullptr
+					&& country->get_capital()->get_province_definition().get_continent() == item;
+			}
+			return false;
+		}
+
+		ProvinceDefinition const& province_definition = province->get_province_definition();
+
+		switch (instruction.opcode) {
+		case IS_CORE_OF: {
+			CountryInstance const* country = argument_country();
+			return country != nullptr && contains_pointer(province->get_cores(), country);
+		}
+		case IS_CAPITAL:
+			return (province->get_owner() != nullptr && province->get_owner()->get_capital() == province)
+				== instruction.flag;
+		case IS_COASTAL:
+			return province_definition.is_coastal() == instruction.flag;
+		case PORT:
+			return province_definition.has_port() == instruction.flag;
+		case LIFE_RATING:
+			return fixed_point_t::parse(province->get_life_rating()) >= value;
+		case TRADE_GOODS:
+			return province->get_rgo() == item;
+		case TERRAIN:
+			return province->get_terrain_type() == item;
+		case PROVINCE_ID:
+			return &province_definition == item;
+		case CONTINENT:
+			return province_definition.get_continent() == item;
+		case IS_COLONIAL:
+			return (province->get_colony_status() != ProvinceInstance::colony_status_t::STATE) == instruction.flag;
+		case IS_SLAVE:
+			return province->get_slave() == instruction.flag;
+		default:
+			return false;
+		}
+	}
+
+	/* Pop conditions */
+	Pop const* pop = scope.get_pop();
+	if (pop == nullptr) {
+		return false;
+	}
+
+	switch (instruction.opcode) {
+	case POP_TYPE:
+		return &pop->get_type() == item;
+	case STRATA:
+		return &pop->get_type().get_strata() == item;
+	case LIFE_NEEDS:
+		return pop->get_life_needs_fulfilled() >= value;
+	case EVERYDAY_NEEDS:
+		return pop->get_everyday_needs_fulfilled() >= value;
+	case LUXURY_NEEDS:
+		return pop->get_luxury_needs_fulfilled() >= value;
+	default:
+		return false;
+	}
+}
+
+result_t ConditionBytecode::evaluate(
+	ConditionScope scope, ConditionScope this_scope, ConditionScope from_scope, InstanceManager const& instance_manager
+) const {
+	if (instructions.empty()) {
+		return result_t::YES;
+	}
+
+	const context_t context { this_scope, from_scope, instance_manager };
+	return _evaluate(0, scope, context);
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "openvic-simulation/scripts/Condition.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
+
+namespace OpenVic {
+	struct CountryInstance;
+	struct InstanceManager;
+	struct Pop;
+	struct ProvinceInstance;
+	struct State;
+
+	/* The pop, province, state or country a condition is evaluated against. Scopes holding a null pointer are valid to pass
+	 * around, but no condition is true in them. */
+	struct ConditionScope {
+	private:
+		scope_t PROPERTY(type);
+		void const* entity;
+
+		constexpr ConditionScope(scope_t new_type, void const* new_entity) : type { new_type }, entity { new_entity } {}
+
+	public:
+		constexpr ConditionScope() : ConditionScope { scope_t::NO_SCOPE, nullptr } {}
+		constexpr ConditionScope(Pop const* pop) : ConditionScope { scope_t::POP, pop } {}
+		constexpr ConditionScope(ProvinceInstance const* province) : ConditionScope { scope_t::PROVINCE, province } {}
+		constexpr ConditionScope(State const* state) : ConditionScope { scope_t::STATE, state } {}
+		constexpr ConditionScope(CountryInstance const* country) : ConditionScope { scope_t::COUNTRY, country } {}
+
+		constexpr bool is_valid() const {
+			return entity != nullptr;
+		}
+
+		/* Each getter returns nullptr unless the scope is of the matching type. */
+		constexpr Pop const* get_pop() const {
+			return type == scope_t::POP ? static_cast<Pop const*>(entity) : nullptr;
+		}
+		constexpr ProvinceInstance const* get_province() const {
+			return type == scope_t::PROVINCE ? static_cast<ProvinceInstance const*>(entity) : nullptr;
+		}
+		constexpr State const* get_state() const {
+			return type == scope_t::STATE ? static_cast<State const*>(entity) : nullptr;
+		}
+		constexpr CountryInstance const* get_country() const {
+			return type == scope_t::COUNTRY ? static_cast<CountryInstance const*>(entity) : nullptr;
+		}
+	};
+
+	/* A ConditionNode tree flattened into an array in pre-order, where each instruction records the index just past its
+	 * subtree. Groups evaluate their children by jumping from one child's end to the next, which lets AND, OR and NOT stop
+	 * at the first child that decides their result and skip the rest of it without walking it. Evaluation only needs the
+	 * current scope, so there are no registers or value stack, and the array is the whole program.
+	 * Conditions whose game state isn't simulated yet compile to an unsupported instruction, whose result is indeterminate.
+	 * Groups combine results with three-valued logic, so they're only indeterminate when an unsupported condition could
+	 * change their result, and NOT of an unsupported condition stays indeterminate rather than becoming true. */
+	struct ConditionBytecode {
+		enum struct result_t : uint8_t { NO, YES, INDETERMINATE };
+
+		enum struct opcode_t : uint8_t {
+			UNSUPPORTED,
+
+			/* Groups */
+			AND, OR, NOT,
+
+			/* Scope changes, evaluating their children as an AND group in the new scope(s) */
+			SCOPE_THIS, SCOPE_FROM, SCOPE_COUNTRY, SCOPE_PROVINCE, SCOPE_OWNER, SCOPE_CONTROLLER, SCOPE_CAPITAL,
+			SCOPE_LOCATION, SCOPE_STATE, ANY_OWNED_PROVINCE, ANY_CORE, ALL_CORE, ANY_STATE, ANY_POP, ANY_GREATER_POWER,
+
+			/* Global conditions */
+			ALWAYS, YEAR, MONTH,
+
+			/* Country conditions, which fall back to the owner of a province, state or pop's location */
+			TAG, EXISTS, CIVILISED, GREAT_POWER, SECONDARY_POWER, MOBILISED, DISARMED, PRESTIGE, BADBOY, MONEY, PLURALITY,
+			REVANCHISM, WAR_EXHAUSTION, INDUSTRIAL_SCORE, MILITARY_SCORE, RANK, TOTAL_POPS, NUMBER_OF_STATES, PRIMARY_CULTURE,
+			ACCEPTED_CULTURE, GOVERNMENT, RULING_PARTY_IDEOLOGY, TECH_SCHOOL, NATIONAL_VALUE, HAS_COUNTRY_FLAG, TECHNOLOGY,
+			INVENTION, REFORM, OWNS, CONTROLS, CAPITAL, HAS_CORE_IN_PROVINCE,
+
+			/* Conditions whose meaning depends on the scope they're evaluated in */
+			CULTURE, RELIGION, MILITANCY, CONSCIOUSNESS, LITERACY,
+
+			/* State and province conditions, which fall back to a pop's location */
+			OWNED_BY, CONTROLLED_BY, IS_CORE_OF, IS_CAPITAL, IS_COASTAL, PORT, LIFE_RATING, TRADE_GOODS, TERRAIN, PROVINCE_ID,
+			CONTINENT, IS_COLONIAL, IS_SLAVE,
+
+			/* Pop conditions */
+			POP_TYPE, STRATA, LIFE_NEEDS, EVERYDAY_NEEDS, LUXURY_NEEDS
+		};
+
+		/* Where a country argument comes from: none for the boolean form of conditions like exists, the instruction's item,
+		 * or the THIS or FROM scope. */
+		enum struct argument_t : uint8_t { NONE, ITEM, THIS, FROM };
+
+		struct instruction_t {
+			opcode_t opcode;
+			argument_t argument;
+			/* Boolean argument, e.g. civilized = no compares against false. */
+			bool flag;
+			/* Index just past this instruction's subtree, which is the next instruction for leaves. */
+			uint32_t end;
+			/* Index into strings for flag conditions. */
+			uint32_t string_index;
+			/* Numeric argument, integers included, compared with >= (or <= for rank). */
+			fixed_point_t value;
+			/* Identifier argument, or the key's item for conditions named after one, e.g. a technology or reform group. */
+			HasIdentifier const* item;
+		};
+
+	private:
+		struct context_t;
+
+		std::vector<instruction_t> PROPERTY(instructions);
+		std::vector<std::string> strings;
+		size_t PROPERTY(unsupported_count);
+
+		void _compile_node(ConditionNode const& node);
+
+		result_t _evaluate(size_t index, ConditionScope scope, context_t const& context) const;
+		/* Evaluate the children of the group or scope change at index. */
+		result_t _evaluate_all(size_t index, ConditionScope scope, context_t const& context) const;
+		result_t _evaluate_any(size_t index, ConditionScope scope, context_t const& context) const;
+		bool _evaluate_leaf(instruction_t const& instruction, ConditionScope scope, context_t const& context) const;
+
+	public:
+		ConditionBytecode();
+		ConditionBytecode(ConditionBytecode&&) = default;
+		ConditionBytecode& operator=(ConditionBytecode&&) = default;
+
+		/* Replaces any existing program. A root without a condition, as left by a script with no defines node, compiles to
+		 * an empty program which is always true. */
+		bool compile(ConditionNode const& root);
+
+		constexpr bool empty() const {
+			return instructions.empty();
+		}
+
+		result_t evaluate(
+			ConditionScope scope, ConditionScope this_scope, ConditionScope from_scope, InstanceManager const& instance_manager
+		) const;
+	};
+}
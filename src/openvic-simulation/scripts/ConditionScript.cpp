@@ -10,11 +10,19 @@ ConditionScript::ConditionScript(
 ) : initial_scope { new_initial_scope }, this_scope { new_this_scope }, from_scope { new_from_scope } {}
 
 bool ConditionScript::_parse_script(ast::NodeCPtr root, DefinitionManager const& definition_manager) {
-	return definition_manager.get_script_manager().get_condition_manager().expect_condition_script(
+	bool ret = definition_manager.get_script_manager().get_condition_manager().expect_condition_script(
 		definition_manager,
 		initial_scope,
 		this_scope,
 		from_scope,
 		move_variable_callback(condition_root)
 	)(root);
+	ret &= bytecode.compile(condition_root);
+	return ret;
+}
+
+bool ConditionScript::evaluate(
+	ConditionScope scope, ConditionScope this_entity, ConditionScope from_entity, InstanceManager const& instance_manager
+) const {
+	return bytecode.evaluate(scope, this_entity, from_entity, instance_manager) == ConditionBytecode::result_t::YES;
 }
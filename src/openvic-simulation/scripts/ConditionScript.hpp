@@ -1,10 +1,12 @@
 #pragma once
 
 #include "openvic-simulation/scripts/Condition.hpp"
+#include "openvic-simulation/scripts/ConditionBytecode.hpp"
 #include "openvic-simulation/scripts/Script.hpp"
 
 namespace OpenVic {
 	struct DefinitionManager;
+	struct InstanceManager;
 
 	struct ConditionScript final : Script<DefinitionManager const&> {
 
@@ -13,11 +15,20 @@ namespace OpenVic {
 		scope_t PROPERTY(initial_scope);
 		scope_t PROPERTY(this_scope);
 		scope_t PROPERTY(from_scope);
+		/* Compiled from condition_root once it has been parsed. */
+		ConditionBytecode PROPERTY(bytecode);
 
 	protected:
 		bool _parse_script(ast::NodeCPtr root, DefinitionManager const& definition_manager) override;
 
 	public:
 		ConditionScript(scope_t new_initial_scope, scope_t new_this_scope, scope_t new_from_scope);
+
+		/* Scripts without conditions are always true, and scripts whose result depends on conditions which aren't
+		 * simulated yet are false. */
+		bool evaluate(
+			ConditionScope scope, ConditionScope this_entity, ConditionScope from_entity,
+			InstanceManager const& instance_manager
+		) const;
 	};
 }
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <concepts>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 #include "openvic-simulation/types/fixed_point/FixedPointMap.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPointSIMD.hpp"
 #include "openvic-simulation/utility/Getters.hpp"
 #include "openvic-simulation/utility/Logger.hpp"
 
@@ -103,7 +106,18 @@ namespace OpenVic {
 			return container_t::operator[](get_index_from_item(key));
 		}
 
-		constexpr IndexedMap& operator+=(IndexedMap const& other) {
+		/* fixed_point_t maps use the vectorised FixedPointSIMD kernels for +=, *= and get_total, except during constant
+		 * evaluation. Division stays scalar as there are no SIMD integer division instructions. */
+
+		/* Adds values index by index, e.g. from a row of a PopStore weight table. */
+		constexpr IndexedMap& operator+=(std::span<value_t const> other) {
+			if constexpr (std::same_as<value_t, fixed_point_t>) {
+				if (!std::is_constant_evaluated()) {
+					FixedPointSIMD::add({ container_t::data(), container_t::size() }, other);
+					return *this;
+				}
+			}
+
 			const size_t count = std::min(container_t::size(), other.size());
 			for (size_t index = 0; index < count; ++index) {
 				container_t::operator[](index) += other[index];
@@ -111,7 +125,18 @@ namespace OpenVic {
 			return *this;
 		}
 
+		constexpr IndexedMap& operator+=(IndexedMap const& other) {
+			return *this += std::span<value_t const> { other.data(), other.size() };
+		}
+
 		constexpr IndexedMap& operator*=(value_t factor) {
+			if constexpr (std::same_as<value_t, fixed_point_t>) {
+				if (!std::is_constant_evaluated()) {
+					FixedPointSIMD::multiply({ container_t::data(), container_t::size() }, factor);
+					return *this;
+				}
+			}
+
 			for (value_t& value : *this) {
 				value *= factor;
 			}
@@ -144,6 +169,12 @@ namespace OpenVic {
 		}
 
 		constexpr value_t get_total() const {
+			if constexpr (std::same_as<value_t, fixed_point_t>) {
+				if (!std::is_constant_evaluated()) {
+					return FixedPointSIMD::sum({ container_t::data(), container_t::size() });
+				}
+			}
+
 			value_t total {};
 			for (value_t const& value : *this) {
 				total += value;
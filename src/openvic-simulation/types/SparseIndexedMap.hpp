@@ -0,0 +1,179 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "openvic-simulation/types/fixed_point/FixedPointMap.hpp"
+#include "openvic-simulation/utility/Getters.hpp"
+#include "openvic-simulation/utility/Logger.hpp"
+
+namespace OpenVic {
+
+	/* An IndexedMap for large key sets of which only a few are used at once, e.g. the cultures present in a province.
+	 * Values are stored densely by key index, so increments are O(1) with no hashing, while the indices of entries that
+	 * have been accessed are also listed in insertion order, so iterating, totalling and clearing only touch those entries.
+	 * As with fixed_point_map_t, accessing a key index through the non-const operator[] creates an entry for it. */
+	template<typename Key, typename Value>
+	struct SparseIndexedMap {
+		using key_t = Key;
+		using value_t = Value;
+		using keys_t = std::vector<key_t>;
+
+		using key_type = key_t; // To match tsl::ordered_map's key_type
+
+		static constexpr size_t NO_INDEX = static_cast<size_t>(-1);
+
+	private:
+		keys_t const* PROPERTY(keys);
+		std::vector<value_t> values;
+		std::vector<uint8_t> present;
+		/* Indices of the map's entries, in the order they were added. */
+		std::vector<size_t> PROPERTY(indices);
+
+	public:
+		constexpr SparseIndexedMap(keys_t const* new_keys) : keys { nullptr } {
+			set_keys(new_keys);
+		}
+
+		SparseIndexedMap(SparseIndexedMap const&) = default;
+		SparseIndexedMap(SparseIndexedMap&&) = default;
+		SparseIndexedMap& operator=(SparseIndexedMap const&) = default;
+		SparseIndexedMap& operator=(SparseIndexedMap&&) = default;
+
+		constexpr bool has_keys() const {
+			return keys != nullptr;
+		}
+
+		constexpr void set_keys(keys_t const* new_keys) {
+			if (keys != new_keys) {
+				keys = new_keys;
+
+				const size_t key_count = keys != nullptr ? keys->size() : 0;
+				values.assign(key_count, {});
+				present.assign(key_count, false);
+				indices.clear();
+			}
+		}
+
+		/* Number of entries, not number of keys. */
+		constexpr size_t size() const {
+			return indices.size();
+		}
+
+		constexpr bool empty() const {
+			return indices.empty();
+		}
+
+		constexpr void clear() {
+			for (const size_t index : indices) {
+				values[index] = {};
+				present[index] = false;
+			}
+			indices.clear();
+		}
+
+		/* Returns NO_INDEX if the key isn't one of the map's keys. */
+		constexpr size_t get_index_from_item(key_t const& key) const {
+			if (has_keys() && !keys->empty() && keys->data() <= &key && &key <= &keys->back()) {
+				return std::distance(keys->data(), &key);
+			} else {
+				Logger::error(
+					"Trying to get index of key not in SparseIndexedMap's ", keys != nullptr ? keys->size() : 0, " keys!"
+				);
+				return NO_INDEX;
+			}
+		}
+
+		constexpr key_t const& operator()(size_t index) const {
+			return (*keys)[index];
+		}
+
+		constexpr bool contains_index(size_t index) const {
+			return index < present.size() && present[index];
+		}
+
+		constexpr bool contains(key_t const& key) const {
+			return contains_index(get_index_from_item(key));
+		}
+
+		/* Returns the value for the key index, creating an entry for it if there isn't one already. */
+		constexpr value_t& operator[](size_t index) {
+			if (!present[index]) {
+				present[index] = true;
+				indices.push_back(index);
+			}
+			return values[index];
+		}
+
+		/* Returns the value for the key, creating an entry for it if there isn't one already, or nullptr if the key isn't
+		 * one of the map's keys. */
+		constexpr value_t* get_item_by_key(key_t const& key) {
+			const size_t index = get_index_from_item(key);
+			if (index != NO_INDEX) {
+				return &(*this)[index];
+			}
+			return nullptr;
+		}
+
+		/* Returns the value for the key index, or a default value if the map has no entry for it. */
+		constexpr value_t const& get_value(size_t index) const {
+			return values[index];
+		}
+
+		/* Returns a default value if the key isn't one of the map's keys. */
+		constexpr value_t get_value(key_t const& key) const {
+			const size_t index = get_index_from_item(key);
+			if (index != NO_INDEX) {
+				return get_value(index);
+			}
+			return {};
+		}
+
+		constexpr SparseIndexedMap& operator+=(SparseIndexedMap const& other) {
+			for (const size_t index : other.indices) {
+				(*this)[index] += other.values[index];
+			}
+			return *this;
+		}
+
+		constexpr value_t get_total() const {
+			value_t total {};
+			for (const size_t index : indices) {
+				total += values[index];
+			}
+			return total;
+		}
+
+		/* The key indices of the two largest values, or NO_INDEX if there are fewer entries. As with get_largest_two_items
+		 * for fixed_point_map_t, ties are won by the earliest added entry. */
+		constexpr std::pair<size_t, size_t> get_largest_two_indices() const {
+			size_t largest = NO_INDEX, second_largest = NO_INDEX;
+
+			for (const size_t index : indices) {
+				if (largest == NO_INDEX || values[index] > values[largest]) {
+					second_largest = largest;
+					largest = index;
+				} else if (second_largest == NO_INDEX || values[index] > values[second_largest]) {
+					second_largest = index;
+				}
+			}
+
+			return { largest, second_largest };
+		}
+
+		fixed_point_map_t<key_t const*> to_fixed_point_map() const
+		requires(std::same_as<value_t, fixed_point_t>)
+		{
+			fixed_point_map_t<key_t const*> result;
+
+			for (const size_t index : indices) {
+				result[&(*this)(index)] = values[index];
+			}
+
+			return result;
+		}
+	};
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+#if defined(__AVX2__)
+	#include <immintrin.h>
+	#define OV_FIXED_POINT_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define OV_FIXED_POINT_SIMD_SSE2
+#endif
+
+/* Vectorised arithmetic over contiguous runs of fixed_point_t, used by IndexedMap<_, fixed_point_t>. The instruction set
+ * is chosen at compile time: AVX2 if the compiler targets it (e.g. with -mavx2 or /arch:AVX2), otherwise SSE2, which every
+ * x86-64 CPU has, otherwise plain scalar loops. Every path gives bit-identical results to fixed_point_t's own operators,
+ * including the wrapping 64-bit intermediate product used by fixed_point_t multiplication. There is no SIMD integer
+ * division, so division is left to fixed_point_t. */
+namespace OpenVic::FixedPointSIMD {
+	namespace _detail {
+#if defined(OV_FIXED_POINT_SIMD_AVX2)
+		struct simd_ops_t {
+			using reg_t = __m256i;
+			static constexpr size_t WIDTH = 4;
+
+			static reg_t load(fixed_point_t const* src) {
+				return _mm256_loadu_si256(reinterpret_cast<reg_t const*>(src));
+			}
+			static void store(fixed_point_t* dst, reg_t value) {
+				_mm256_storeu_si256(reinterpret_cast<reg_t*>(dst), value);
+			}
+			static reg_t zero() {
+				return _mm256_setzero_si256();
+			}
+			static reg_t set1(int64_t value) {
+				return _mm256_set1_epi64x(value);
+			}
+			static reg_t add(reg_t lhs, reg_t rhs) {
+				return _mm256_add_epi64(lhs, rhs);
+			}
+			static reg_t bitwise_or(reg_t lhs, reg_t rhs) {
+				return _mm256_or_si256(lhs, rhs);
+			}
+			static reg_t mul_u32(reg_t lhs, reg_t rhs) {
+				return _mm256_mul_epu32(lhs, rhs);
+			}
+			template<int Shift>
+			static reg_t shift_left(reg_t value) {
+				return _mm256_slli_epi64(value, Shift);
+			}
+			template<int Shift>
+			static reg_t shift_right_logical(reg_t value) {
+				return _mm256_srli_epi64(value, Shift);
+			}
+			/* All bits set in lanes holding negative values. */
+			static reg_t sign_mask(reg_t value) {
+				return _mm256_shuffle_epi32(_mm256_srai_epi32(value, 31), 0xF5);
+			}
+			static int64_t horizontal_sum(reg_t value) {
+				const __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+				return _mm_cvtsi128_si64(sum) + _mm_cvtsi128_si64(_mm_unpackhi_epi64(sum, sum));
+			}
+		};
+#elif defined(OV_FIXED_POINT_SIMD_SSE2)
+		struct simd_ops_t {
+			using reg_t = __m128i;
+			static constexpr size_t WIDTH = 2;
+
+			static reg_t load(fixed_point_t const* src) {
+				return _mm_loadu_si128(reinterpret_cast<reg_t const*>(src));
+			}
+			static void store(fixed_point_t* dst, reg_t value) {
+				_mm_storeu_si128(reinterpret_cast<reg_t*>(dst), value);
+			}
+			static reg_t zero() {
+				return _mm_setzero_si128();
+			}
+			static reg_t set1(int64_t value) {
+				return _mm_set1_epi64x(value);
+			}
+			static reg_t add(reg_t lhs, reg_t rhs) {
+				return _mm_add_epi64(lhs, rhs);
+			}
+			static reg_t bitwise_or(reg_t lhs, reg_t rhs) {
+				return _mm_or_si128(lhs, rhs);
+			}
+			static reg_t mul_u32(reg_t lhs, reg_t rhs) {
+				return _mm_mul_epu32(lhs, rhs);
+			}
+			template<int Shift>
+			static reg_t shift_left(reg_t value) {
+				return _mm_slli_epi64(value, Shift);
+			}
+			template<int Shift>
+			static reg_t shift_right_logical(reg_t value) {
+				return _mm_srli_epi64(value, Shift);
+			}
+			/* All bits set in lanes holding negative values. */
+			static reg_t sign_mask(reg_t value) {
+				return _mm_shuffle_epi32(_mm_srai_epi32(value, 31), 0xF5);
+			}
+			static int64_t horizontal_sum(reg_t value) {
+				int64_t lanes[WIDTH];
+				_mm_storeu_si128(reinterpret_cast<reg_t*>(lanes), value);
+				return lanes[0] + lanes[1];
+			}
+		};
+#endif
+
+#if defined(OV_FIXED_POINT_SIMD_AVX2) || defined(OV_FIXED_POINT_SIMD_SSE2)
+		/* Low 64 bits of the signed 64-bit product, built from 32-bit multiplies as neither SSE2 nor AVX2 has a 64-bit
+		 * multiply. Cross terms only affect the upper half, so their own upper halves can be discarded. */
+		inline simd_ops_t::reg_t multiply_low(
+			simd_ops_t::reg_t lhs, simd_ops_t::reg_t rhs_low, simd_ops_t::reg_t rhs_high
+		) {
+			using ops = simd_ops_t;
+			const ops::reg_t cross = ops::add(
+				ops::mul_u32(lhs, rhs_high), ops::mul_u32(ops::shift_right_logical<32>(lhs), rhs_low)
+			);
+			return ops::add(ops::mul_u32(lhs, rhs_low), ops::shift_left<32>(cross));
+		}
+
+		/* Arithmetic right shift, emulated as neither SSE2 nor AVX2 has a 64-bit one. */
+		inline simd_ops_t::reg_t shift_right_fixed_point(simd_ops_t::reg_t value) {
+			using ops = simd_ops_t;
+			return ops::bitwise_or(
+				ops::shift_right_logical<fixed_point_t::PRECISION>(value),
+				ops::shift_left<64 - fixed_point_t::PRECISION>(ops::sign_mask(value))
+			);
+		}
+#endif
+	}
+
+	constexpr bool is_vectorised() {
+#if defined(OV_FIXED_POINT_SIMD_AVX2) || defined(OV_FIXED_POINT_SIMD_SSE2)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	constexpr char const* get_instruction_set_name() {
+#if defined(OV_FIXED_POINT_SIMD_AVX2)
+		return "AVX2";
+#elif defined(OV_FIXED_POINT_SIMD_SSE2)
+		return "SSE2";
+#else
+		return "scalar";
+#endif
+	}
+
+	/* dst[i] += src[i] for i < min(dst.size(), src.size()) */
+	inline void add(std::span<fixed_point_t> dst, std::span<fixed_point_t const> src) {
+		const size_t count = std::min(dst.size(), src.size());
+		size_t index = 0;
+
+#if defined(OV_FIXED_POINT_SIMD_AVX2) || defined(OV_FIXED_POINT_SIMD_SSE2)
+		using ops = _detail::simd_ops_t;
+		for (; index + ops::WIDTH <= count; index += ops::WIDTH) {
+			ops::store(&dst[index], ops::add(ops::load(&dst[index]), ops::load(&src[index])));
+		}
+#endif
+
+		for (; index < count; ++index) {
+			dst[index] += src[index];
+		}
+	}
+
+	/* values[i] *= factor */
+	inline void multiply(std::span<fixed_point_t> values, fixed_point_t factor) {
+		size_t index = 0;
+
+#if defined(OV_FIXED_POINT_SIMD_AVX2) || defined(OV_FIXED_POINT_SIMD_SSE2)
+		using ops = _detail::simd_ops_t;
+		const ops::reg_t factor_low = ops::set1(factor.get_raw_value());
+		const ops::reg_t factor_high = ops::shift_right_logical<32>(factor_low);
+		for (; index + ops::WIDTH <= values.size(); index += ops::WIDTH) {
+			ops::store(
+				&values[index],
+				_detail::shift_right_fixed_point(_detail::multiply_low(ops::load(&values[index]), factor_low, factor_high))
+			);
+		}
+#endif
+
+		for (; index < values.size(); ++index) {
+			values[index] *= factor;
+		}
+	}
+
+	inline fixed_point_t sum(std::span<fixed_point_t const> values) {
+		size_t index = 0;
+		int64_t total = 0;
+
+#if defined(OV_FIXED_POINT_SIMD_AVX2) || defined(OV_FIXED_POINT_SIMD_SSE2)
+		using ops = _detail::simd_ops_t;
+		if (values.size() >= ops::WIDTH) {
+			ops::reg_t accumulator = ops::zero();
+			for (; index + ops::WIDTH <= values.size(); index += ops::WIDTH) {
+				accumulator = ops::add(accumulator, ops::load(&values[index]));
+			}
+			total = ops::horizontal_sum(accumulator);
+		}
+#endif
+
+		for (; index < values.size(); ++index) {
+			total += values[index].get_raw_value();
+		}
+		return fixed_point_t::parse_raw(total);
+	}
+}
@@ -1,10 +1,11 @@
 #pragma once
 
 #include <filesystem>
-#include <fstream>
+#include <span>
 #include <vector>
 
 #include "openvic-simulation/types/Colour.hpp"
+#include "openvic-simulation/utility/MemoryMappedFile.hpp"
 
 namespace OpenVic {
 	namespace fs = std::filesystem;
@@ -36,11 +37,12 @@ namespace OpenVic {
 		using palette_colour_t = uint32_t;
 
 	private:
-		std::ifstream file;
+		MemoryMappedFile file;
 		bool header_validated = false, palette_read = false, pixel_data_read = false;
 		uint32_t palette_size = 0;
 		std::vector<palette_colour_t> palette;
-		std::vector<uint8_t> pixel_data;
+		/* Points straight into the mapped file rather than being copied out of it. */
+		std::span<const uint8_t> pixel_data;
 
 	public:
 		static constexpr uint32_t PALETTE_COLOUR_SIZE = sizeof(palette_colour_t);
@@ -59,6 +61,7 @@ namespace OpenVic {
 		int32_t get_height() const;
 		uint16_t get_bits_per_pixel() const;
 		std::vector<palette_colour_t> const& get_palette() const;
-		std::vector<uint8_t> const& get_pixel_data() const;
+		/* Only valid until the BMP is closed or reset. */
+		std::span<const uint8_t> get_pixel_data() const;
 	};
 }
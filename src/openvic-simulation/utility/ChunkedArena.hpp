@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace OpenVic {
+	/* Append-only storage for elements of a single type, allocating space for several elements at a time with each chunk
+	 * twice the size of the one before it. Elements are never moved once constructed, so references to them stay valid
+	 * until the arena is cleared or destroyed, and all of them are destroyed together. */
+	template<typename T, size_t FirstChunkCapacity = 4>
+	struct ChunkedArena {
+	private:
+		struct chunk_t {
+			T* data;
+			size_t size;
+			size_t capacity;
+		};
+
+		std::vector<chunk_t> chunks;
+		size_t element_count;
+
+		static T* _allocate(size_t capacity) {
+			return static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t { alignof(T) }));
+		}
+
+		static void _deallocate(T* data) {
+			::operator delete(data, std::align_val_t { alignof(T) });
+		}
+
+	public:
+		ChunkedArena() : element_count { 0 } {}
+
+		ChunkedArena(ChunkedArena&& other) noexcept
+		  : chunks { std::move(other.chunks) }, element_count { std::exchange(other.element_count, 0) } {
+			other.chunks.clear();
+		}
+
+		ChunkedArena& operator=(ChunkedArena&& other) noexcept {
+			if (this != &other) {
+				clear();
+				chunks = std::move(other.chunks);
+				other.chunks.clear();
+				element_count = std::exchange(other.element_count, 0);
+			}
+			return *this;
+		}
+
+		ChunkedArena(ChunkedArena const&) = delete;
+		ChunkedArena& operator=(ChunkedArena const&) = delete;
+
+		~ChunkedArena() {
+			clear();
+		}
+
+		constexpr size_t size() const {
+			return element_count;
+		}
+
+		constexpr bool empty() const {
+			return element_count == 0;
+		}
+
+		template<typename... Args>
+		T& emplace_back(Args&&... args) {
+			if (chunks.empty() || chunks.back().size == chunks.back().capacity) {
+				const size_t capacity = chunks.empty() ? FirstChunkCapacity : chunks.back().capacity * 2;
+				chunks.push_back({ _allocate(capacity), 0, capacity });
+			}
+
+			chunk_t& chunk = chunks.back();
+			T* element = new (chunk.data + chunk.size) T(std::forward<Args>(args)...);
+			chunk.size++;
+			element_count++;
+			return *element;
+		}
+
+		/* Calls func on every element, in the order they were added. */
+		template<typename Func>
+		void for_each(Func&& func) {
+			for (chunk_t const& chunk : chunks) {
+				for (size_t index = 0; index < chunk.size; ++index) {
+					func(chunk.data[index]);
+				}
+			}
+		}
+
+		/* Destroys every element and frees all memory. */
+		void clear() {
+			for (chunk_t const& chunk : chunks) {
+				std::destroy_n(chunk.data, chunk.size);
+				_deallocate(chunk.data);
+			}
+			chunks.clear();
+			chunks.shrink_to_fit();
+			element_count = 0;
+		}
+	};
+}
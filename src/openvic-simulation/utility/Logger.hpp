@@ -1,16 +1,28 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <sstream>
+#include <thread>
 
 #ifdef __cpp_lib_source_location
 #include <source_location>
 #endif
 
+#include "openvic-simulation/utility/MPSCRingBuffer.hpp"
 #include "openvic-simulation/utility/StringUtils.hpp"
 
+/* Messages below this level are compiled out: 0 = info, 1 = warning, 2 = error, 3 = none.
+ * Set with the log_level SCons option. */
+#ifndef OPENVIC_LOG_MIN_LEVEL
+#define OPENVIC_LOG_MIN_LEVEL 0
+#endif
+
 namespace OpenVic {
 
 #ifndef __cpp_lib_source_location
@@ -56,6 +68,18 @@ namespace OpenVic {
 #endif
 
 	public:
+		enum struct level_t : uint8_t { LEVEL_INFO, LEVEL_WARNING, LEVEL_ERROR, LEVEL_NONE };
+
+		static constexpr level_t MIN_LEVEL = static_cast<level_t>(OPENVIC_LOG_MIN_LEVEL);
+
+		static constexpr bool is_level_enabled(level_t level) {
+			return level >= MIN_LEVEL;
+		}
+
+		/* Maximum number of messages waiting to be flushed in asynchronous mode. Logging threads wait for space once
+		 * this is reached rather than dropping messages. */
+		static constexpr size_t ASYNC_BUFFER_CAPACITY = 1 << 13;
+
 		static void set_logger_funcs() {
 			set_info_func([](std::string&& str) {
 				std::cout << "[INFO] " << str;
@@ -72,9 +96,29 @@ namespace OpenVic {
 		struct log_channel_t {
 			log_func_t func;
 			log_queue_t queue;
-			size_t message_count;
+			std::mutex queue_mutex;
+			/* Only counts messages which have been or are guaranteed to be printed, so that message_count matches what
+			 * is seen in the console once all asynchronous messages have been flushed. */
+			std::atomic<size_t> message_count;
 		};
 
+		static inline void _push_message(log_channel_t& log_channel, std::string&& message) {
+			if (log_channel.func && _get_async_state().enabled.load(std::memory_order_acquire)) {
+				log_channel.message_count.fetch_add(1, std::memory_order_relaxed);
+				_push_async_message(log_channel, std::move(message));
+			} else {
+				const std::lock_guard<std::mutex> lock { log_channel.queue_mutex };
+				log_channel.queue.push(std::move(message));
+				if (log_channel.func) {
+					do {
+						log_channel.func(std::move(log_channel.queue.front()));
+						log_channel.queue.pop();
+						log_channel.message_count.fetch_add(1, std::memory_order_relaxed);
+					} while (!log_channel.queue.empty());
+				}
+			}
+		}
+
 		template<typename... Args>
 		struct log {
 			log(log_channel_t& log_channel, Args&&... args, source_location const& location) {
@@ -86,19 +130,12 @@ namespace OpenVic {
 					<< location.line() << "): ";
 				((stream << std::forward<Args>(args)), ...);
 				stream << std::endl;
-				log_channel.queue.push(stream.str());
-				if (log_channel.func) {
-					do {
-						log_channel.func(std::move(log_channel.queue.front()));
-						log_channel.queue.pop();
-						/* Only count printed messages, so that message_count matches what is seen in the console. */
-						log_channel.message_count++;
-					} while (!log_channel.queue.empty());
-				}
+				_push_message(log_channel, stream.str());
 			}
 		};
 
-#define LOG_FUNC(name) \
+/* Calls to a level below MIN_LEVEL compile to nothing, skipping all formatting of their arguments. */
+#define LOG_FUNC(name, level) \
 private: \
 	static inline log_channel_t name##_channel {}; \
 \
@@ -107,23 +144,141 @@ public: \
 		name##_channel.func = log_func; \
 	} \
 	static inline size_t get_##name##_count() { \
-		return name##_channel.message_count; \
+		return name##_channel.message_count.load(std::memory_order_relaxed); \
 	} \
 	template<typename... Args> \
 	struct name { \
-		name(Args&&... args, source_location const& location = source_location::current()) { \
-			log<Args...> { name##_channel, std::forward<Args>(args)..., location }; \
+		name( \
+			[[maybe_unused]] Args&&... args, \
+			[[maybe_unused]] source_location const& location = source_location::current() \
+		) { \
+			if constexpr (is_level_enabled(level_t::level)) { \
+				log<Args...> { name##_channel, std::forward<Args>(args)..., location }; \
+			} \
 		} \
 	}; \
 	template<typename... Args> \
 	name(Args&&...) -> name<Args...>;
 
-		LOG_FUNC(info)
-		LOG_FUNC(warning)
-		LOG_FUNC(error)
+		LOG_FUNC(info, LEVEL_INFO)
+		LOG_FUNC(warning, LEVEL_WARNING)
+		LOG_FUNC(error, LEVEL_ERROR)
 
 #undef LOG_FUNC
 
+	private:
+		struct async_message_t {
+			log_channel_t* channel;
+			std::string message;
+		};
+
+		struct async_state_t {
+			std::unique_ptr<MPSCRingBuffer<async_message_t>> buffer;
+			std::thread flush_thread;
+			std::mutex thread_mutex;
+			std::atomic<bool> enabled;
+			std::atomic<bool> stopping;
+			/* Bumped after every push so the flush thread can sleep on it while the buffer is empty. */
+			std::atomic<uint32_t> wake_counter;
+			/* Messages passed to their log funcs, which is also the buffer's pop position. */
+			std::atomic<uint64_t> flush_count;
+
+			~async_state_t() {
+				set_async(false);
+			}
+		};
+
+		/* A function-local static rather than a static member, as the order static members are destroyed in isn't
+		 * guaranteed. It is first used after the channels have been constructed, so it is destroyed, and its remaining
+		 * messages flushed, before them. */
+		static inline async_state_t& _get_async_state() {
+			static async_state_t async_state {};
+			return async_state;
+		}
+
+		static inline void _push_async_message(log_channel_t& log_channel, std::string&& message) {
+			async_state_t& async_state = _get_async_state();
+			async_message_t async_message { &log_channel, std::move(message) };
+			while (!async_state.buffer->try_push(async_message)) {
+				async_state.wake_counter.fetch_add(1, std::memory_order_release);
+				async_state.wake_counter.notify_one();
+				std::this_thread::yield();
+			}
+			async_state.wake_counter.fetch_add(1, std::memory_order_release);
+			async_state.wake_counter.notify_one();
+		}
+
+		static inline void _flush_thread_loop() {
+			async_state_t& async_state = _get_async_state();
+			async_message_t async_message {};
+			while (true) {
+				const uint32_t wake_value = async_state.wake_counter.load(std::memory_order_acquire);
+				bool popped_any = false;
+				while (async_state.buffer->try_pop(async_message)) {
+					async_message.channel->func(std::move(async_message.message));
+					popped_any = true;
+					async_state.flush_count.fetch_add(1, std::memory_order_release);
+					async_state.flush_count.notify_all();
+				}
+				if (!popped_any) {
+					if (async_state.stopping.load(std::memory_order_acquire)) {
+						return;
+					}
+					async_state.wake_counter.wait(wake_value, std::memory_order_acquire);
+				}
+			}
+		}
+
+	public:
+		/* In asynchronous mode, messages are formatted on the logging thread but passed to the log funcs by a background
+		 * thread, via a lock-free queue shared by all channels, so logging never waits on console or file output.
+		 * Messages logged on one thread are printed in the order they were logged. Must not be called while other
+		 * threads are logging. Disabling flushes all waiting messages, and should be done before the program exits
+		 * rather than leaving it to static destruction. */
+		static inline void set_async(bool async) {
+			async_state_t& async_state = _get_async_state();
+			const std::lock_guard<std::mutex> lock { async_state.thread_mutex };
+			if (async == async_state.flush_thread.joinable()) {
+				return;
+			}
+
+			if (async) {
+				if (async_state.buffer == nullptr) {
+					async_state.buffer = std::make_unique<MPSCRingBuffer<async_message_t>>(ASYNC_BUFFER_CAPACITY);
+				}
+				async_state.stopping.store(false, std::memory_order_release);
+				async_state.flush_thread = std::thread { _flush_thread_loop };
+				async_state.enabled.store(true, std::memory_order_release);
+			} else {
+				async_state.enabled.store(false, std::memory_order_release);
+				async_state.stopping.store(true, std::memory_order_release);
+				async_state.wake_counter.fetch_add(1, std::memory_order_release);
+				async_state.wake_counter.notify_one();
+				async_state.flush_thread.join();
+			}
+		}
+
+		static inline bool is_async() {
+			return _get_async_state().enabled.load(std::memory_order_acquire);
+		}
+
+		/* Waits until every message logged before the call has been passed to its log func. The target is the buffer's
+		 * claimed slot count rather than a count bumped after each push, as another thread could push a message but not
+		 * yet have counted it, letting the count match while a later message is still waiting. Pops are in slot order,
+		 * so once the flush thread has popped up to the target, every slot claimed before the call has been printed. */
+		static inline void flush() {
+			if (!is_async()) {
+				return;
+			}
+			async_state_t& async_state = _get_async_state();
+			const uint64_t target = async_state.buffer->get_push_count();
+			uint64_t flushed = async_state.flush_count.load(std::memory_order_acquire);
+			while (flushed < target) {
+				async_state.flush_count.wait(flushed, std::memory_order_acquire);
+				flushed = async_state.flush_count.load(std::memory_order_acquire);
+			}
+		}
+
 		template<typename... Args>
 		static inline constexpr void warn_or_error(bool warn, Args&&... args) {
 			if (warn) {
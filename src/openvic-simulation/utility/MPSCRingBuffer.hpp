@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace OpenVic {
+	/* Bounded lock-free queue for any number of producer threads and a single consumer thread. Each slot carries a
+	 * sequence number which tells producers whether it's free to write and the consumer whether it's ready to read, so
+	 * producers only contend on a single atomic increment and never block each other or the consumer. */
+	template<typename T>
+	struct MPSCRingBuffer {
+	private:
+		struct slot_t {
+			std::atomic<size_t> sequence;
+			T value;
+		};
+
+		/* Keep the producer and consumer positions on separate cache lines so they don't falsely share. */
+		static constexpr size_t CACHE_LINE_SIZE = 64;
+
+		std::unique_ptr<slot_t[]> slots;
+		size_t mask;
+
+		alignas(CACHE_LINE_SIZE) std::atomic<size_t> push_position;
+		alignas(CACHE_LINE_SIZE) size_t pop_position;
+
+	public:
+		/* capacity is rounded up to a power of 2. */
+		MPSCRingBuffer(size_t capacity)
+		  : slots { std::make_unique<slot_t[]>(std::bit_ceil(std::max<size_t>(capacity, 2))) },
+			mask { std::bit_ceil(std::max<size_t>(capacity, 2)) - 1 }, push_position { 0 }, pop_position { 0 } {
+			for (size_t index = 0; index <= mask; ++index) {
+				slots[index].sequence.store(index, std::memory_order_relaxed);
+			}
+		}
+
+		MPSCRingBuffer(MPSCRingBuffer const&) = delete;
+		MPSCRingBuffer& operator=(MPSCRingBuffer const&) = delete;
+
+		constexpr size_t get_capacity() const {
+			return mask + 1;
+		}
+
+		/* Number of slots producers have claimed, including pushes which haven't finished writing their value yet. Any push
+		 * which has returned on the calling thread, or happened before the call, is counted, so once the consumer has
+		 * popped this many values every such push has been consumed. Safe to call from any thread. */
+		size_t get_push_count() const {
+			return push_position.load(std::memory_order_acquire);
+		}
+
+		/* Safe to call from any thread. Returns false without moving from value if the buffer is full. */
+		bool try_push(T& value) {
+			size_t position = push_position.load(std::memory_order_relaxed);
+
+			while (true) {
+				slot_t& slot = slots[position & mask];
+				const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+				if (difference == 0) {
+					if (push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						slot.value = std::move(value);
+						slot.sequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				} else if (difference < 0) {
+					return false;
+				} else {
+					position = push_position.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		/* Must only be called from the consumer thread. Returns false if the buffer is empty. */
+		bool try_pop(T& value) {
+			slot_t& slot = slots[pop_position & mask];
+			const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+			if (static_cast<std::ptrdiff_t>(sequence - (pop_position + 1)) < 0) {
+				return false;
+			}
+
+			value = std::move(slot.value);
+			slot.sequence.store(pop_position + mask + 1, std::memory_order_release);
+			pop_position++;
+			return true;
+		}
+	};
+}
@@ -0,0 +1,150 @@
+#include "MemoryMappedFile.hpp"
+
+#include <utility>
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include "openvic-simulation/utility/Logger.hpp"
+
+using namespace OpenVic;
+
+MemoryMappedFile::MemoryMappedFile()
+  : data { nullptr }, size { 0 }, is_empty_file { false }
+#if defined(_WIN32)
+	, file_handle { INVALID_HANDLE_VALUE }, mapping_handle { nullptr }
+#endif
+{}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) : MemoryMappedFile {} {
+	_swap(other);
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& other) {
+	if (this != &other) {
+		close();
+		_swap(other);
+	}
+	return *this;
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+	close();
+}
+
+void MemoryMappedFile::_swap(MemoryMappedFile& other) {
+	std::swap(data, other.data);
+	std::swap(size, other.size);
+	std::swap(is_empty_file, other.is_empty_file);
+#if defined(_WIN32)
+	std::swap(file_handle, other.file_handle);
+	std::swap(mapping_handle, other.mapping_handle);
+#endif
+}
+
+bool MemoryMappedFile::open(fs::path const& path) {
+	close();
+
+#if defined(_WIN32)
+	file_handle = CreateFileW(
+		path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr
+	);
+	if (file_handle == INVALID_HANDLE_VALUE) {
+		Logger::error("Failed to open file for memory mapping: ", path);
+		return false;
+	}
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file_handle, &file_size)) {
+		Logger::error("Failed to get size of file for memory mapping: ", path);
+		close();
+		return false;
+	}
+
+	if (file_size.QuadPart == 0) {
+		is_empty_file = true;
+		return true;
+	}
+
+	mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_handle == nullptr) {
+		Logger::error("Failed to create file mapping: ", path);
+		close();
+		return false;
+	}
+
+	void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr) {
+		Logger::error("Failed to map view of file: ", path);
+		close();
+		return false;
+	}
+
+	data = static_cast<uint8_t const*>(view);
+	size = static_cast<size_t>(file_size.QuadPart);
+#else
+	const int file_descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (file_descriptor == -1) {
+		Logger::error("Failed to open file for memory mapping: ", path);
+		return false;
+	}
+
+	struct stat file_stat;
+	if (fstat(file_descriptor, &file_stat) == -1) {
+		Logger::error("Failed to get size of file for memory mapping: ", path);
+		::close(file_descriptor);
+		return false;
+	}
+
+	if (file_stat.st_size == 0) {
+		::close(file_descriptor);
+		is_empty_file = true;
+		return true;
+	}
+
+	void* view = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	/* The mapping keeps its own reference to the file. */
+	::close(file_descriptor);
+	if (view == MAP_FAILED) {
+		Logger::error("Failed to memory map file: ", path);
+		return false;
+	}
+
+	data = static_cast<uint8_t const*>(view);
+	size = static_cast<size_t>(file_stat.st_size);
+#endif
+
+	return true;
+}
+
+void MemoryMappedFile::close() {
+#if defined(_WIN32)
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+	if (mapping_handle != nullptr) {
+		CloseHandle(mapping_handle);
+		mapping_handle = nullptr;
+	}
+	if (file_handle != INVALID_HANDLE_VALUE) {
+		CloseHandle(file_handle);
+		file_handle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (data != nullptr) {
+		munmap(const_cast<uint8_t*>(data), size);
+	}
+#endif
+
+	data = nullptr;
+	size = 0;
+	is_empty_file = false;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+namespace OpenVic {
+	namespace fs = std::filesystem;
+
+	/* Read-only view of a whole file mapped into memory, so its contents are read straight out of the OS page cache
+	 * without being copied into a buffer first. Pages are only loaded when first accessed. */
+	struct MemoryMappedFile {
+	private:
+		uint8_t const* data;
+		size_t size;
+		/* Empty files can't be mapped, so are tracked separately to still count as open. */
+		bool is_empty_file;
+
+#if defined(_WIN32)
+		void* file_handle;
+		void* mapping_handle;
+#endif
+
+	public:
+		MemoryMappedFile();
+		MemoryMappedFile(MemoryMappedFile const&) = delete;
+		MemoryMappedFile(MemoryMappedFile&& other);
+		MemoryMappedFile& operator=(MemoryMappedFile const&) = delete;
+		MemoryMappedFile& operator=(MemoryMappedFile&& other);
+		~MemoryMappedFile();
+
+		/* Closes any previously opened file first. Empty files can be opened, and have no data. */
+		bool open(fs::path const& path);
+		void close();
+
+		constexpr bool is_open() const {
+			return data != nullptr || is_empty_file;
+		}
+
+		constexpr std::span<const uint8_t> get_data() const {
+			return { data, size };
+		}
+
+		inline std::string_view get_string_view() const {
+			return { reinterpret_cast<char const*>(data), size };
+		}
+
+		constexpr size_t get_size() const {
+			return size;
+		}
+
+	private:
+		void _swap(MemoryMappedFile& other);
+	};
+}
@@ -0,0 +1,125 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+using namespace OpenVic;
+
+std::string_view Profiler::get_phase_name(phase_t phase) {
+	using enum phase_t;
+
+	switch (phase) {
+	case TICK:
+		return "tick";
+	case GAMESTATE_UPDATE:
+		return "gamestate_update";
+	case MAP_TICK:
+		return "map_tick";
+	case PROVINCE_UPDATE_POPS:
+		return "province_update_pops";
+	case STATE_UPDATE:
+		return "state_update";
+	case COUNTRY_UPDATE_PRODUCTION:
+		return "country_update_production";
+	case COUNTRY_UPDATE_BUDGET:
+		return "country_update_budget";
+	case COUNTRY_UPDATE_TECHNOLOGY:
+		return "country_update_technology";
+	case COUNTRY_UPDATE_POLITICS:
+		return "country_update_politics";
+	case COUNTRY_UPDATE_POPULATION:
+		return "country_update_population";
+	case COUNTRY_UPDATE_TRADE:
+		return "country_update_trade";
+	case COUNTRY_UPDATE_DIPLOMACY:
+		return "country_update_diplomacy";
+	case COUNTRY_UPDATE_MILITARY:
+		return "country_update_military";
+	case COUNTRY_UPDATE_RANKINGS:
+		return "country_update_rankings";
+	default:
+		return "unknown";
+	}
+}
+
+uint64_t Profiler::phase_stats_t::get_percentile_ns(double percentile) const {
+	const size_t count = std::min<uint64_t>(sample_count, HISTORY_SIZE);
+	if (count == 0) {
+		return 0;
+	}
+
+	std::vector<uint64_t> samples { history_ns.begin(), history_ns.begin() + count };
+	const size_t rank = std::min<size_t>(std::clamp(percentile, 0.0, 100.0) / 100.0 * count, count - 1);
+	std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+	return samples[rank];
+}
+
+Profiler::Profiler() : enabled { false } {
+	reset();
+}
+
+void Profiler::set_enabled(bool new_enabled) {
+	enabled = new_enabled;
+}
+
+void Profiler::reset() {
+	for (size_t index = 0; index < PHASE_COUNT; ++index) {
+		sample_time_ns[index].store(0, std::memory_order_relaxed);
+		sample_call_count[index].store(0, std::memory_order_relaxed);
+		phase_stats[index] = {};
+	}
+}
+
+void Profiler::end_sample() {
+	if (!enabled) {
+		return;
+	}
+
+	for (size_t index = 0; index < PHASE_COUNT; ++index) {
+		const uint64_t call_count = sample_call_count[index].exchange(0, std::memory_order_relaxed);
+		const uint64_t time_ns = sample_time_ns[index].exchange(0, std::memory_order_relaxed);
+
+		if (call_count > 0) {
+			phase_stats_t& stats = phase_stats[index];
+			stats.total_call_count += call_count;
+			stats.total_time_ns += time_ns;
+			stats.history_ns[stats.sample_count % HISTORY_SIZE] = time_ns;
+			stats.sample_count++;
+		}
+	}
+}
+
+Profiler::phase_stats_t const& Profiler::get_phase_stats(phase_t phase) const {
+	return phase_stats[static_cast<size_t>(phase)];
+}
+
+std::string Profiler::to_json() const {
+	static constexpr double NS_PER_US = 1000.0, NS_PER_MS = 1000000.0;
+
+	std::stringstream stream;
+	stream << "{\n\t\"enabled\": " << (enabled ? "true" : "false") << ",\n\t\"history_size\": " << HISTORY_SIZE
+		<< ",\n\t\"phases\": [";
+
+	for (size_t index = 0; index < PHASE_COUNT; ++index) {
+		phase_stats_t const& stats = phase_stats[index];
+		const size_t history_count = std::min<uint64_t>(stats.sample_count, HISTORY_SIZE);
+
+		uint64_t history_total_ns = 0, history_max_ns = 0;
+		for (size_t sample = 0; sample < history_count; ++sample) {
+			history_total_ns += stats.history_ns[sample];
+			history_max_ns = std::max(history_max_ns, stats.history_ns[sample]);
+		}
+
+		stream << (index > 0 ? "," : "") << "\n\t\t{ \"name\": \"" << get_phase_name(static_cast<phase_t>(index))
+			<< "\", \"calls\": " << stats.total_call_count << ", \"samples\": " << stats.sample_count
+			<< ", \"total_ms\": " << stats.total_time_ns / NS_PER_MS
+			<< ", \"mean_us\": " << (history_count > 0 ? history_total_ns / NS_PER_US / history_count : 0.0)
+			<< ", \"p50_us\": " << stats.get_percentile_ns(50.0) / NS_PER_US
+			<< ", \"p99_us\": " << stats.get_percentile_ns(99.0) / NS_PER_US
+			<< ", \"max_us\": " << history_max_ns / NS_PER_US << " }";
+	}
+
+	stream << "\n\t]\n}\n";
+	return stream.str();
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "openvic-simulation/utility/Getters.hpp"
+
+namespace OpenVic {
+	/* Records wall time and call counts for each phase of ticks and gamestate updates. Every call's time is added to its
+	 * phase's running total for the current sample (one tick or gamestate update), and finished samples are kept in a
+	 * fixed-size ring buffer per phase from which rolling percentiles are calculated. Phases which run on multiple threads
+	 * at once (e.g. province pop updates) record the sum of their calls' times across all threads.
+	 * While disabled, timing a phase costs a single branch and the clock is never read. */
+	struct Profiler {
+		enum struct phase_t : uint8_t {
+			TICK,
+			GAMESTATE_UPDATE,
+			MAP_TICK,
+			PROVINCE_UPDATE_POPS,
+			STATE_UPDATE,
+			COUNTRY_UPDATE_PRODUCTION,
+			COUNTRY_UPDATE_BUDGET,
+			COUNTRY_UPDATE_TECHNOLOGY,
+			COUNTRY_UPDATE_POLITICS,
+			COUNTRY_UPDATE_POPULATION,
+			COUNTRY_UPDATE_TRADE,
+			COUNTRY_UPDATE_DIPLOMACY,
+			COUNTRY_UPDATE_MILITARY,
+			COUNTRY_UPDATE_RANKINGS,
+			PHASE_COUNT
+		};
+
+		static constexpr size_t PHASE_COUNT = static_cast<size_t>(phase_t::PHASE_COUNT);
+		/* Number of most recent samples used for percentiles. */
+		static constexpr size_t HISTORY_SIZE = 256;
+
+		static std::string_view get_phase_name(phase_t phase);
+
+		struct phase_stats_t {
+			uint64_t total_call_count;
+			uint64_t total_time_ns;
+			/* Total number of samples in which the phase ran, including those no longer in the history. */
+			uint64_t sample_count;
+			std::array<uint64_t, HISTORY_SIZE> history_ns;
+
+			/* percentile is between 0 and 100, and is calculated from the samples still in the history. */
+			uint64_t get_percentile_ns(double percentile) const;
+		};
+
+		/* Times the rest of the enclosing scope as one call of the phase. */
+		struct ScopedTimer {
+			using clock_t = std::chrono::steady_clock;
+
+		private:
+			Profiler* profiler;
+			phase_t phase;
+			clock_t::time_point start;
+
+		public:
+			ScopedTimer(Profiler& new_profiler, phase_t new_phase)
+			  : profiler { new_profiler.is_enabled() ? &new_profiler : nullptr }, phase { new_phase } {
+				if (profiler != nullptr) {
+					start = clock_t::now();
+				}
+			}
+			ScopedTimer(ScopedTimer const&) = delete;
+			ScopedTimer& operator=(ScopedTimer const&) = delete;
+
+			~ScopedTimer() {
+				if (profiler != nullptr) {
+					profiler->record_call(
+						phase, std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - start).count()
+					);
+				}
+			}
+		};
+
+	private:
+		bool PROPERTY_CUSTOM_PREFIX(enabled, is);
+
+		/* Totals for the sample in progress. These are written concurrently by worker threads, so are atomic. */
+		std::array<std::atomic<uint64_t>, PHASE_COUNT> sample_time_ns;
+		std::array<std::atomic<uint64_t>, PHASE_COUNT> sample_call_count;
+
+		std::array<phase_stats_t, PHASE_COUNT> phase_stats;
+
+	public:
+		Profiler();
+		Profiler(Profiler const&) = delete;
+		Profiler& operator=(Profiler const&) = delete;
+
+		/* Must not be called while a tick or gamestate update is in progress. */
+		void set_enabled(bool new_enabled);
+		void reset();
+
+		inline void record_call(phase_t phase, uint64_t time_ns) {
+			const size_t index = static_cast<size_t>(phase);
+			sample_time_ns[index].fetch_add(time_ns, std::memory_order_relaxed);
+			sample_call_count[index].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		/* Moves the totals for every phase which ran since the last call into that phase's history. Called at the end of
+		 * every tick and gamestate update, once all worker threads have finished. */
+		void end_sample();
+
+		phase_stats_t const& get_phase_stats(phase_t phase) const;
+
+		/* An object with a "phases" array of each phase's name, call count, sample count, total time in milliseconds, and
+		 * mean, p50, p99 and maximum time per sample in microseconds, calculated from the history. */
+		std::string to_json() const;
+	};
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+
+#include "openvic-simulation/types/Date.hpp"
+#include "openvic-simulation/types/fixed_point/FixedPoint.hpp"
+
+namespace OpenVic {
+	/* Counter-based random numbers in the style of SplitMix64: the nth number drawn from a stream is a hash of the stream's
+	 * key plus n times the golden ratio, so drawing it doesn't depend on any state shared with other streams. Each key
+	 * combines the game's seed, a date, the kind of entity drawing numbers and a number identifying that entity which
+	 * doesn't change as others are added or removed (an index, or a pop's ID), so every entity can draw numbers
+	 * independently and in parallel while the results stay the same on every platform and for any number of threads.
+	 * Streams are cheap to create, so should be made where they're needed rather than stored. */
+	struct RandomStream {
+		/* Keeps streams for different kinds of entity with the same index apart. */
+		enum struct domain_t : uint8_t {
+			GLOBAL, PROVINCE, STATE, COUNTRY, POP, UNIT
+		};
+
+	private:
+		static constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15;
+
+		uint64_t key;
+		uint64_t counter;
+
+		/* SplitMix64's finaliser, mapping each input to a well distributed output. */
+		static constexpr uint64_t _mix(uint64_t value) {
+			value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+			value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+			return value ^ (value >> 31);
+		}
+
+	public:
+		constexpr RandomStream(uint64_t seed, Date date, domain_t domain, uint64_t entity_key)
+		  : key {
+				_mix(_mix(_mix(_mix(seed) + static_cast<uint64_t>((date - Date {}).to_int())) + static_cast<uint64_t>(domain))
+					+ entity_key)
+			}, counter { 0 } {}
+
+		constexpr uint64_t get_counter() const {
+			return counter;
+		}
+
+		constexpr uint64_t next_uint64() {
+			return _mix(key + ++counter * GOLDEN_GAMMA);
+		}
+
+		constexpr uint32_t next_uint32() {
+			return static_cast<uint32_t>(next_uint64() >> 32);
+		}
+
+		/* Returns a number from 0 to bound - 1 (or 0 if bound is 0), using Lemire's multiply and reject method: the high
+		 * half of a draw times bound is the result, and the few draws whose low half would make some results more likely
+		 * than others are redrawn, so every result is equally likely. */
+		constexpr uint32_t next_below(uint32_t bound) {
+			if (bound == 0) {
+				return 0;
+			}
+			uint64_t product = static_cast<uint64_t>(next_uint32()) * bound;
+			if (static_cast<uint32_t>(product) < bound) {
+				/* 2^32 mod bound, computed without leaving 32 bits. */
+				const uint32_t threshold = (UINT32_MAX - bound + 1) % bound;
+				while (static_cast<uint32_t>(product) < threshold) {
+					product = static_cast<uint64_t>(next_uint32()) * bound;
+				}
+			}
+			return static_cast<uint32_t>(product >> 32);
+		}
+
+		/* Returns a number from min to max, both inclusive, which must be in that order. The difference is taken in
+		 * unsigned arithmetic, so ranges wider than INT32_MAX, up to the whole of int32_t, don't overflow. */
+		constexpr int32_t next_in_range(int32_t min, int32_t max) {
+			const uint32_t span = static_cast<uint32_t>(max) - static_cast<uint32_t>(min);
+			const uint32_t offset = span == UINT32_MAX ? next_uint32() : next_below(span + 1);
+			return static_cast<int32_t>(static_cast<uint32_t>(min) + offset);
+		}
+
+		/* Returns a fixed point number at least 0 and less than 1. */
+		constexpr fixed_point_t next_fraction() {
+			return static_cast<int64_t>(next_uint64() >> (64 - fixed_point_t::PRECISION));
+		}
+	};
+}
@@ -0,0 +1,117 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+using namespace OpenVic;
+
+ThreadPool::ThreadPool(size_t new_thread_count)
+  : job_func { nullptr }, job_count { 0 }, job_chunk_count { 1 }, job_generation { 0 }, workers_remaining { 0 },
+	stopping { false } {
+	set_thread_count(new_thread_count);
+}
+
+ThreadPool::~ThreadPool() {
+	_stop_workers();
+}
+
+size_t ThreadPool::get_hardware_thread_count() {
+	return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+size_t ThreadPool::get_thread_count() const {
+	return workers.size() + 1;
+}
+
+void ThreadPool::set_thread_count(size_t new_thread_count) {
+	if (new_thread_count == 0) {
+		new_thread_count = get_hardware_thread_count();
+	}
+
+	if (new_thread_count != get_thread_count()) {
+		_stop_workers();
+		_start_workers(new_thread_count - 1);
+	}
+}
+
+void ThreadPool::_start_workers(size_t worker_count) {
+	stopping = false;
+	workers.reserve(worker_count);
+	for (size_t worker_index = 0; worker_index < worker_count; ++worker_index) {
+		/* Workers only pick up jobs started after they were created. */
+		workers.emplace_back(&ThreadPool::_worker_loop, this, worker_index, job_generation);
+	}
+}
+
+void ThreadPool::_stop_workers() {
+	{
+		const std::lock_guard<std::mutex> lock { mutex };
+		stopping = true;
+	}
+	work_condition.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+}
+
+void ThreadPool::_worker_loop(size_t worker_index, size_t last_generation) {
+	while (true) {
+		range_func_t const* func;
+
+		{
+			std::unique_lock<std::mutex> lock { mutex };
+			work_condition.wait(lock, [this, last_generation]() -> bool {
+				return stopping || job_generation != last_generation;
+			});
+
+			if (stopping) {
+				return;
+			}
+
+			last_generation = job_generation;
+			func = job_func;
+		}
+
+		/* Chunk 0 is always run by the calling thread. */
+		_run_chunk(*func, worker_index + 1);
+
+		{
+			const std::lock_guard<std::mutex> lock { mutex };
+			if (--workers_remaining == 0) {
+				done_condition.notify_one();
+			}
+		}
+	}
+}
+
+void ThreadPool::parallel_for(size_t count, range_func_t func) {
+	if (count == 0) {
+		return;
+	}
+
+	if (workers.empty() || count == 1) {
+		func(0, count);
+		return;
+	}
+
+	{
+		const std::lock_guard<std::mutex> lock { mutex };
+		job_func = &func;
+		job_count = count;
+		job_chunk_count = get_thread_count();
+		workers_remaining = workers.size();
+		job_generation++;
+	}
+	work_condition.notify_all();
+
+	_run_chunk(func, 0);
+
+	{
+		std::unique_lock<std::mutex> lock { mutex };
+		done_condition.wait(lock, [this]() -> bool {
+			return workers_remaining == 0;
+		});
+		job_func = nullptr;
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "openvic-simulation/types/FunctionRef.hpp"
+
+namespace OpenVic {
+	/* Fixed-size pool of worker threads for data-parallel loops over independent items. Index ranges are split into
+	 * contiguous chunks which are statically assigned to threads, so every index is processed exactly once and results
+	 * never depend on scheduling as long as the work done for each index only writes to that index's own data.
+	 * With a thread count of 1 everything runs serially on the calling thread and no worker threads are created. */
+	struct ThreadPool {
+		/* Called with a [begin, end) range of indices to process. */
+		using range_func_t = FunctionRef<void(size_t, size_t)>;
+
+	private:
+		std::vector<std::thread> workers;
+
+		std::mutex mutex;
+		std::condition_variable work_condition;
+		std::condition_variable done_condition;
+
+		/* Current job, only valid while a parallel_for call is in progress. */
+		range_func_t const* job_func;
+		size_t job_count;
+		size_t job_chunk_count;
+		size_t job_generation;
+		size_t workers_remaining;
+		bool stopping;
+
+		void _start_workers(size_t worker_count);
+		void _stop_workers();
+		void _worker_loop(size_t worker_index, size_t last_generation);
+
+		inline void _run_chunk(range_func_t const& func, size_t chunk_index) const {
+			const size_t begin = job_count * chunk_index / job_chunk_count;
+			const size_t end = job_count * (chunk_index + 1) / job_chunk_count;
+			if (begin < end) {
+				func(begin, end);
+			}
+		}
+
+	public:
+		/* A thread count of 0 is replaced with the number of hardware threads. */
+		ThreadPool(size_t new_thread_count = 1);
+		ThreadPool(ThreadPool const&) = delete;
+		ThreadPool(ThreadPool&&) = delete;
+		ThreadPool& operator=(ThreadPool const&) = delete;
+		ThreadPool& operator=(ThreadPool&&) = delete;
+		~ThreadPool();
+
+		static size_t get_hardware_thread_count();
+
+		/* Includes the calling thread. */
+		size_t get_thread_count() const;
+		void set_thread_count(size_t new_thread_count);
+
+		/* Calls func on contiguous sub-ranges covering [0, count), blocking until every sub-range has been processed.
+		 * Must not be called recursively from inside func. */
+		void parallel_for(size_t count, range_func_t func);
+
+		/* Calls func on every item, with the items split across threads as in parallel_for. */
+		template<typename T, typename Func>
+		void parallel_for_each(std::vector<T>& items, Func&& func) {
+			parallel_for(items.size(), [&items, &func](size_t begin, size_t end) -> void {
+				for (size_t index = begin; index < end; ++index) {
+					func(items[index]);
+				}
+			});
+		}
+	};
+}
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <climits>
 #include <functional>
+#include <iterator>
 #include <type_traits>
 
 #if defined(__GNUC__)
@@ -107,4 +109,39 @@ namespace OpenVic::utility {
 		}
 	};
 
+	/* Sorts [begin, end) using insertion sort, which takes linear time if the range is already almost sorted, e.g. a
+	 * ranking re-sorted after its scores have changed slightly. If the range turns out to be far from sorted, it falls
+	 * back to std::sort. Neither sort is stable, so results only match std::sort's if comp is a strict total order. */
+	template<std::random_access_iterator It, typename Compare>
+	constexpr void repair_sort(It begin, It end, Compare comp) {
+		/* Allows a few elements to move a long way, or many elements a short way, before giving up on insertion sort. */
+		constexpr size_t MAX_SHIFTS_PER_ELEMENT = 8;
+
+		if (end - begin < 2) {
+			return;
+		}
+
+		size_t shifts_remaining = MAX_SHIFTS_PER_ELEMENT * static_cast<size_t>(end - begin);
+
+		for (It it = begin + 1; it != end; ++it) {
+			if (!comp(*it, *(it - 1))) {
+				continue;
+			}
+
+			typename std::iterator_traits<It>::value_type value = std::move(*it);
+			It hole = it;
+			do {
+				*hole = std::move(*(hole - 1));
+				--hole;
+			} while (hole != begin && comp(value, *(hole - 1)));
+			*hole = std::move(value);
+
+			const size_t shifts = static_cast<size_t>(it - hole);
+			if (shifts > shifts_remaining) {
+				std::sort(begin, end, comp);
+				return;
+			}
+			shifts_remaining -= shifts;
+		}
+	}
 }